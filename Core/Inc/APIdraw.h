@@ -20,9 +20,9 @@
  *-------------------------------------------------------*/
 
 /**
- * @brief Teken een lijn van (x1,y1) naar (x2,y2) met opgegeven kleur en dikte.
+ * @brief Teken een lijn van (x1,y1) naar (x2,y2) met opgegeven kleur, dikte en uiteinden (kap).
  */
-ErrorList lijn(int x1, int y1, int x2, int y2, const char *kleur, int dikte);
+ErrorList lijn(int x1, int y1, int x2, int y2, const char *kleur, int dikte, int kap);
 
 /**
  * @brief Teken een rechthoek op scherm met opgegeven kleur en gevuld-optie.
@@ -35,9 +35,14 @@ ErrorList rechthoek(int x, int y, int w, int h, const char *kleur, int gevuld);
 ErrorList figuur(int x1, int y1, int x2, int y2, int x3, int y3, int x4, int y4, int x5, int y5, const char *kleur);
 
 /**
- * @brief Teken een cirkel met opgegeven straal en kleur.
+ * @brief Teken een veelhoek uit aantal punten (x, y om en om), als rand of gevuld.
  */
-ErrorList cirkel(int x0, int y0, int radius, const char* kleur);
+ErrorList veelhoek(const int *punten, int aantal, const char *kleur, int gevuld);
+
+/**
+ * @brief Teken een cirkel met opgegeven straal en kleur, als ring (dikte) of gevuld.
+ */
+ErrorList cirkel(int x0, int y0, int radius, const char* kleur, int gevuld, int dikte);
 
 /**
  * @brief Tekent een bitmap symbool, gecentreerd op (x, y).
@@ -55,4 +60,9 @@ ErrorList toren(int x, int y, int grootte, const char* kleur1, const char* kleur
 ErrorList tekst(int x, int y, const char *kleur_str, const char* tekst_str,
                 const char* fontnaam, int fontgrootte, const char* fontstijl);
 
+/**
+ * @brief Kopieer een rechthoek van het scherm naar (doel_x, doel_y), overlap mag.
+ */
+ErrorList kopieer(int x, int y, int w, int h, int doel_x, int doel_y);
+
 #endif /* APIDRAW_H */
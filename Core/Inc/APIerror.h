@@ -29,6 +29,12 @@ typedef enum
     FUNC_herhaal     = 9,
     FUNC_bitmap      = 10,
     FUNC_tekst       = 11,
+    FUNC_wachtframe  = 12,
+    FUNC_uitgesteld  = 13,
+    FUNC_modus       = 14,
+    FUNC_scroll      = 15,
+    FUNC_kopieer     = 16,
+    FUNC_veelhoek    = 17,
 } FunctionID;
 
 /**
@@ -55,6 +61,13 @@ typedef enum
     ERROR_tekst_buiten_scherm  = 16,
     ERROR_TEXT_EMPTY           = 17,
     ERROR_INVALID_STYL         = 18,
+    FRAMES_NOT_IN_RANGE        = 19,
+    ERROR_AAN_UIT              = 20,
+    ERROR_MODUS                = 21,
+    ERROR_SCROLL               = 22,
+    ERROR_KOPIEER              = 23,
+    ERROR_KAP                  = 24,
+    ERROR_PUNTEN               = 25,
 } ErrorCode;
 
 /**
@@ -107,6 +120,11 @@ ErrorCode check_color(int color);
  */
 ErrorCode check_lijn_op_scherm(int x1, int y1, int x2, int y2, int dikte);
 
+/**
+ * @brief Controleer de vorm van de lijnuiteinden (0 = vierkant, 1 = rond, 2 = plat)
+ */
+ErrorCode check_kap(int kap);
+
 /**
  * @brief Controleer breedte van rechthoek
  */
@@ -127,6 +145,11 @@ ErrorCode check_gevuld(int gevuld);
  */
 ErrorCode check_radius_op_scherm(int x, int y, int radius);
 
+/**
+ * @brief Controleer dikte van een cirkelring (1 t/m radius)
+ */
+ErrorCode check_cirkel_dikte(int radius, int dikte);
+
 /**
  * @brief Controleer bitmap nummer en positie
  */
@@ -147,6 +170,41 @@ ErrorCode check_toren_op_scherm(int x, int y, int grootte);
  */
 ErrorCode wacht_error(int ms_error);
 
+/**
+ * @brief Controleer aantal frames (1-600)
+ */
+ErrorCode wachtframe_error(int frames);
+
+/**
+ * @brief Controleer aan/uit-waarde (0 of 1)
+ */
+ErrorCode check_aan_uit(int aan);
+
+/**
+ * @brief Controleer of er een videomodus met deze breedte is
+ */
+ErrorCode check_modus(int breedte);
+
+/**
+ * @brief Controleer aantal regels om te scrollen (1 t/m hoogte-1, negatief = omlaag)
+ */
+ErrorCode check_scroll(int regels);
+
+/**
+ * @brief Controleer of rechthoeken gekopieerd kunnen worden in het tekendoel
+ */
+ErrorCode check_kopieer(void);
+
+/**
+ * @brief Controleer het aantal punten van een veelhoek (3 t/m RASTER_MAX_PUNTEN)
+ */
+ErrorCode check_aantal_punten(int aantal);
+
+/**
+ * @brief Controleer de vulling van een veelhoek (0 = rand, 1 = even-oneven, 2 = niet-nul)
+ */
+ErrorCode check_vulling(int vulling);
+
 /**
  * @brief Controleer herhaal aantal (1-20)
  */
@@ -35,6 +35,12 @@ typedef enum
     CMD_FIGUUR      = 9,  /**< Complex figuur tekenen */
     CMD_TOREN       = 10, /**< Torenopdracht */
     CMD_SETPIXEL    = 11, /**< Eén pixel zetten */
+    CMD_WACHTFRAME  = 12, /**< Wachten op een aantal frames */
+    CMD_UITGESTELD  = 13, /**< Uitgesteld tekenen aan/uit */
+    CMD_MODUS       = 14, /**< Videomodus kiezen */
+    CMD_SCROLL      = 15, /**< Beeld verticaal scrollen */
+    CMD_KOPIEER     = 16, /**< Rechthoek kopiëren */
+    CMD_VEELHOEK    = 17, /**< Veelhoek tekenen (variabel aantal punten) */
 } COMMANDO_TYPE;
 
 /**
@@ -64,6 +70,19 @@ typedef enum
 #define MAX_TEKST_HISTORY 4
 /** @} */
 
+/**
+ * @name DWT cyclusteller
+ * Registers van de Cortex-M4 Data Watchpoint and Trace unit, gebruikt voor
+ * het meten van het aantal CPU-cycli van teken- en driverroutines.
+ * @{
+ */
+#define DEMCR_REG       (*(volatile uint32_t *)0xE000EDFCUL) /**< Debug Exception and Monitor Control */
+#define DWT_CTRL_REG    (*(volatile uint32_t *)0xE0001000UL) /**< DWT Control */
+#define DWT_CYCCNT_REG  (*(volatile uint32_t *)0xE0001004UL) /**< DWT cyclusteller */
+#define DEMCR_TRCENA    (1UL << 24)                         /**< DWT/ITM inschakelen */
+#define DWT_CYCCNTENA   (1UL << 0)                          /**< Cyclusteller starten */
+/** @} */
+
 /**
  * @name Globale variabelen
  * @{
@@ -169,6 +188,45 @@ uint8_t kleur_omzetter(const char *input);
  */
 void SysTick_Init(void);
 
+/**
+ * @brief Start de DWT cyclusteller voor tijdmetingen.
+ */
+void DWT_Init(void);
+
+/**
+ * @brief Maakt alles wat sinds de vorige aanroep getekend is zichtbaar.
+ *
+ * In de 4bpp-modus (VGA_USE_4BPP) wordt er in een onzichtbare buffer
+ * getekend en wisselen de buffers bij de volgende vsync, zodat er
+ * nooit een half getekend beeld te zien is. In de 8-bit modus doet
+ * deze functie niets.
+ *
+ * @param wachten 1 = wachten tot de buffers gewisseld zijn,
+ *                0 = direct terug (de volgende tekenopdracht wacht)
+ */
+void toon_scherm(int wachten);
+
+/**
+ * @brief Geeft het aantal getoonde frames sinds de start.
+ *
+ * De teller loopt met 60 Hz op, aan het begin van elke verticale
+ * blanking.
+ *
+ * @return uint32_t Aantal frames
+ */
+uint32_t frameteller(void);
+
+/**
+ * @brief Wacht een aantal frames (60 Hz).
+ *
+ * Keert terug aan het begin van de verticale blanking van het laatste
+ * frame, zodat tekenwerk direct daarna buiten het zichtbare beeld valt.
+ *
+ * @param frames Aantal frames (1-600)
+ * @return ErrorList Foutcodestructuur
+ */
+ErrorList wachtframe(int frames);
+
 /**
  * @brief Blokkerende vertraging in milliseconden.
  *
@@ -177,6 +235,58 @@ void SysTick_Init(void);
  */
 ErrorList wacht(int ms);
 
+/**
+ * @brief Zet uitgesteld tekenen aan of uit.
+ *
+ * Als het aan staat, worden gevalideerde tekenopdrachten in een wachtrij
+ * gezet en alleen tijdens de verticale blanking getekend. Bij uitzetten
+ * wordt de wachtrij eerst afgewerkt.
+ *
+ * @param aan 1 = aan, 0 = uit
+ * @return ErrorList Foutcodestructuur
+ */
+ErrorList uitgesteld_tekenen(int aan);
+
+/**
+ * @brief Kiest de videomodus.
+ *
+ * De wachtrij van uitgesteld tekenen wordt eerst afgewerkt. Daarna wisselt
+ * de driver in de volgende verticale blanking van resolutie; het scherm is
+ * na het wisselen zwart. In de 160x120-modus wordt elke lijn vier keer
+ * getoond, vullen en wissen kost dan een kwart van de tijd.
+ *
+ * @param breedte Breedte van de modus in pixels (320 of 160)
+ * @return ErrorList Foutcodestructuur
+ */
+ErrorList scherm_modus(int breedte);
+
+/**
+ * @brief Scrollt het beeld een aantal regels omhoog (negatief = omlaag).
+ *
+ * Er worden geen pixels verplaatst: de driver toont het framebuffer als
+ * een ring van regels en verschuift alleen de startregel. Alleen de
+ * regels die binnenkomen worden zwart gemaakt. De wissel gebeurt in de
+ * verticale blanking.
+ *
+ * @param regels Aantal regels (1 t/m hoogte-1, of -1 t/m -(hoogte-1))
+ * @return ErrorList Foutcodestructuur
+ */
+ErrorList scherm_scroll(int regels);
+
+/**
+ * @brief Geeft de breedte van de actieve videomodus.
+ *
+ * @return int Breedte in pixels
+ */
+int scherm_breedte(void);
+
+/**
+ * @brief Geeft de hoogte van de actieve videomodus.
+ *
+ * @return int Hoogte in pixels
+ */
+int scherm_hoogte(void);
+
 /**
  * @brief Herhaalt eerder uitgevoerde commando’s.
  *
@@ -0,0 +1,371 @@
+/**
+ * @file APIraster.h
+ * @brief Header voor de rasterlaag
+ *
+ * De rasterlaag ligt tussen APIdraw.c en de VGA-driver. Functies in deze
+ * laag krijgen een al gevalideerde numerieke kleur (uint8_t) en coördinaten
+ * die al binnen het scherm liggen. Er wordt hier dus geen kleur-string
+ * omgezet, geen Error_handling() gedaan en niets opgenomen in de
+ * commando-historie.
+ *
+ * In de uitgestelde modus zetten de raster-functies hun opdracht in een
+ * wachtrij. raster_wachtrij_verwerk() tekent de wachtrij alleen tijdens de
+ * verticale blanking (lijnen na VGA_VSYNC_BILD_STOP tot VGA_VSYNC_BILD_START),
+ * met een maximum aantal cycli per blanking. Zo verandert het beeld nooit
+ * terwijl het getoond wordt en concurreert de CPU niet met de pixel-DMA.
+ *
+ * Het tekendoel is standaard het scherm. Met raster_zet_doel() tekenen
+ * dezelfde functies in een Surface in geheugen (sprite, cache, vooraf
+ * getekend onderdeel), dat daarna met raster_blit() gekopieerd wordt.
+ *
+ * De implementatie bevindt zich in APIraster.c.
+ *
+ * @author Thijs, Joost, Luc
+ * @version 1.0
+ * @date 2026-01-20
+ */
+
+#ifndef APIRASTER_H
+#define APIRASTER_H
+
+#include <stdint.h>
+#include "bitMap.h"
+
+/**
+ * @name Uitgestelde modus
+ * @{
+ */
+
+/** @brief Aantal opdrachten in de wachtrij */
+#define RASTER_WACHTRIJ_GROOTTE   64
+
+/**
+ * @brief CPU-cycli per verticale blanking.
+ *
+ * De blanking duurt 46 lijnen van ~4000 cycli (126 MHz); het budget laat
+ * ruimte voor de TIM2 interrupt en voor de opdracht die als laatste start.
+ */
+#define RASTER_VBLANK_BUDGET      150000u
+
+/** @brief Rijen per stap van een gevulde rechthoek in de wachtrij */
+#define RASTER_BAND_HOOGTE        16
+
+/** @} */
+
+/**
+ * @name Tekendoel
+ * @{
+ */
+
+/** @brief Formaat: het scherm, getekend via de VGA-driver */
+#define SURFACE_SCHERM   0
+
+/** @brief Formaat: één byte per pixel (R3G3B2) in geheugen */
+#define SURFACE_R3G3B2   1
+
+/**
+ * @brief Beschrijving van een tekendoel.
+ *
+ * Pixel (x, y) staat op buffer[y * pitch + x].
+ */
+typedef struct
+{
+    uint8_t *buffer;   /**< eerste pixel, NULL bij SURFACE_SCHERM */
+    int16_t breedte;   /**< breedte in pixels */
+    int16_t hoogte;    /**< hoogte in pixels */
+    int16_t pitch;     /**< bytes van een rij naar de volgende */
+    uint8_t formaat;   /**< SURFACE_SCHERM of SURFACE_R3G3B2 */
+} Surface;
+
+/** @} */
+
+/**
+ * @name Lijnuiteinden
+ * @{
+ */
+
+/** @brief Vierkant: de balk loopt dikte / 2 door voorbij elk eindpunt */
+#define RASTER_KAP_VIERKANT   0
+
+/** @brief Rond: een halve cirkel met diameter dikte om elk eindpunt */
+#define RASTER_KAP_ROND       1
+
+/** @brief Plat: de balk stopt haaks op de lijn in het eindpunt */
+#define RASTER_KAP_PLAT       2
+
+/** @} */
+
+/**
+ * @name Veelhoeken
+ * @{
+ */
+
+/** @brief Maximaal aantal hoekpunten van een veelhoek */
+#define RASTER_MAX_PUNTEN        16
+
+/** @brief Alleen de rand */
+#define RASTER_VUL_RAND          0
+
+/** @brief Gevuld waar een halve lijn naar rechts een oneven aantal randen kruist (even-odd) */
+#define RASTER_VUL_EVEN_ONEVEN   1
+
+/** @brief Gevuld waar de omloop om de pixel niet nul is (non-zero) */
+#define RASTER_VUL_NIET_NUL      2
+
+/** @} */
+
+/**
+ * @name Functieprototypes
+ * @{
+ */
+
+/**
+ * @brief Zet één pixel zonder controle.
+ *
+ * @param x X-coördinaat (moet binnen het scherm liggen)
+ * @param y Y-coördinaat (moet binnen het scherm liggen)
+ * @param color VGA-kleurcode
+ */
+void raster_pixel(int x, int y, uint8_t color);
+
+/**
+ * @brief Zet één pixel en slaat pixels buiten het scherm stil over.
+ *
+ * Voor routines waarvan de uitvoer niet vooraf volledig te begrenzen is,
+ * zoals cursieve of vette tekst aan de schermrand.
+ *
+ * @param x X-coördinaat
+ * @param y Y-coördinaat
+ * @param color VGA-kleurcode
+ */
+void raster_pixel_clip(int x, int y, uint8_t color);
+
+/**
+ * @brief Rastert een lijn.
+ *
+ * Een lijn van 1 pixel gaat met Bresenham. Een dikkere lijn is een balk
+ * van dikte pixels breed rond de middenlijn met uiteinden volgens kap; een
+ * pixel hoort erbij als zijn middelpunt in de balk valt. De balk wordt
+ * als één span per rij getekend en geclipt op het tekendoel (een vierkant
+ * uiteinde van een schuine lijn steekt iets verder uit dan dikte / 2).
+ * Horizontale en verticale lijnen met vierkante uiteinden zijn een
+ * rechthoek van 2 * (dikte / 2) + 1 pixels breed, zoals voorheen.
+ *
+ * Met een display-lijst tekent de driver de lijn en wordt kap genegeerd.
+ *
+ * @param x1 Begin x-coördinaat
+ * @param y1 Begin y-coördinaat
+ * @param x2 Eind x-coördinaat
+ * @param y2 Eind y-coördinaat
+ * @param color VGA-kleurcode
+ * @param dikte Dikte in pixels (>= 1)
+ * @param kap RASTER_KAP_VIERKANT, RASTER_KAP_ROND of RASTER_KAP_PLAT
+ */
+void raster_lijn(int x1, int y1, int x2, int y2, uint8_t color, int dikte, int kap);
+
+/**
+ * @brief Rastert een rechthoek, gevuld of alleen de rand.
+ *
+ * @param x X-coördinaat linker bovenhoek
+ * @param y Y-coördinaat linker bovenhoek
+ * @param w Breedte in pixels (>= 1)
+ * @param h Hoogte in pixels (>= 1)
+ * @param color VGA-kleurcode
+ * @param gevuld 1 = gevuld, 0 = alleen rand
+ */
+void raster_rechthoek(int x, int y, int w, int h, uint8_t color, int gevuld);
+
+/**
+ * @brief Rastert de omtrek van een cirkel met het Bresenham-algoritme.
+ *
+ * @param x0 X-coördinaat middelpunt
+ * @param y0 Y-coördinaat middelpunt
+ * @param radius Straal in pixels (>= 1)
+ * @param color VGA-kleurcode
+ */
+void raster_cirkel(int x0, int y0, int radius, uint8_t color);
+
+/**
+ * @brief Rastert een ring of een gevulde schijf, één span per rij.
+ *
+ * De ring loopt van de buitenrand (radius) dikte pixels naar binnen; met
+ * een dikte van radius of meer is er geen gat. Elke pixel wordt één keer
+ * geschreven. Met VGA_USE_DLIST wordt alleen de buitenrand getekend.
+ *
+ * @param x0 X-coördinaat middelpunt
+ * @param y0 Y-coördinaat middelpunt
+ * @param radius Buitenstraal in pixels (>= 1)
+ * @param dikte Dikte in pixels (>= 1), radius of meer = gevulde schijf
+ * @param color VGA-kleurcode
+ */
+void raster_ring(int x0, int y0, int radius, int dikte, uint8_t color);
+
+/**
+ * @brief Rastert een gesloten veelhoek, als rand of gevuld.
+ *
+ * De rand bestaat uit lijnen van 1 pixel tussen de opeenvolgende punten
+ * en van het laatste naar het eerste punt. Een gevulde veelhoek wordt
+ * met een tabel van actieve randen rij voor rij als spans gevuld en
+ * krijgt daarna dezelfde rand. Holle (concave) en zichzelf snijdende
+ * veelhoeken zijn toegestaan; vulling kiest de regel voor wat binnen is.
+ * Met VGA_USE_DLIST wordt op het scherm alleen de rand getekend.
+ *
+ * @param punten x- en y-coördinaten om en om: x1, y1, x2, y2, ...
+ *               (binnen het tekendoel)
+ * @param aantal Aantal punten (1 t/m RASTER_MAX_PUNTEN)
+ * @param color VGA-kleurcode
+ * @param vulling RASTER_VUL_RAND, RASTER_VUL_EVEN_ONEVEN of RASTER_VUL_NIET_NUL
+ */
+void raster_veelhoek(const int *punten, int aantal, uint8_t color, int vulling);
+
+/**
+ * @brief Rastert één karakter uit een 8x8 font.
+ *
+ * Pixels die buiten het scherm vallen worden overgeslagen.
+ *
+ * @param x X-coördinaat linker bovenhoek van het karakter
+ * @param y Y-coördinaat linker bovenhoek van het karakter
+ * @param karakter ASCII-code
+ * @param font Fontdata (8 bytes per karakter)
+ * @param schaal Schaalfactor (>= 1)
+ * @param is_vet 1 = vet
+ * @param is_cursief 1 = cursief
+ * @param color VGA-kleurcode
+ */
+void raster_karakter(int x, int y, unsigned char karakter, const unsigned char *font,
+                     int schaal, int is_vet, int is_cursief, uint8_t color);
+
+/**
+ * @brief Tekent een bitmap.
+ *
+ * @param x X-coördinaat linker bovenhoek
+ * @param y Y-coördinaat linker bovenhoek
+ * @param bmp Bitmap
+ * @param transparant 1 = kleur 0xFF niet tekenen
+ */
+void raster_bitmap(int x, int y, const Bitmap *bmp, int transparant);
+
+/**
+ * @brief Kopieert een rechthoek binnen het framebuffer (bron en doel mogen overlappen).
+ *
+ * Bron en doel moeten volledig binnen het scherm liggen. In de uitgestelde
+ * modus wordt de kopie in banden van RASTER_BAND_HOOGTE rijen uitgevoerd,
+ * in de volgorde die de overlap veilig houdt.
+ *
+ * @param x X-coördinaat linker bovenhoek van de bron
+ * @param y Y-coördinaat linker bovenhoek van de bron
+ * @param w Breedte in pixels (>= 1)
+ * @param h Hoogte in pixels (>= 1)
+ * @param doel_x X-coördinaat linker bovenhoek van het doel
+ * @param doel_y Y-coördinaat linker bovenhoek van het doel
+ */
+void raster_kopieer(int x, int y, int w, int h, int doel_x, int doel_y);
+
+/**
+ * @brief Kopieert een surface naar het tekendoel, geclipt aan de randen.
+ *
+ * Op het scherm gaat elke rij in één keer naar de driver (UB_VGA_PutRow);
+ * in de uitgestelde modus in banden van RASTER_BAND_HOOGTE rijen.
+ *
+ * @param bron Surface in geheugen (niet het tekendoel zelf)
+ * @param x X-coördinaat linker bovenhoek in het tekendoel
+ * @param y Y-coördinaat linker bovenhoek in het tekendoel
+ * @param transparant 1 = kleur 0xFF niet kopiëren
+ */
+void raster_blit(const Surface *bron, int x, int y, int transparant);
+
+/**
+ * @brief Beschrijft een blok geheugen als surface (SURFACE_R3G3B2).
+ *
+ * @param s Surface om in te vullen
+ * @param buffer Minstens pitch * hoogte bytes
+ * @param breedte Breedte in pixels
+ * @param hoogte Hoogte in pixels
+ * @param pitch Bytes per rij (kleiner dan breedte wordt breedte)
+ */
+void surface_init(Surface *s, uint8_t *buffer, int breedte, int hoogte, int pitch);
+
+/**
+ * @brief Kiest het tekendoel van alle raster-functies.
+ *
+ * Bij het verlaten van het scherm wordt eerst de wachtrij getekend.
+ * Opdrachten voor een surface worden altijd direct uitgevoerd.
+ *
+ * @param s Surface, of NULL voor het scherm
+ */
+void raster_zet_doel(const Surface *s);
+
+/**
+ * @brief Geeft het huidige tekendoel.
+ *
+ * @return Surface (het scherm met de maten van de videomodus)
+ */
+const Surface *raster_doel(void);
+
+/**
+ * @brief Geeft de breedte van het tekendoel.
+ *
+ * @return Breedte in pixels
+ */
+int raster_doel_breedte(void);
+
+/**
+ * @brief Geeft de hoogte van het tekendoel.
+ *
+ * @return Hoogte in pixels
+ */
+int raster_doel_hoogte(void);
+
+/**
+ * @brief Zet één pixel direct (nooit via de wachtrij) in het tekendoel.
+ *
+ * Pixels buiten het tekendoel worden overgeslagen.
+ *
+ * @param x X-coördinaat
+ * @param y Y-coördinaat
+ * @param color VGA-kleurcode
+ */
+void raster_doel_pixel(int x, int y, uint8_t color);
+
+/**
+ * @brief Zet de uitgestelde modus aan of uit.
+ *
+ * Bij uitzetten wordt eerst de hele wachtrij getekend.
+ *
+ * @param aan 1 = aan, 0 = uit
+ */
+void raster_uitgesteld(int aan);
+
+/**
+ * @brief Geeft terug of de uitgestelde modus aan staat.
+ *
+ * @return 1 = aan, 0 = uit
+ */
+int raster_is_uitgesteld(void);
+
+/**
+ * @brief Geeft het aantal opdrachten in de wachtrij.
+ *
+ * @return Aantal opdrachten
+ */
+int raster_wachtrij_aantal(void);
+
+/**
+ * @brief Tekent uit de wachtrij zolang de straal in de verticale blanking is.
+ *
+ * Mag vaak aangeroepen worden (hoofdlus, wachtlussen); buiten de blanking
+ * of met een lege wachtrij keert de functie direct terug. Wat niet binnen
+ * het budget past, blijft staan voor de volgende blanking.
+ *
+ * @param budget Maximaal aantal CPU-cycli (bijv. RASTER_VBLANK_BUDGET)
+ */
+void raster_wachtrij_verwerk(uint32_t budget);
+
+/**
+ * @brief Wacht tot de wachtrij volledig getekend is.
+ */
+void raster_wachtrij_leeg(void);
+
+/** @} */
+
+#endif /* APIRASTER_H */
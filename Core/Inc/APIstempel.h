@@ -0,0 +1,134 @@
+/**
+ * @file APIstempel.h
+ * @brief Header voor de stempelcache
+ *
+ * Een samengestelde vorm (zoals toren()) bestaat uit tientallen opdrachten
+ * die elk opnieuw gevalideerd en gerasterd worden. De stempelcache tekent
+ * zo'n vorm één keer in een Surface (zie APIraster.h) met een transparante
+ * achtergrond (0xFF) en kopieert die stempel daarna met raster_blit().
+ *
+ * De stempels staan achter elkaar in een vaste arena in de CCM RAM. Is de
+ * arena of de tabel vol, dan wordt de stempel die het langst niet gebruikt
+ * is verwijderd en schuiven de andere stempels aaneen (LRU).
+ *
+ * De implementatie bevindt zich in APIstempel.c.
+ *
+ * @author Thijs, Joost, Luc
+ * @version 1.0
+ * @date 2026-01-20
+ */
+
+#ifndef APISTEMPEL_H
+#define APISTEMPEL_H
+
+#include <stdint.h>
+
+/**
+ * @name Instellingen
+ * @{
+ */
+
+/** @brief 1 = stempelcache gebruiken, 0 = samengestelde vormen altijd direct tekenen */
+#ifndef STEMPEL_CACHE
+#define STEMPEL_CACHE            1
+#endif
+
+/** @brief Bytes in de arena (één byte per pixel) */
+#define STEMPEL_ARENA_GROOTTE    16384
+
+/** @brief Maximaal aantal stempels tegelijk */
+#define STEMPEL_AANTAL           8
+
+/** @} */
+
+/**
+ * @name Vormen
+ * @{
+ */
+
+#define STEMPEL_TOREN            1
+
+/** @} */
+
+/**
+ * @brief Sleutel en kader van één stempel.
+ *
+ * vorm, grootte, kleur1 en kleur2 vormen de sleutel. Het kader ligt vast
+ * bij de sleutel en geeft de stempel ten opzichte van het ankerpunt (x, y).
+ */
+typedef struct
+{
+    uint8_t vorm;      /**< STEMPEL_TOREN, ... */
+    uint8_t kleur1;    /**< VGA-kleurcode */
+    uint8_t kleur2;    /**< VGA-kleurcode */
+    int16_t grootte;   /**< maat van de vorm */
+    int16_t links;     /**< linkerkant van het kader t.o.v. x (<= 0) */
+    int16_t boven;     /**< bovenkant van het kader t.o.v. y (<= 0) */
+    int16_t breedte;   /**< breedte van het kader in pixels */
+    int16_t hoogte;    /**< hoogte van het kader in pixels */
+} StempelVorm;
+
+/**
+ * @brief Tekenfunctie van een vorm, met het ankerpunt op (x, y).
+ *
+ * Tekent via de gewone API in het huidige tekendoel.
+ */
+typedef void (*StempelTeken)(int x, int y, const void *arg);
+
+/**
+ * @brief Tellers van de stempelcache.
+ */
+typedef struct
+{
+    uint32_t treffers;    /**< getekend uit een bestaande stempel */
+    uint32_t missers;     /**< stempel nieuw getekend */
+    uint32_t verwijderd;  /**< stempels verwijderd om ruimte te maken */
+    uint16_t bytes;       /**< bytes van de arena in gebruik */
+    uint8_t aantal;       /**< stempels in de cache */
+} StempelStatistiek;
+
+/**
+ * @name Functieprototypes
+ * @{
+ */
+
+/**
+ * @brief Tekent een vorm via de stempelcache.
+ *
+ * Bij een misser wordt de vorm met teken() in een nieuwe stempel getekend.
+ * Geeft 0 terug als de cache niet gebruikt kan worden; de aanroeper tekent
+ * de vorm dan zelf. Dat gebeurt als de cache uit staat, met een
+ * display-lijst, als een kleur 0xFF (transparant) is, als het kader niet
+ * volledig in het tekendoel valt of als de stempel groter is dan de arena.
+ *
+ * @param vorm Sleutel en kader
+ * @param x X-coördinaat van het ankerpunt
+ * @param y Y-coördinaat van het ankerpunt
+ * @param teken Tekenfunctie van de vorm
+ * @param arg Argument voor teken()
+ * @return 1 = getekend, 0 = niet getekend
+ */
+int stempel_teken(const StempelVorm *vorm, int x, int y, StempelTeken teken, const void *arg);
+
+/**
+ * @brief Zet de stempelcache aan of uit.
+ *
+ * @param aan 1 = aan (standaard), 0 = uit
+ */
+void stempel_cache_aan(int aan);
+
+/**
+ * @brief Verwijdert alle stempels en zet de tellers op nul.
+ */
+void stempel_leeg(void);
+
+/**
+ * @brief Geeft de tellers van de stempelcache.
+ *
+ * @param st Struct om in te vullen
+ */
+void stempel_statistiek(StempelStatistiek *st);
+
+/** @} */
+
+#endif /* APISTEMPEL_H */
@@ -16,7 +16,7 @@
 
 #include <stdint.h>
 
-#define MAX_CMD_LENGTH 128  ///< Maximale lengte van een commando string
+#define MAX_CMD_LENGTH 256  ///< Maximale lengte van een commando string
 
 /**
  * @brief Structuur om volledige UART-input op te slaan
@@ -16,12 +16,13 @@
 
 #include "stm32f4xx.h"
 
-#define RX_BUFFER_SIZE 128  ///< Maximale grootte van de RX-buffer
+#define RX_BUFFER_SIZE 256  ///< Maximale grootte van de RX-buffer (veelhoek met 16 punten)
 
 // ================= EXTERNE VARIABELEN ==================
 extern volatile char uart_rx_buffer[RX_BUFFER_SIZE];  ///< Buffer voor ontvangen UART-characters
 extern volatile uint32_t uart_rx_index;               ///< Huidige index in RX-buffer
 extern volatile uint8_t uart_command_ready;           ///< Flag: 1 als een commando compleet ontvangen is
+extern volatile uint8_t uart_rx_te_lang;              ///< Flag: 1 als het commando niet in de RX-buffer paste
 
 // ================= UART API ==========================
 /**
@@ -9,9 +9,8 @@
 #define BITMAP_H_
 
 #include <stdint.h>
-
-#define VGA_DISPLAY_X   320
-#define VGA_DISPLAY_Y   240
+#include "stm32_ub_vga_ramfunc.h"
+#include "stm32_ub_vga_screen.h"   // VGA_DISPLAY_X / VGA_DISPLAY_Y
 
 #define grote_pijlen 16
 #define grote_smiley 32
@@ -54,6 +53,6 @@ extern const Bitmap KIP;
  * @param bmp Pointer naar de Bitmap struct
  * @param kleur Kleur om de "1" bits mee te tekenen (alleen gebruikt voor 1-bit bitmaps)
  */
-void drawBitmap(int x0, int y0, const Bitmap *bmp, uint8_t fg_vga_code);
+VGA_RAMFUNC void drawBitmap(int x0, int y0, const Bitmap *bmp, uint8_t fg_vga_code);
 
 #endif
@@ -10,9 +10,10 @@
 #ifndef LOGIC_LAYER_H
 #define LOGIC_LAYER_H
 
-#define MAX_INPUT 128
+#define MAX_INPUT 256
 #define MAX_ERROR_MESSAGE 128
 #define MAX_WOORD 32
+#define MAX_DELEN 40
 
 #include "APIerror.h"
 #include "APIdraw.h"
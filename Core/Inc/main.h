@@ -75,6 +75,11 @@
  */
 #include "APIio.h"
 
+/**
+ * @brief Rasterlaag en wachtrij voor uitgesteld tekenen.
+ */
+#include "APIraster.h"
+
 /**
  * @brief Test- en debugfunctionaliteit.
  */
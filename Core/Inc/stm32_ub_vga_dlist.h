@@ -0,0 +1,111 @@
+//--------------------------------------------------------------
+// File     : stm32_ub_vga_dlist.h
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+#ifndef __STM32F4_UB_VGA_DLIST_H
+#define __STM32F4_UB_VGA_DLIST_H
+
+
+//--------------------------------------------------------------
+// Includes
+// (no CMSIS/StdPeriph headers : this module is pure C and is
+//  also compiled on the PC for unit tests and benchmarks)
+//--------------------------------------------------------------
+#include <stdint.h>
+#include "stm32_ub_vga_ramfunc.h"
+
+
+
+//--------------------------------------------------------------
+// display list
+//
+// Instead of a frame buffer the screen is a list of primitives.
+// The renderer builds one scanline from the list, the pixels are
+// the same as the ones of the frame buffer rasterizers
+// (Bresenham line with square stamp, midpoint circle, 8x8 font).
+//
+// Every item has a handle (0..VGA_DLIST_MAX-1). Moving or
+// deleting an item only changes the item, nothing is redrawn.
+//
+// The renderer walks the items in the order of y_min and stops
+// at the first item below the scanline. It never reads item[] :
+// the list functions copy the used items sorted by y_min into
+// one of two tables while the renderer reads the other, and
+// UB_VGA_DListFrameStart() switches. So every change (add, move,
+// delete, clear) is shown from the next frame on, never halfway.
+//--------------------------------------------------------------
+#define VGA_DLIST_MAX         96    // items in one list
+#define VGA_DLIST_FONT_SIZE   8     // 8x8 fonts, 8 bytes per character
+
+
+//--------------------------------------------------------------
+// item types
+//--------------------------------------------------------------
+#define VGA_DL_FREE           0
+#define VGA_DL_RECT           1     // x0,y0 = top left, x1,y1 = w,h
+#define VGA_DL_LINE           2     // x0,y0 -> x1,y1, size = thickness
+#define VGA_DL_CIRCLE         3     // x0,y0 = center, x1 = radius
+#define VGA_DL_CHAR           4     // x0,y0 = top left, x1 = code, size = scale
+#define VGA_DL_BITMAP         5     // x0,y0 = top left, x1,y1 = w,h
+
+//--------------------------------------------------------------
+// item flags
+//--------------------------------------------------------------
+#define VGA_DL_FILLED         0x01  // RECT : filled
+#define VGA_DL_BOLD           0x02  // CHAR : bold
+#define VGA_DL_ITALIC         0x04  // CHAR : italic
+#define VGA_DL_TRANSPARENT    0x08  // BITMAP : color 0xFF is not drawn
+
+
+//--------------------------------------------------------------
+// one item (24 bytes)
+//--------------------------------------------------------------
+typedef struct {
+  uint8_t type;         // VGA_DL_xxx
+  uint8_t color;        // R3G3B2 (not used by BITMAP)
+  uint8_t flags;        // VGA_DL_FILLED ...
+  uint8_t size;         // LINE : thickness, CHAR : scale
+  int16_t x0,y0;
+  int16_t x1,y1;
+  int16_t y_min,y_max;  // first and last line with pixels
+  uint16_t z;           // depth, higher = added later = on top
+  const uint8_t *data;  // CHAR : font, BITMAP : pixels (w*h, R3G3B2)
+}VGA_DListItem_t;
+
+
+//--------------------------------------------------------------
+// display list
+//--------------------------------------------------------------
+typedef struct {
+  VGA_DListItem_t item[VGA_DLIST_MAX];      // items of the list functions
+  VGA_DListItem_t order[2][VGA_DLIST_MAX];  // copies of the used items sorted by y_min
+  uint8_t order_cnt[2];
+  volatile uint8_t order_rd;        // table of the renderer
+  volatile uint8_t order_new;       // 1 = the other table is newer
+  uint8_t back_color;               // color of all pixels without item
+  uint8_t used;                     // used items
+  uint16_t z_next;                  // depth of the next item
+}VGA_DList_t;
+
+
+
+//--------------------------------------------------------------
+// Global Function call
+//--------------------------------------------------------------
+void UB_VGA_DListInit(VGA_DList_t *dl, uint8_t back_color);
+int16_t UB_VGA_DListRect(VGA_DList_t *dl, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color, uint8_t filled);
+int16_t UB_VGA_DListLine(VGA_DList_t *dl, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color, uint8_t thickness);
+int16_t UB_VGA_DListCircle(VGA_DList_t *dl, int16_t x0, int16_t y0, int16_t radius, uint8_t color);
+int16_t UB_VGA_DListChar(VGA_DList_t *dl, int16_t x, int16_t y, uint8_t code, const uint8_t *font,
+                         uint8_t scale, uint8_t flags, uint8_t color);
+int16_t UB_VGA_DListBitmap(VGA_DList_t *dl, int16_t x, int16_t y, int16_t w, int16_t h,
+                           const uint8_t *data, uint8_t flags);
+uint8_t UB_VGA_DListMove(VGA_DList_t *dl, int16_t handle, int16_t dx, int16_t dy);
+uint8_t UB_VGA_DListDelete(VGA_DList_t *dl, int16_t handle);
+VGA_RAMFUNC void UB_VGA_DListFrameStart(VGA_DList_t *dl);
+VGA_RAMFUNC void UB_VGA_DListRenderLine(const VGA_DList_t *dl, uint8_t *dst, int16_t y,
+                                        int16_t x_start, int16_t x_end);
+
+//--------------------------------------------------------------
+#endif // __STM32F4_UB_VGA_DLIST_H
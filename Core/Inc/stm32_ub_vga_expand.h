@@ -0,0 +1,68 @@
+//--------------------------------------------------------------
+// File     : stm32_ub_vga_expand.h
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+#ifndef __STM32F4_UB_VGA_EXPAND_H
+#define __STM32F4_UB_VGA_EXPAND_H
+
+
+//--------------------------------------------------------------
+// Includes
+// (no CMSIS/StdPeriph headers : this module is pure C and is
+//  also compiled on the PC for unit tests and benchmarks)
+//--------------------------------------------------------------
+#include <stdint.h>
+#include "stm32_ub_vga_ramfunc.h"
+
+
+
+//--------------------------------------------------------------
+// 4bpp pixel format
+// 2 pixels per byte, the left pixel (even x) in the high nibble
+// every nibble is an index into a palette of 16 R3G3B2 colors
+//--------------------------------------------------------------
+#define VGA_EXPAND_PAL_SIZE    16
+#define VGA_EXPAND_PAIR_SIZE   256
+
+
+//--------------------------------------------------------------
+// 1bpp / 2bpp pixel format (high resolution mode)
+// 8 or 4 pixels per byte, the left pixel in the highest bits
+// 1bpp : one table entry per nibble (4 pixels)
+// 2bpp : one table entry per byte (4 pixels)
+//--------------------------------------------------------------
+#define VGA_EXPAND_LUT1_SIZE   16
+#define VGA_EXPAND_LUT2_SIZE   256
+
+
+//--------------------------------------------------------------
+// text cell format
+// 2 bytes per cell : character code, attribute
+// attribute : foreground index in the low nibble,
+//             background index in the high nibble
+// the font has 8 bytes per character (one per pixel row),
+// bit 7 is the left pixel
+//--------------------------------------------------------------
+#define VGA_EXPAND_FONT_H      8
+#define VGA_EXPAND_MASK_SIZE   16
+#define VGA_TEXT_ATTR(fg,bg)   ((uint8_t)((((bg) & 0x0F)<<4) | ((fg) & 0x0F)))
+
+
+
+//--------------------------------------------------------------
+// Global Function call
+//--------------------------------------------------------------
+void UB_VGA_BuildPairLut(uint16_t *pair_lut, const uint8_t *palette);
+VGA_RAMFUNC void UB_VGA_ExpandLine4bpp(uint8_t *dst, const uint8_t *src, const uint16_t *pair_lut, uint16_t width);
+uint8_t UB_VGA_NearestIndex(const uint8_t *palette, uint8_t color);
+uint8_t UB_VGA_NearestIndexN(const uint8_t *palette, uint8_t count, uint8_t color);
+void UB_VGA_BuildPackedLut(uint32_t *lut, const uint8_t *palette, uint8_t bpp);
+VGA_RAMFUNC void UB_VGA_ExpandLine1bpp(uint8_t *dst, const uint8_t *src, const uint32_t *lut, uint16_t width);
+VGA_RAMFUNC void UB_VGA_ExpandLine2bpp(uint8_t *dst, const uint8_t *src, const uint32_t *lut, uint16_t width);
+void UB_VGA_BuildTextLuts(uint32_t *nib_mask, uint32_t *color32, const uint8_t *palette);
+VGA_RAMFUNC void UB_VGA_ExpandTextLine(uint8_t *dst, const uint8_t *cells, const uint8_t *font_row,
+                                       const uint32_t *nib_mask, const uint32_t *color32, uint16_t cols);
+
+//--------------------------------------------------------------
+#endif // __STM32F4_UB_VGA_EXPAND_H
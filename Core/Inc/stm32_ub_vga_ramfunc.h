@@ -0,0 +1,70 @@
+//--------------------------------------------------------------
+// File     : stm32_ub_vga_ramfunc.h
+//--------------------------------------------------------------
+
+//--------------------------------------------------------------
+#ifndef __STM32F4_UB_VGA_RAMFUNC_H
+#define __STM32F4_UB_VGA_RAMFUNC_H
+
+
+//--------------------------------------------------------------
+// Functions in RAM
+//
+// VGA_RAMFUNC puts a function in the section ".ramfunc".
+// The linker script places it in RAM with its load address in
+// flash, the startup code copies it before SystemInit().
+// From RAM there are no flash wait states and no ART misses,
+// so the line interrupt always starts after the same time.
+//
+// long_call : flash and RAM are too far apart for a BL,
+// the call goes through a register (no linker veneer)
+//
+// VGA_USE_RAMFUNC = 0 : all functions stay in flash
+// (for comparing with benchmark_VGA_isr / benchmark_APIdraw)
+//
+// on the PC (unit tests) the macro is empty
+//--------------------------------------------------------------
+#ifndef VGA_USE_RAMFUNC
+#define VGA_USE_RAMFUNC   1
+#endif
+
+#if VGA_USE_RAMFUNC && defined(__arm__)
+#define VGA_RAMFUNC   __attribute__((section(".ramfunc"), long_call))
+#else
+#define VGA_RAMFUNC
+#endif
+
+
+
+//--------------------------------------------------------------
+// Data in CCM RAM (64 KB at 0x10000000)
+//
+// Only the CPU can reach the CCM RAM, the DMA cannot. All
+// buffers the DMA never reads (command history, parser, queues,
+// tables, caches) go there, the stack too (see _estack in the
+// linker script). The main SRAM stays free for frame and line
+// buffers and the CPU no longer competes with the pixel DMA.
+//
+// VGA_CCMRAM  : zero initialized (section ".ccmbss")
+// VGA_CCMDATA : with initial value (section ".ccmram",
+//               copied from flash by the startup code)
+//
+// never use them for buffers of a DMA (VGA_RAM1, line buffers)
+//
+// VGA_USE_CCMRAM = 0 : the buffers stay in the main SRAM
+// (the stack is always in the CCM RAM)
+//--------------------------------------------------------------
+#ifndef VGA_USE_CCMRAM
+#define VGA_USE_CCMRAM   1
+#endif
+
+#if VGA_USE_CCMRAM && defined(__arm__)
+#define VGA_CCMRAM    __attribute__((section(".ccmbss")))
+#define VGA_CCMDATA   __attribute__((section(".ccmram")))
+#else
+#define VGA_CCMRAM
+#define VGA_CCMDATA
+#endif
+
+//--------------------------------------------------------------
+#endif // __STM32F4_UB_VGA_RAMFUNC_H
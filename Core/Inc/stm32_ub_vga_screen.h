@@ -16,6 +16,9 @@
 #include "stm32f4xx_tim.h"
 #include "misc.h"
 #include "stm32f4xx_dma.h"
+#include "stm32_ub_vga_expand.h"
+#include "stm32_ub_vga_ramfunc.h"
+#include "stm32_ub_vga_dlist.h"
 
 
 
@@ -38,11 +41,314 @@
 
 
 
+//--------------------------------------------------------------
+// High resolution mode (640x480)
+//
+// VGA_USE_HIRES = 1 : 640x480 pixels, every line is its own source
+//                     line (no line doubling) and Timer1 runs twice
+//                     as fast (VGA_TIM1_PERIODE). The frame buffer
+//                     (VGA_FBHi) is packed with VGA_HIRES_BPP bits
+//                     per pixel, the left pixel in the highest bits:
+//                     1bpp = 2 colors, 38400 Bytes
+//                     2bpp = 4 colors, 76800 Bytes
+//                     Every write goes to the packed buffer (spans
+//                     with bit masks at both ends). The TIM2-
+//                     Interrupt expands the next line with a small
+//                     palette table into one of two 8bit line
+//                     buffers while the DMA sends the other one.
+//                     Colors without a palette entry are drawn
+//                     with the nearest palette color.
+//--------------------------------------------------------------
+#ifndef VGA_USE_HIRES
+#define VGA_USE_HIRES   0
+#endif
+
+#ifndef VGA_HIRES_BPP
+#define VGA_HIRES_BPP   1
+#endif
+
+#if (VGA_HIRES_BPP!=1) && (VGA_HIRES_BPP!=2)
+#error "VGA_HIRES_BPP must be 1 or 2"
+#endif
+
+
+
 //--------------------------------------------------------------
 // define the VGA_display
 //--------------------------------------------------------------
+#if VGA_USE_HIRES
+#define VGA_DISPLAY_X   640
+#define VGA_DISPLAY_Y   480
+#else
 #define VGA_DISPLAY_X   320
 #define VGA_DISPLAY_Y   240
+#endif
+
+#define VGA_HIRES_PPB    (8/VGA_HIRES_BPP)                 // pixels per byte
+#define VGA_HIRES_PITCH  (VGA_DISPLAY_X/VGA_HIRES_PPB)     // 80 or 160
+#define VGA_HIRES_COLORS (1<<VGA_HIRES_BPP)                // palette entries
+
+
+//--------------------------------------------------------------
+// Line pitch of VGA_RAM1 (bytes from one line to the next)
+//
+// Each line is padded to a multiple of 4 bytes, so every line
+// starts word aligned and can be filled/copied with 32bit access.
+// The padding bytes behind the visible pixels are owned by the
+// driver and stay black. The DMA sends the padding bytes after
+// the last visible pixel, so PE8-PE15 are already black when the
+// front porch starts (the TC-Interrupt is too late for that, it
+// would stretch the last pixel into the blanking).
+//--------------------------------------------------------------
+#define VGA_PITCH       ((VGA_DISPLAY_X+4) & ~0x03)  // 324 (hires : 644)
+
+
+
+//--------------------------------------------------------------
+// Pixel DMA memory access
+//
+// VGA_DMA_FIFO = 1 : the DMA reads 32bit words from RAM into its
+//                    FIFO and writes single bytes to GPIOE->ODR.
+//                    1 AHB read per 4 pixels instead of 1 per
+//                    pixel, so the CPU gets the bus matrix/SRAM
+//                    more often during active video. The length
+//                    must be a multiple of 4 (word/byte ratio),
+//                    the whole pitch is sent (320 + 4 black).
+//                    No memory bursts : a 4-beat burst from a
+//                    line start (324*y) can cross a 1KB border.
+// VGA_DMA_FIFO = 0 : direct mode, one byte read per pixel
+//                    (old behaviour, for comparing benchmarks)
+//--------------------------------------------------------------
+#ifndef VGA_DMA_FIFO
+#define VGA_DMA_FIFO    1
+#endif
+
+
+
+//--------------------------------------------------------------
+// Scanout engine
+//
+// VGA_SCANOUT_DBM = 0 : per visible line the TIM2-Interrupt sets
+//                       up the DMA and starts Timer1, the DMA
+//                       TC-Interrupt stops both again
+// VGA_SCANOUT_DBM = 1 : Timer1 runs all the time but is gated by
+//                       Timer4, which opens a window of exactly
+//                       VGA_PITCH pixel clocks per line (one pulse,
+//                       started by the TIM2 update). The DMA runs
+//                       in circular double buffer mode (M0AR/M1AR,
+//                       VGA_PITCH bytes each) and switches the
+//                       buffer by itself at the end of every line.
+//                       The TIM2-Interrupt comes after the pixel
+//                       window and only writes the address of the
+//                       line after the next one to the inactive
+//                       register, there is no TC-Interrupt. The
+//                       line start is made by hardware, so it has
+//                       no interrupt jitter.
+//--------------------------------------------------------------
+#ifndef VGA_SCANOUT_DBM
+#define VGA_SCANOUT_DBM   0
+#endif
+
+#if VGA_DMA_FIFO || VGA_SCANOUT_DBM
+#define VGA_DMA_LEN     VGA_PITCH                    // visible pixels + 4 black
+#else
+#define VGA_DMA_LEN     (VGA_DISPLAY_X+1)            // visible pixels + 1 black
+#endif
+
+
+
+//--------------------------------------------------------------
+// Scanout mode
+//
+// VGA_USE_4BPP = 0 : one 8bit framebuffer (VGA_RAM1), every
+//                    write is visible at once
+// VGA_USE_4BPP = 1 : two 4bpp palettized framebuffers (front
+//                    and back, 2 x 38400 Bytes). All drawing
+//                    goes to the back buffer, UB_VGA_Present()
+//                    swaps them at the next vertical blanking.
+//                    The TIM2-Interrupt expands the next source
+//                    line with the palette into one of two 8bit
+//                    line buffers while the DMA sends the other.
+//                    Colors without a palette entry are drawn
+//                    with the nearest palette color.
+//--------------------------------------------------------------
+#ifndef VGA_USE_4BPP
+#define VGA_USE_4BPP    0
+#endif
+
+#define VGA_4BPP_PITCH  (VGA_DISPLAY_X/2)            // 160
+
+
+//--------------------------------------------------------------
+// Display list mode (no frame buffer)
+//
+// VGA_USE_DLIST = 1 : the screen is a display list (VGA_DList,
+//                     see stm32_ub_vga_dlist.h) in the CCM RAM.
+//                     All write functions of this driver add a
+//                     rectangle item, FillScreen clears the list.
+//                     The TIM2-Interrupt renders the next source
+//                     line into one of two 8bit line buffers while
+//                     the DMA sends the other one, half a line per
+//                     scan (every source line is sent twice), so
+//                     one interrupt never renders more than 160
+//                     pixels. VGA_RAM1 (77 KB) is not needed.
+//                     Too many items on one line make the render
+//                     slower than half a line, the picture then
+//                     shows the old content of the line buffer.
+//--------------------------------------------------------------
+#ifndef VGA_USE_DLIST
+#define VGA_USE_DLIST   0
+#endif
+
+#if VGA_USE_DLIST && (VGA_USE_4BPP || VGA_SCANOUT_DBM)
+#error "VGA_USE_DLIST can not be combined with VGA_USE_4BPP or VGA_SCANOUT_DBM"
+#endif
+
+
+//--------------------------------------------------------------
+// Text mode (40x30 character cells)
+//
+// VGA_USE_TEXT = 1 : the screen is VGA_TEXT_COLS x VGA_TEXT_ROWS
+//                    cells of 8x8 pixels, 2 bytes per cell
+//                    (code + attribute, see VGA_TEXT_ATTR) =
+//                    2400 Bytes in the CCM RAM. A character is
+//                    changed with one 2 byte write. Like in the
+//                    4bpp mode the TIM2-Interrupt expands the
+//                    next pixel row of the cells with the font
+//                    (UB_VGA_TextSetFont) and the 16 color
+//                    palette into one of two 8bit line buffers.
+//                    There are no single pixels : SetPixel,
+//                    HLine and VLine do nothing, FillRect clears
+//                    all cells it touches to the background color.
+//--------------------------------------------------------------
+#ifndef VGA_USE_TEXT
+#define VGA_USE_TEXT    0
+#endif
+
+#if VGA_USE_TEXT && (VGA_USE_4BPP || VGA_USE_DLIST || VGA_SCANOUT_DBM)
+#error "VGA_USE_TEXT can not be combined with VGA_USE_4BPP, VGA_USE_DLIST or VGA_SCANOUT_DBM"
+#endif
+
+#define VGA_TEXT_CELL   8                            // pixels per cell (x and y)
+#define VGA_TEXT_COLS   (VGA_DISPLAY_X/VGA_TEXT_CELL) // 40
+#define VGA_TEXT_ROWS   (VGA_DISPLAY_Y/VGA_TEXT_CELL) // 30
+#define VGA_TEXT_ATTR_DEFAULT  VGA_TEXT_ATTR(13,0)   // white on black
+
+#if VGA_USE_HIRES && (VGA_USE_4BPP || VGA_USE_DLIST || VGA_USE_TEXT || VGA_SCANOUT_DBM)
+#error "VGA_USE_HIRES can not be combined with VGA_USE_4BPP, VGA_USE_DLIST, VGA_USE_TEXT or VGA_SCANOUT_DBM"
+#endif
+
+
+
+//--------------------------------------------------------------
+// Video modes (runtime)
+//
+// The geometry of the picture is a descriptor (VGA_Mode_t), not
+// a set of fixed defines. UB_VGA_SetMode() switches between the
+// modes of the table at the next vertical blanking, the draw
+// functions clip at the size of the active mode.
+//
+// VGA_MODE_DEFAULT : the mode of the build (320x240, 4bpp, dlist,
+//                    text or 640x480)
+// VGA_MODE_160X120 : 8bit frame buffer only (without VGA_SCANOUT_DBM)
+//                    160x120 pixels, every source line is sent
+//                    VGA_LO_LINE_REPEAT times and Timer1 runs half
+//                    as fast. A quarter of the pixels : fills and
+//                    clears are four times faster. Uses the first
+//                    VGA_LO_PITCH*VGA_LO_DISPLAY_Y bytes of VGA_RAM1.
+//
+// VGA_DISPLAY_X/VGA_DISPLAY_Y stay the size of the buffers
+// (the largest mode).
+//--------------------------------------------------------------
+#define VGA_VISIBLE_LINES   480                         // scans per frame
+#define VGA_LINE_REPEAT     (VGA_VISIBLE_LINES/VGA_DISPLAY_Y) // 2 (hires : 1)
+
+#define VGA_LO_DISPLAY_X    160
+#define VGA_LO_DISPLAY_Y    120
+#define VGA_LO_LINE_REPEAT  (VGA_VISIBLE_LINES/VGA_LO_DISPLAY_Y) // 4
+#define VGA_LO_PITCH        ((VGA_LO_DISPLAY_X+4) & ~0x03)      // 164
+#define VGA_LO_TIM1_PERIODE 20-1                        // 160 pixels per line
+#if VGA_DMA_FIFO
+#define VGA_LO_DMA_LEN      VGA_LO_PITCH
+#else
+#define VGA_LO_DMA_LEN      (VGA_LO_DISPLAY_X+1)
+#endif
+
+#define VGA_MODE_DEFAULT    0
+#define VGA_MODE_160X120    1
+#if VGA_USE_4BPP || VGA_USE_DLIST || VGA_USE_TEXT || VGA_USE_HIRES || VGA_SCANOUT_DBM
+#define VGA_MODE_CNT        1
+#else
+#define VGA_MODE_CNT        2
+#endif
+
+//--------------------------------------------------------------
+// Vertical scroll (8bit frame buffer and hires)
+//
+// The frame buffer is a ring of lines : the scanout starts at
+// line VGA.scroll and wraps at the last line of the mode (8bit :
+// through the line table, see VGA_HAS_LINETAB). All
+// write functions add the same offset, so x,y stay screen
+// coordinates. UB_VGA_Scroll() only changes the offset and fills
+// the lines that come in, no pixel is moved.
+// 4bpp, dlist and text : no scroll (UB_VGA_Scroll returns 1)
+//--------------------------------------------------------------
+#if VGA_USE_4BPP || VGA_USE_DLIST || VGA_USE_TEXT
+#define VGA_HAS_SCROLL      0
+#else
+#define VGA_HAS_SCROLL      1
+#endif
+
+
+//--------------------------------------------------------------
+// Line table (8bit frame buffer only)
+//
+// The scanout does not count through VGA_RAM1, it takes the
+// buffer line of every source line from a table (one entry per
+// screen line, VGA_DISPLAY_Y entries, in the CCM RAM). Two
+// screen lines can show the same buffer line, or lines of
+// another part of the buffer : split screens (a fixed status
+// bar above a scrolling part), moving rows without copying,
+// line doubling.
+//
+// UB_VGA_LineTabSet() changes a second table, UB_VGA_LineTabApply()
+// swaps both at the next vertical blanking (like UB_VGA_Present).
+// By default line y shows buffer line y (+ VGA.scroll), the draw
+// functions always write to that default place.
+// UB_VGA_Scroll() and UB_VGA_SetMode() set the default table.
+//--------------------------------------------------------------
+#if VGA_USE_4BPP || VGA_USE_DLIST || VGA_USE_TEXT || VGA_USE_HIRES
+#define VGA_HAS_LINETAB     0
+#else
+#define VGA_HAS_LINETAB     1
+#endif
+
+
+//--------------------------------------------------------------
+// Rectangle copy (8bit frame buffer only)
+//
+// UB_VGA_CopyRect() copies w*h pixels inside VGA_RAM1, source and
+// destination may overlap (the lines are copied bottom up when
+// the destination is lower, a line right to left when it is more
+// right, like memmove). Every line is copied with 32bit stores,
+// the source is read with 32bit loads too (unaligned LDR).
+// 4bpp, dlist, text and hires : no copy (UB_VGA_CopyRect returns 1)
+//--------------------------------------------------------------
+#if VGA_USE_4BPP || VGA_USE_DLIST || VGA_USE_TEXT || VGA_USE_HIRES
+#define VGA_HAS_COPY        0
+#else
+#define VGA_HAS_COPY        1
+#endif
+
+typedef struct {
+  uint16_t width;        // visible pixels per line
+  uint16_t height;       // source lines
+  uint8_t  line_repeat;  // scans per source line
+  uint16_t pitch;        // bytes from one source line to the next
+  uint16_t tim1_periode; // Timer1 period (pixel clock)
+  uint16_t dma_len;      // bytes per scan (NDTR)
+  uint16_t bild_start;   // first visible line (VSync counter)
+}VGA_Mode_t;
 
 
 
@@ -53,15 +359,147 @@ typedef struct {
   uint16_t hsync_cnt;   // counter
   uint32_t start_adr;   // start_adres
   uint32_t dma2_cr_reg; // Register constant CR-Register
+  volatile uint32_t frame_cnt; // +1 at the start of every vertical blanking
+  uint16_t src_row;     // source line on the screen
+  uint8_t front;        // 4bpp : index of the visible buffer
+  volatile uint8_t flip;// 4bpp : 1 = swap buffers at next frame
+  VGA_Mode_t mode;      // active video mode
+  uint8_t mode_id;      // VGA_MODE_xxx of the active mode
+  uint8_t line_cnt;     // 8bit : scans of the current source line
+  volatile uint16_t scroll; // buffer line shown at the top (ring offset)
+  uint8_t tab_front;    // 8bit : index of the line table of the scanout
+  volatile uint8_t tab_flip; // 8bit : 1 = swap line tables at next frame
+  volatile uint8_t blit_busy; // 1 = the DMA blitter is still running
 }VGA_t;
 extern VGA_t VGA;
 
 
 
+//--------------------------------------------------------------
+// Cycle profile of the line interrupt (TIM2_IRQHandler)
+// only filled with VGA_ISR_PROFILE = 1 (DWT counter must run)
+// measured from the first to the last instruction of the ISR,
+// the exception entry/exit (~24 cycles) is not included
+// lat_min/lat_max : TIM2 ticks (2 CPU cycles) from the CC3 event
+// to the first instruction, lat_max-lat_min = line start jitter
+//--------------------------------------------------------------
+#ifndef VGA_ISR_PROFILE
+#define VGA_ISR_PROFILE   0
+#endif
+
+typedef struct {
+  uint32_t cnt;         // measured interrupts
+  uint32_t sum;         // cycles of all measured interrupts
+  uint32_t max;         // longest interrupt in cycles
+  uint32_t lat_min;     // shortest entry latency in TIM2 ticks
+  uint32_t lat_max;     // longest entry latency in TIM2 ticks
+}VGA_IsrProfile_t;
+
+
+
 //--------------------------------------------------------------
 // Display RAM
 //--------------------------------------------------------------
-extern uint8_t VGA_RAM1[(VGA_DISPLAY_X+1)*VGA_DISPLAY_Y];
+#if VGA_USE_4BPP
+extern uint8_t VGA_FB4[2][VGA_4BPP_PITCH*VGA_DISPLAY_Y];
+extern uint8_t VGA_LineBuf[2][VGA_PITCH];
+#elif VGA_USE_DLIST
+extern VGA_DList_t VGA_DList;
+extern uint8_t VGA_LineBuf[2][VGA_PITCH];
+#elif VGA_USE_TEXT
+extern uint8_t VGA_Text[VGA_TEXT_ROWS*VGA_TEXT_COLS*2];
+extern uint8_t VGA_LineBuf[2][VGA_PITCH];
+#elif VGA_USE_HIRES
+extern uint8_t VGA_FBHi[VGA_HIRES_PITCH*VGA_DISPLAY_Y];
+extern uint8_t VGA_LineBuf[2][VGA_PITCH];
+#else
+extern uint8_t VGA_RAM1[VGA_PITCH*VGA_DISPLAY_Y];
+#endif
+
+
+
+//--------------------------------------------------------------
+// Dirty tracking of VGA_RAM1 (4bpp : of the back buffer)
+// one bit per line + the changed column range of that line
+// (x_min..x_max, inclusive). Updated by every write function of
+// this driver, read and reset with UB_VGA_GetDirtyRow(),
+// UB_VGA_NextDirtyRow() and UB_VGA_ClearDirty()
+//--------------------------------------------------------------
+#define VGA_DIRTY_WORDS   ((VGA_DISPLAY_Y+31)/32)
+
+typedef struct {
+  uint32_t rows[VGA_DIRTY_WORDS]; // bit y%32 of word y/32 = line y changed
+  uint16_t x_min[VGA_DISPLAY_Y];  // first changed column per line
+  uint16_t x_max[VGA_DISPLAY_Y];  // last changed column per line
+}VGA_Dirty_t;
+
+
+
+//--------------------------------------------------------------
+// DMA blitter (8bit frame buffer only)
+//
+// VGA_USE_BLIT = 1 : large fills (FillRect, FillScreen) and copies
+//                    (CopyRect) run on DMA2 Stream0 in memory-to-
+//                    memory mode (only DMA2 can do that, Stream5 is
+//                    the pixel DMA). The function starts the first
+//                    line and returns, the TC-Interrupt of Stream0
+//                    starts the next one. The middle of every line
+//                    is sent as 32bit words (a fill reads the same
+//                    pattern word again and again : fixed source
+//                    address), the bytes before the first and after
+//                    the last word boundary are written by the CPU.
+//                    Low stream priority and single transfers : the
+//                    DMA arbiter serves the pixel stream first after
+//                    every word, the scanout never waits for a burst.
+//                    Every other write function (and UB_VGA_Present)
+//                    first waits for the blitter, the order of the
+//                    drawing stays the same. UB_VGA_BlitBusy() and a
+//                    callback (UB_VGA_BlitSetCallback, called in the
+//                    interrupt) tell when the job is done.
+//                    Less than VGA_BLIT_MIN_W pixels per line or
+//                    VGA_BLIT_MIN_PIXELS in total : done by the CPU
+//                    (the interrupt per line costs more).
+//                    A copy inside the same lines is done by the CPU
+//                    too (the DMA only copies forward).
+//                    Without __arm__ (PC tests) the blitter does the
+//                    job at once, the result is the same.
+// VGA_USE_BLIT = 0 : all fills and copies by the CPU
+//--------------------------------------------------------------
+#ifndef VGA_USE_BLIT
+#define VGA_USE_BLIT    1
+#endif
+
+#if VGA_USE_BLIT && VGA_HAS_COPY
+#define VGA_HAS_BLIT    1
+#else
+#define VGA_HAS_BLIT    0
+#endif
+
+#define VGA_BLIT_MIN_W        32
+#define VGA_BLIT_MIN_PIXELS   4096
+
+#define VGA_BLIT_FILL         0
+#define VGA_BLIT_COPY         1
+
+// Stream0 CR : memory-to-memory, priority low, TC-Interrupt
+// (source = peripheral port, destination = memory port)
+#define VGA_BLIT_CR_FILL      (DMA_SxCR_DIR_1 | DMA_SxCR_MINC | DMA_SxCR_PSIZE_1 | \
+                               DMA_SxCR_MSIZE_1 | DMA_SxCR_TCIE)
+#define VGA_BLIT_CR_COPY32    (VGA_BLIT_CR_FILL | DMA_SxCR_PINC)
+#define VGA_BLIT_CR_COPY8     (DMA_SxCR_DIR_1 | DMA_SxCR_MINC | DMA_SxCR_PINC | \
+                               DMA_SxCR_MSIZE_1 | DMA_SxCR_TCIE)
+#define VGA_BLIT_IFCR         (DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTEIF0 | \
+                               DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0)
+
+typedef struct {
+  uint8_t  op;          // VGA_BLIT_FILL or VGA_BLIT_COPY
+  uint8_t  color;       // fill color
+  int8_t   step;        // +1 = top down, -1 = bottom up
+  uint16_t xd,yd;       // destination (screen coordinates)
+  uint16_t xs,ys;       // source (copy)
+  uint16_t w,h;
+  uint16_t row;         // lines started
+}VGA_Blit_t;
 
 
 
@@ -72,8 +510,13 @@ extern uint8_t VGA_RAM1[(VGA_DISPLAY_X+1)*VGA_DISPLAY_Y];
 // basefreq = 2*APB2 (APB2=84MHz) => TIM_CLK=168MHz
 // Frq       = 168MHz/1/12 = 14MHz
 //
+// hires : half the period, 640 pixels in the same line time
 //--------------------------------------------------------------
+#if VGA_USE_HIRES
+#define VGA_TIM1_PERIODE      5-1
+#else
 #define VGA_TIM1_PERIODE      10-1
+#endif
 #define VGA_TIM1_PRESCALE      0
 
 
@@ -98,6 +541,22 @@ extern uint8_t VGA_RAM1[(VGA_DISPLAY_X+1)*VGA_DISPLAY_Y];
 //#define  VGA_TIM2_DMA_DELAY        30  // ease the delay when DMA START (Optimization = -O1)
 
 
+//--------------------------------------------------------------
+// Timer-4 (only VGA_SCANOUT_DBM)
+// Function  = gate of Timer1 (pixel window of one line)
+//
+// basefreq  = 2*APB1 => TIM_CLK=63MHz (same as Timer2)
+// trigger   = Timer2 Update, one pulse
+// OC1REF    = high from VGA_TIM4_GATE_START for VGA_TIM4_GATE_LEN
+//             (= VGA_PITCH pixels of 10 TIM1 ticks at 126MHz)
+//
+// the TIM2-Interrupt (CH3) comes just after the window
+//--------------------------------------------------------------
+#define  VGA_TIM4_GATE_START      360  // HSync+BackPorch (5,71us)
+#define  VGA_TIM4_GATE_LEN        ((VGA_PITCH*(VGA_TIM1_PERIODE+1))/2)
+#define  VGA_TIM2_DBM_IRQ         (VGA_TIM4_GATE_START+VGA_TIM4_GATE_LEN+10)
+
+
 //--------------------------------------------------------------
 // VSync-Signal
 // Trigger   = Timer2 Update (f=31,48kHz => T = 31,76us)
@@ -105,9 +564,43 @@ extern uint8_t VGA_RAM1[(VGA_DISPLAY_X+1)*VGA_DISPLAY_Y];
 //--------------------------------------------------------------
 #define  VGA_VSYNC_PERIODE        525
 #define  VGA_VSYNC_IMP  2
+#if VGA_USE_HIRES
+#define  VGA_VSYNC_BILD_START      35   // 480 lines (35..514)
+#else
 #define  VGA_VSYNC_BILD_START      36
+#endif
 #define  VGA_VSYNC_BILD_STOP      514   // (16,38ms)
-#define RAM_SIZE		(VGA_DISPLAY_X+1)*VGA_DISPLAY_Y
+
+
+//--------------------------------------------------------------
+// VSync generation
+//
+// VGA_VSYNC_HW = 0 : VSync on PB12 (GPIO), set by TIM2_IRQHandler
+//                    with a software line counter
+// VGA_VSYNC_HW = 1 : VSync on PB0 (TIM3 CH3, PWM). Timer3 runs as
+//                    slave of Timer2 (external clock = TIM2 update
+//                    via ITR1) and counts the lines 0..524 itself.
+//                    The ISR only reads TIM3->CNT, so a missed or
+//                    late interrupt can not shift the picture.
+//                    (the VSync wire moves from PB12 to PB0)
+//
+// Timer-3
+// clock     = TIM2 Update (31,46kHz)
+// Periode   = VGA_VSYNC_PERIODE lines
+// CH3       = low for the first VGA_VSYNC_IMP lines
+//--------------------------------------------------------------
+#ifndef VGA_VSYNC_HW
+#define VGA_VSYNC_HW    0
+#endif
+#if VGA_USE_4BPP
+#define RAM_SIZE		(2*VGA_4BPP_PITCH*VGA_DISPLAY_Y)
+#elif VGA_USE_DLIST || VGA_USE_TEXT
+#define RAM_SIZE		(2*VGA_PITCH)
+#elif VGA_USE_HIRES
+#define RAM_SIZE		(VGA_HIRES_PITCH*VGA_DISPLAY_Y)
+#else
+#define RAM_SIZE		(VGA_PITCH*VGA_DISPLAY_Y)
+#endif
 
 
 //--------------------------------------------------------------
@@ -132,7 +625,39 @@ extern uint8_t VGA_RAM1[(VGA_DISPLAY_X+1)*VGA_DISPLAY_Y];
 //--------------------------------------------------------------
 void UB_VGA_Screen_Init(void);
 void UB_VGA_FillScreen(uint8_t color);
-void UB_VGA_SetPixel(uint16_t xp, uint16_t yp, uint8_t color);
+VGA_RAMFUNC void UB_VGA_SetPixel(uint16_t xp, uint16_t yp, uint8_t color);
+VGA_RAMFUNC void UB_VGA_DrawHLine(uint16_t xp, uint16_t yp, uint16_t len, uint8_t color);
+VGA_RAMFUNC void UB_VGA_DrawVLine(uint16_t xp, uint16_t yp, uint16_t len, uint8_t color);
+VGA_RAMFUNC void UB_VGA_FillRect(uint16_t xp, uint16_t yp, uint16_t w, uint16_t h, uint8_t color);
+VGA_RAMFUNC void UB_VGA_PutRow(uint16_t xp, uint16_t yp, const uint8_t *src, uint16_t len);
+uint8_t UB_VGA_GetDirtyRow(uint16_t yp, uint16_t *x_min, uint16_t *x_max);
+int16_t UB_VGA_NextDirtyRow(uint16_t yp);
+void UB_VGA_ClearDirtyRow(uint16_t yp);
+void UB_VGA_ClearDirty(void);
+uint32_t UB_VGA_GetFrameCount(void);
+uint8_t UB_VGA_InVBlank(void);
+void UB_VGA_WaitVBlank(void);
+void UB_VGA_Present(void);
+void UB_VGA_PresentAsync(void);
+uint8_t UB_VGA_PresentBusy(void);
+void UB_VGA_GetIsrProfile(VGA_IsrProfile_t *prof);
+void UB_VGA_ResetIsrProfile(void);
+void UB_VGA_SetPalette(uint8_t index, uint8_t color);
+void UB_VGA_TextSetFont(const uint8_t *font);
+void UB_VGA_TextPut(uint16_t col, uint16_t row, uint8_t code, uint8_t attr);
+void UB_VGA_TextChar(uint16_t col, uint16_t row, uint8_t code, uint8_t color);
+uint8_t UB_VGA_SetMode(uint8_t mode);
+const VGA_Mode_t *UB_VGA_GetMode(void);
+int16_t UB_VGA_FindMode(uint16_t width);
+uint8_t UB_VGA_Scroll(int16_t lines, uint8_t color);
+uint8_t UB_VGA_LineTabSet(uint16_t yp, uint16_t row);
+int16_t UB_VGA_LineTabGet(uint16_t yp);
+void UB_VGA_LineTabReset(void);
+void UB_VGA_LineTabApply(void);
+uint8_t UB_VGA_CopyRect(uint16_t xs, uint16_t ys, uint16_t w, uint16_t h, uint16_t xd, uint16_t yd);
+uint8_t UB_VGA_BlitBusy(void);
+void UB_VGA_BlitWait(void);
+void UB_VGA_BlitSetCallback(void (*callback)(void));
 
 //--------------------------------------------------------------
 #endif // __STM32F4_UB_VGA_SCREEN_H
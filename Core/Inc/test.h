@@ -27,4 +27,171 @@ void test_APIio(void);
  * Print resultaten via UART of printf.
  */
 void test_APIdraw(void);
+
+/**
+ * @brief Test de dirty-administratie van de VGA-driver.
+ *
+ * Controleert dat pixels, rechthoeken en lijnen de juiste regels
+ * en kolombereiken als gewijzigd markeren. Print resultaten via UART.
+ */
+void test_VGA_dirty(void);
+
+/**
+ * @brief Test de wachtrij van uitgesteld tekenen.
+ *
+ * Controleert dat opdrachten pas na het afwerken van de wachtrij
+ * in het VGA RAM staan. Print resultaten via UART.
+ */
+void test_raster_wachtrij(void);
+
+/**
+ * @brief Test de 4bpp regel-expansie van de VGA-driver.
+ *
+ * Controleert de paar-tabel, de volgorde van de pixels in een
+ * geëxpandeerde regel, het zoeken van de dichtstbijzijnde
+ * paletkleur, de expansie van tekstcellen met een font en van
+ * 1bpp- en 2bpp-regels.
+ * Print resultaten via UART.
+ */
+void test_VGA_expand(void);
+
+/**
+ * @brief Test de display-lijst renderer van de VGA-driver.
+ *
+ * Bouwt een eigen lijst (los van het scherm) en controleert per
+ * scanlijn rechthoeken, diepte, verplaatsen, wissen, lijn, cirkel
+ * en halve regels. Meet ook één halve regel met tekst.
+ * Print resultaten via UART.
+ */
+void test_VGA_dlist(void);
+
+/**
+ * @brief Test de videomodi van de VGA-driver.
+ *
+ * Controleert de descriptor van de actieve modus, de foutcontrole van
+ * het modus-commando en, in de 8-bit build, het wisselen naar 160x120:
+ * clipping, adressering met de kleinere pitch en de tijd van
+ * clearscherm in beide modi.
+ * Print resultaten via UART.
+ */
+void test_VGA_modus(void);
+
+/**
+ * @brief Test het verticaal scrollen van de VGA-driver.
+ *
+ * Controleert de foutcontrole van het scroll-commando, de ring-offset,
+ * het wissen van de binnenkomende regels en dat tekenopdrachten na het
+ * scrollen op dezelfde schermpositie blijven.
+ * Print resultaten via UART.
+ */
+void test_VGA_scroll(void);
+
+/**
+ * @brief Test de regeltabel van de VGA-driver.
+ *
+ * Controleert de grenzen van UB_VGA_LineTabSet(), het wisselen van de
+ * tabellen in de verticale blanking, een gesplitst scherm met een vaste
+ * statusbalk boven een gedraaid deel en regelverdubbeling.
+ * Print resultaten via UART.
+ */
+void test_VGA_regeltabel(void);
+
+/**
+ * @brief Test het kopiëren van rechthoeken (kopieer).
+ *
+ * Controleert de foutcodes, een kopie zonder overlap naar een andere
+ * woordgrens en overlappende kopieën in alle richtingen, ook binnen
+ * één regel. In modi zonder 8-bit framebuffer alleen ERROR_KOPIEER.
+ * Print resultaten via UART.
+ */
+void test_VGA_kopieer(void);
+
+/**
+ * @brief Test de DMA-blitter (VGA_USE_BLIT).
+ *
+ * Controleert dat clearscherm terugkeert terwijl de DMA nog wist, de
+ * callback, een gevulde rechthoek op een oneven x en een kopie naar een
+ * andere uitlijning. Meet de cycli tot de CPU vrij is en tot de blitter
+ * klaar is. Print resultaten via UART.
+ */
+void test_VGA_blitter(void);
+
+/**
+ * @brief Test het tekendoel (Surface) van de rasterlaag.
+ *
+ * Tekent met de gewone API in een surface in geheugen, controleert de
+ * validatie tegen de maten van de surface en dat de padding heel blijft,
+ * en kopieert de surface (ook geclipt, transparant en uitgesteld) naar
+ * het scherm. Vergelijkt de cycli van tekst tekenen met een blit.
+ * Print resultaten via UART.
+ */
+void test_VGA_surface(void);
+
+/**
+ * @brief Test de ring- en schijfrasterizer (raster_ring).
+ *
+ * Vergelijkt een gevulde schijf en een ring van 5 pixels in een surface
+ * pixel voor pixel met het midpoint-criterium en controleert een
+ * uitgestelde schijf op het scherm. Print resultaten via UART.
+ */
+void test_raster_ring(void);
+
+/**
+ * @brief Test de rasterizer voor dikke lijnen (raster_lijn).
+ *
+ * Vergelijkt een horizontale lijn met de rechthoek van voorheen en een
+ * schuine lijn met elk soort uiteinde pixel voor pixel met de balk
+ * rond de middenlijn. Print resultaten via UART.
+ */
+void test_raster_lijn(void);
+
+/**
+ * @brief Test de veelhoekvuller (raster_veelhoek).
+ *
+ * Vergelijkt een holle pijl, een ster en een driehoek met beide
+ * vulregels pixel voor pixel met een exacte telling van de randen en
+ * controleert een uitgestelde veelhoek op het scherm. Print resultaten
+ * via UART.
+ */
+void test_raster_veelhoek(void);
+
+/**
+ * @brief Test de stempelcache met toren().
+ *
+ * Controleert de tellers (misser, treffers), dat een toren uit de cache
+ * gelijk is aan een direct getekende toren, dat wit niet in de cache komt
+ * en dat de oudste stempel verwijderd wordt als de cache vol is.
+ * Vergelijkt de cycli van een directe toren met een treffer.
+ * Print resultaten via UART.
+ */
+void test_stempel_cache(void);
+
+/**
+ * @brief Meet de tekensnelheid van de API draw laag.
+ *
+ * Meet met de DWT cyclusteller hoeveel pixels per seconde gevulde
+ * rechthoeken en dikke lijnen halen, ook apart tijdens actief beeld
+ * en tijdens de blanking (invloed van de pixel-DMA op de bus).
+ * Het kopiëren van rechthoeken wordt in MB/s gerapporteerd.
+ * Print resultaten via UART.
+ */
+void benchmark_APIdraw(void);
+
+/**
+ * @brief Meet de kosten van de lijn-interrupt van de VGA-driver.
+ *
+ * Geeft het gemiddelde en maximale aantal cycli van TIM2_IRQHandler
+ * over één frame en het deel van de CPU-tijd. Vereist VGA_ISR_PROFILE=1.
+ * Print resultaten via UART.
+ */
+void benchmark_VGA_isr(void);
+
+/**
+ * @brief Print het geheugengebruik per sectie in RAM en CCMRAM.
+ *
+ * Gebruikt de symbolen uit het linkerscript en controleert dat de
+ * stack in de CCM RAM staat en het VGA RAM in de DMA-bereikbare RAM.
+ * Print resultaten via UART.
+ */
+void rapport_geheugen(void);
 #endif // APIIO_TEST_H
@@ -4,9 +4,12 @@
  *
  *
  * Functies:
- *  - lijn(), rechthoek(), cirkel(), figuur()
+ *  - lijn(), rechthoek(), cirkel(), figuur(), veelhoek()
  *  - toren(), tekst(), bitMap()
  *
+ * toren() gaat via de stempelcache (APIstempel.c): een toren met dezelfde
+ * grootte en kleuren wordt één keer getekend en daarna gekopieerd.
+ *
  * @author Thijs, Joost, Luc
  * @version 1.0
  * @date 2025-11-20
@@ -18,6 +21,8 @@
 #include "APIdraw.h"
 #include "APIio.h"
 #include "APIerror.h"
+#include "APIraster.h"
+#include "APIstempel.h"
 #include "bitMap.h"
 #include "font_pearl_8x8.h"
 #include "font_acorn_8x8.h"
@@ -28,7 +33,8 @@
  *
  * Deze functie valideert eerst de invoerparameters. Indien er geen fouten
  * optreden, wordt een lijn getekend met behulp van het Bresenham-algoritme.
- * De lijn kan een dikte groter dan 1 pixel hebben.
+ * Een dikkere lijn is een balk rond de middenlijn; kap bepaalt de vorm van
+ * de uiteinden (zie raster_lijn()).
  *
  * @param x1 Begin x-coördinaat
  * @param y1 Begin y-coördinaat
@@ -36,10 +42,11 @@
  * @param y2 Eind y-coördinaat
  * @param kleur Kleur van de lijn als string
  * @param dikte Dikte van de lijn in pixels
+ * @param kap Uiteinden: RASTER_KAP_VIERKANT, RASTER_KAP_ROND of RASTER_KAP_PLAT
  *
  * @return ErrorList Struct met eventuele foutmeldingen
  */
-ErrorList lijn(int x1, int y1, int x2, int y2, const char *kleur, int dikte)
+ErrorList lijn(int x1, int y1, int x2, int y2, const char *kleur, int dikte, int kap)
 {
     uint8_t color;
     ErrorList errors;
@@ -52,64 +59,29 @@ ErrorList lijn(int x1, int y1, int x2, int y2, const char *kleur, int dikte)
     errors = Error_handling(FUNC_lijn,
                             x1, y1, x2, y2,
                             color, dikte,
-                            0, 0, 0, 0, 0);
+                            kap, 0, 0, 0, 0);
 
     if (errors.error_var1 ||
         errors.error_var2 ||
         errors.error_var3 ||
         errors.error_var4 ||
         errors.error_var5 ||
-        errors.error_var6)
+        errors.error_var6 ||
+        errors.error_var7)
         return errors;
 
     /* Commando opslaan voor herhalen (indien nodig) */
     if (herhaal_hoog == 0)
     {
-        int params[] = {x1, y1, x2, y2, (int)color, dikte};
+        int params[] = {x1, y1, x2, y2, (int)color, dikte, kap};
 
-        record_command(CMD_LIJN, 6, params);
+        record_command(CMD_LIJN, 7, params);
         herhaal_hoog = 1;
         ik_heb_geactiveerd = 1;
     }
 
-    /* Variabelen voor Bresenham-algoritme */
-    int dx = abs(x2 - x1);
-    int dy = -abs(y2 - y1);
-    int sx = (x1 < x2) ? 1 : -1;
-    int sy = (y1 < y2) ? 1 : -1;
-    int err = dx + dy;
-    int e2;
-
-    /* Teken de lijn pixel voor pixel */
-    while (1)
-    {
-        /* Teken dikte rondom het huidige punt */
-        for (int i = -(dikte / 2); i <= dikte / 2; i++)
-        {
-            for (int j = -(dikte / 2); j <= dikte / 2; j++)
-            {
-                (void)drawPixel(x1 + i, y1 + j, kleur);
-            }
-        }
-
-        /* Stop als eindpunt bereikt is */
-        if (x1 == x2 && y1 == y2)
-            break;
-
-        e2 = 2 * err;
-
-        if (e2 >= dy)
-        {
-            err += dy;
-            x1 += sx;
-        }
-
-        if (e2 <= dx)
-        {
-            err += dx;
-            y1 += sy;
-        }
-    }
+    /* Teken de lijn via de rasterlaag (kleur is al gevalideerd) */
+    raster_lijn(x1, y1, x2, y2, color, dikte, kap);
 
     /* Reset herhaal-status indien deze functie dit activeerde */
     if (ik_heb_geactiveerd)
@@ -167,35 +139,8 @@ ErrorList rechthoek(int x, int y, int w, int h, const char *kleur, int gevuld)
         ik_heb_geactiveerd = 1;
     }
 
-    /* Bereken rechter-onderhoek */
-    int x2 = x + w - 1;
-    int y2 = y + h - 1;
-
     /* Teken rechthoek */
-    if (gevuld)
-    {
-        for (unsigned int j = y; j <= y2; j++)
-        {
-            for (unsigned int i = x; i <= x2; i++)
-            {
-                drawPixel(i, j, kleur);
-            }
-        }
-    }
-    else
-    {
-        for (unsigned int i = x; i <= x2; i++)
-            drawPixel(i, y, kleur);
-
-        for (unsigned int i = x; i <= x2; i++)
-            drawPixel(i, y2, kleur);
-
-        for (unsigned int j = y; j <= y2; j++)
-            drawPixel(x, j, kleur);
-
-        for (unsigned int j = y; j <= y2; j++)
-            drawPixel(x2, j, kleur);
-    }
+    raster_rechthoek(x, y, w, h, color, gevuld);
 
     /* Herhaalstatus resetten */
     if (ik_heb_geactiveerd)
@@ -258,12 +203,12 @@ ErrorList figuur(int x1, int y1,
         ik_heb_geactiveerd = 1;
     }
 
-    /* Verbind alle punten met lijnen */
-    lijn(x1, y1, x2, y2, kleur, 1);
-    lijn(x2, y2, x3, y3, kleur, 1);
-    lijn(x3, y3, x4, y4, kleur, 1);
-    lijn(x4, y4, x5, y5, kleur, 1);
-    lijn(x5, y5, x1, y1, kleur, 1);
+    /* Verbind alle punten met lijnen (alle punten zijn al gecontroleerd) */
+    {
+        int punten[] = {x1, y1, x2, y2, x3, y3, x4, y4, x5, y5};
+
+        raster_veelhoek(punten, 5, color, RASTER_VUL_RAND);
+    }
 
     /* Herhaalstatus resetten */
     if (ik_heb_geactiveerd)
@@ -273,19 +218,22 @@ ErrorList figuur(int x1, int y1,
 }
 
 /**
- * @brief Tekent een cirkel op het scherm.
+ * @brief Tekent een gesloten veelhoek met 3 t/m RASTER_MAX_PUNTEN punten.
  *
- * Deze functie tekent een cirkel met een opgegeven straal
- * vanuit een middelpunt, met behulp van het Bresenham-algoritme.
+ * Zonder vulling worden de punten met lijnen verbonden, net als bij
+ * figuur(). Een gevulde veelhoek mag hol zijn of zichzelf snijden; bij
+ * RASTER_VUL_NIET_NUL is alles binnen waar de rand omheen loopt, bij
+ * RASTER_VUL_EVEN_ONEVEN wisselen binnen en buiten bij elke rand (een
+ * ster krijgt dan een gat in het midden).
  *
- * @param x0 X-coördinaat middelpunt
- * @param y0 Y-coördinaat middelpunt
- * @param radius Straal in pixels
+ * @param punten x- en y-coördinaten om en om: x1, y1, x2, y2, ...
+ * @param aantal Aantal punten
  * @param kleur Kleur als string
+ * @param gevuld RASTER_VUL_RAND (0), RASTER_VUL_EVEN_ONEVEN (1) of RASTER_VUL_NIET_NUL (2)
  *
  * @return ErrorList Struct met eventuele fouten
  */
-ErrorList cirkel(int x0, int y0, int radius, const char *kleur)
+ErrorList veelhoek(const int *punten, int aantal, const char *kleur, int gevuld)
 {
     uint8_t color;
     ErrorList errors;
@@ -294,55 +242,47 @@ ErrorList cirkel(int x0, int y0, int radius, const char *kleur)
     /* Zet kleur om */
     color = kleur_omzetter(kleur);
 
-    /* Controleer invoer */
-    errors = Error_handling(FUNC_cirkel,
-                            x0, y0, radius,
-                            color,
-                            0, 0, 0, 0, 0, 0, 0);
+    /* Controleer aantal, kleur en vulling, daarna elk punt */
+    errors = Error_handling(FUNC_veelhoek,
+                            aantal, color, gevuld,
+                            0, 0, 0, 0, 0, 0, 0, 0);
+
+    if (errors.error_var1 == NO_ERROR)
+    {
+        for (int i = 0; i < aantal; i++)
+        {
+            ErrorCode x_error = check_x(punten[2 * i]);
+            ErrorCode y_error = check_y(punten[2 * i + 1]);
+
+            if (x_error != NO_ERROR) errors.error_var4 = x_error;
+            if (y_error != NO_ERROR) errors.error_var5 = y_error;
+        }
+    }
 
     if (errors.error_var1 ||
         errors.error_var2 ||
         errors.error_var3 ||
-        errors.error_var4)
+        errors.error_var4 ||
+        errors.error_var5)
         return errors;
 
-    /* Commando opslaan indien nodig */
+    /* Commando opslaan indien nodig: aantal, kleur, vulling en de punten */
     if (herhaal_hoog == 0)
     {
-        int params[] = {x0, y0, radius, (int)color};
+        int params[3 + 2 * RASTER_MAX_PUNTEN];
 
-        record_command(CMD_CIRKEL, 4, params);
+        params[0] = aantal;
+        params[1] = (int)color;
+        params[2] = gevuld;
+        for (int i = 0; i < 2 * aantal; i++)
+            params[3 + i] = punten[i];
+
+        record_command(CMD_VEELHOEK, 3 + 2 * aantal, params);
         herhaal_hoog = 1;
         ik_heb_geactiveerd = 1;
     }
 
-    /* Bresenham-cirkel algoritme */
-    int x = radius;
-    int y = 0;
-    int err = 0;
-
-    while (x >= y)
-    {
-        drawPixel(x0 + x, y0 + y, kleur);
-        drawPixel(x0 + y, y0 + x, kleur);
-        drawPixel(x0 - y, y0 + x, kleur);
-        drawPixel(x0 - x, y0 + y, kleur);
-        drawPixel(x0 - x, y0 - y, kleur);
-        drawPixel(x0 - y, y0 - x, kleur);
-        drawPixel(x0 + y, y0 - x, kleur);
-        drawPixel(x0 + x, y0 - y, kleur);
-
-        y++;
-
-        if (err <= 0)
-            err += 2 * y + 1;
-
-        if (err > 0)
-        {
-            x--;
-            err -= 2 * x + 1;
-        }
-    }
+    raster_veelhoek(punten, aantal, color, gevuld);
 
     /* Herhaalstatus resetten */
     if (ik_heb_geactiveerd)
@@ -351,55 +291,122 @@ ErrorList cirkel(int x0, int y0, int radius, const char *kleur)
     return errors;
 }
 
-
 /**
- * @brief Tekent een toren met meerdere lagen, een mast en een vlag.
+ * @brief Tekent een cirkel op het scherm.
  *
- * Deze functie bouwt een toren op uit cirkelvormige lagen.
- * Bovenop de toren wordt een mast en een vlag getekend.
+ * Deze functie tekent een cirkel met een opgegeven straal
+ * vanuit een middelpunt. Een omtrek van 1 pixel gaat met het
+ * Bresenham-algoritme; een dikke ring of een gevulde schijf wordt
+ * als één span per rij getekend.
  *
- * @param x X-coördinaat van het midden van de torenbasis
- * @param y Y-coördinaat van de torenbasis
- * @param grootte Basisgrootte van de toren
- * @param kleur1 Kleur van de torenlagen
- * @param kleur2 Kleur van mast en vlag
+ * @param x0 X-coördinaat middelpunt
+ * @param y0 Y-coördinaat middelpunt
+ * @param radius Straal in pixels
+ * @param kleur Kleur als string
+ * @param gevuld 1 = gevulde schijf, 0 = ring
+ * @param dikte Dikte van de ring naar binnen (1 t/m radius)
  *
  * @return ErrorList Struct met eventuele fouten
  */
-ErrorList toren(int x, int y, int grootte, const char *kleur1, const char *kleur2)
+ErrorList cirkel(int x0, int y0, int radius, const char *kleur, int gevuld, int dikte)
 {
-    uint8_t color1;
-    uint8_t color2;
+    uint8_t color;
     ErrorList errors;
     int ik_heb_geactiveerd = 0;
 
-    /* Zet kleuren om */
-    color1 = kleur_omzetter(kleur1);
-    color2 = kleur_omzetter(kleur2);
+    /* Zet kleur om */
+    color = kleur_omzetter(kleur);
 
     /* Controleer invoer */
-    errors = Error_handling(FUNC_toren,
-                            x, y, grootte,
-                            color1, color2,
-                            0, 0, 0, 0, 0, 0);
+    errors = Error_handling(FUNC_cirkel,
+                            x0, y0, radius,
+                            color, gevuld, dikte,
+                            0, 0, 0, 0, 0);
 
     if (errors.error_var1 ||
         errors.error_var2 ||
         errors.error_var3 ||
         errors.error_var4 ||
-        errors.error_var5)
+        errors.error_var5 ||
+        errors.error_var6)
         return errors;
 
     /* Commando opslaan indien nodig */
     if (herhaal_hoog == 0)
     {
-        int params[] = {x, y, grootte, (int)color1, (int)color2};
+        int params[] = {x0, y0, radius, (int)color, gevuld, dikte};
 
-        record_command(CMD_TOREN, 5, params);
+        record_command(CMD_CIRKEL, 6, params);
         herhaal_hoog = 1;
         ik_heb_geactiveerd = 1;
     }
 
+    /* Schijf of ring als spans, een dunne omtrek met Bresenham */
+    if (gevuld)
+        raster_ring(x0, y0, radius, radius + 1, color);
+    else if (dikte > 1)
+        raster_ring(x0, y0, radius, dikte, color);
+    else
+        raster_cirkel(x0, y0, radius, color);
+
+    /* Herhaalstatus resetten */
+    if (ik_heb_geactiveerd)
+        herhaal_hoog = 0;
+
+    return errors;
+}
+
+
+/**
+ * @brief Grootte en kleuren van een toren, voor teken_toren().
+ */
+typedef struct
+{
+    int grootte;
+    const char *kleur1;
+    const char *kleur2;
+} TorenKleuren;
+
+/**
+ * @brief Geeft het kader van een toren ten opzichte van het midden van de basis.
+ *
+ * Van de vlag bovenaan tot de onderkant van de basiscirkel, en van de
+ * linkerkant van de basis tot de rechterkant van basis of vlag.
+ *
+ * @param grootte Basisgrootte van de toren
+ * @param vorm Stempelvorm om in te vullen (zonder kleuren)
+ */
+static void toren_kader(int grootte, StempelVorm *vorm)
+{
+    int lagen = 6;
+    int hoogte_per_laag = grootte / 2;
+    int top_radius = grootte / 3;
+    int mast_hoogte = grootte / 4;
+    int boven = -((lagen - 1) * hoogte_per_laag) - top_radius - mast_hoogte - 7;
+    int rechts = (grootte > 5) ? grootte : 5;
+
+    vorm->vorm = STEMPEL_TOREN;
+    vorm->grootte = (int16_t)grootte;
+    vorm->links = (int16_t)-grootte;
+    vorm->boven = (int16_t)boven;
+    vorm->breedte = (int16_t)(rechts + grootte + 1);
+    vorm->hoogte = (int16_t)(grootte - boven + 1);
+}
+
+/**
+ * @brief Tekent een toren met de API-functies (lagen, mast en vlag).
+ *
+ * @param x X-coördinaat van het midden van de torenbasis
+ * @param y Y-coördinaat van de torenbasis
+ * @param arg TorenKleuren
+ */
+static void teken_toren(int x, int y, const void *arg)
+{
+    const TorenKleuren *t = (const TorenKleuren *)arg;
+    int grootte = t->grootte;
+    const char *kleur1 = t->kleur1;
+    const char *kleur2 = t->kleur2;
+
     /* Instellingen voor de toren */
     int lagen = 6;
     int basis_radius = grootte;
@@ -419,9 +426,8 @@ ErrorList toren(int x, int y, int grootte, const char *kleur1, const char *kleur
 
         y_midden = y - (i * hoogte_per_laag);
 
-        /* Teken buiten- en binnencirkel */
-        (void)cirkel(x, y_midden, radius, kleur1);
-        (void)cirkel(x, y_midden, radius - 2, kleur1);
+        /* Teken een ring van 3 pixels (zonder gaten tussen buiten- en binnenrand) */
+        (void)cirkel(x, y_midden, radius, kleur1, 0, (radius > 2) ? 3 : 1);
 
         /* Verbind lagen met verticale lijnen */
         if (i > 0)
@@ -430,10 +436,10 @@ ErrorList toren(int x, int y, int grootte, const char *kleur1, const char *kleur
             int y_eind  = y_midden - (hoogte_per_laag / 2);
 
             (void)lijn(x - radius + 1, y_start,
-                       x - radius + 1, y_eind, kleur1, 1);
+                       x - radius + 1, y_eind, kleur1, 1, RASTER_KAP_VIERKANT);
 
             (void)lijn(x + radius - 1, y_start,
-                       x + radius - 1, y_eind, kleur1, 1);
+                       x + radius - 1, y_eind, kleur1, 1, RASTER_KAP_VIERKANT);
         }
     }
 
@@ -450,6 +456,69 @@ ErrorList toren(int x, int y, int grootte, const char *kleur1, const char *kleur
                  x,     y_mast_top - mast_hoogte - 5,
                  x,     y_mast_top - mast_hoogte,
                  kleur2);
+}
+
+
+/**
+ * @brief Tekent een toren met meerdere lagen, een mast en een vlag.
+ *
+ * Deze functie bouwt een toren op uit cirkelvormige lagen.
+ * Bovenop de toren wordt een mast en een vlag getekend. Een toren die
+ * eerder met dezelfde grootte en kleuren getekend is, komt als stempel
+ * uit de stempelcache.
+ *
+ * @param x X-coördinaat van het midden van de torenbasis
+ * @param y Y-coördinaat van de torenbasis
+ * @param grootte Basisgrootte van de toren
+ * @param kleur1 Kleur van de torenlagen
+ * @param kleur2 Kleur van mast en vlag
+ *
+ * @return ErrorList Struct met eventuele fouten
+ */
+ErrorList toren(int x, int y, int grootte, const char *kleur1, const char *kleur2)
+{
+    uint8_t color1;
+    uint8_t color2;
+    ErrorList errors;
+    int ik_heb_geactiveerd = 0;
+
+    /* Zet kleuren om */
+    color1 = kleur_omzetter(kleur1);
+    color2 = kleur_omzetter(kleur2);
+
+    /* Controleer invoer */
+    errors = Error_handling(FUNC_toren,
+                            x, y, grootte,
+                            color1, color2,
+                            0, 0, 0, 0, 0, 0);
+
+    if (errors.error_var1 ||
+        errors.error_var2 ||
+        errors.error_var3 ||
+        errors.error_var4 ||
+        errors.error_var5)
+        return errors;
+
+    /* Commando opslaan indien nodig */
+    if (herhaal_hoog == 0)
+    {
+        int params[] = {x, y, grootte, (int)color1, (int)color2};
+
+        record_command(CMD_TOREN, 5, params);
+        herhaal_hoog = 1;
+        ik_heb_geactiveerd = 1;
+    }
+
+    /* Uit de stempelcache, of direct als de cache niet gebruikt kan worden */
+    StempelVorm vorm;
+    TorenKleuren kleuren = { grootte, kleur1, kleur2 };
+
+    toren_kader(grootte, &vorm);
+    vorm.kleur1 = color1;
+    vorm.kleur2 = color2;
+
+    if (!stempel_teken(&vorm, x, y, teken_toren, &kleuren))
+        teken_toren(x, y, &kleuren);
 
     /* Herhaalstatus resetten */
     if (ik_heb_geactiveerd)
@@ -519,7 +588,7 @@ ErrorList bitMap(int nr, int x, int y)
         return errors;
 
     /* Teken bitmap */
-    drawBitmap(x, y, bmp_ptr, use_transparency);
+    raster_bitmap(x, y, bmp_ptr, use_transparency);
 
     /* Herhaalstatus resetten */
     if (ik_heb_geactiveerd)
@@ -613,52 +682,31 @@ ErrorList tekst(int x, int y, const char *kleur_str, const char *tekst_str,
         if (karakter < 0 || karakter > 126)
             karakter = 0;
 
-        int bitmap_index = karakter * BASE_FONT_SIZE;
-
         /* Bereken breedte van het karakter */
+#if VGA_USE_TEXT
+        /* Tekstmodus: elk karakter is precies één cel */
+        int char_width = VGA_TEXT_CELL;
+        int regel_hoogte = VGA_TEXT_CELL;
+#else
         int char_width = BASE_FONT_SIZE * schaal_factor;
         if (is_vet)
             char_width += schaal_factor;
         if (is_cursief)
             char_width += (int)((7.0 / 3.0) * schaal_factor + 0.5);
         char_width += schaal_factor;
+        int regel_hoogte = BASE_FONT_SIZE * schaal_factor + schaal_factor;
+#endif
 
         /* Wrap naar volgende regel indien nodig */
-        if (x + char_width > VGA_DISPLAY_X)
+        if (x + char_width > raster_doel_breedte())
         {
             x = 0;
-            y += BASE_FONT_SIZE * schaal_factor + schaal_factor;
+            y += regel_hoogte;
         }
 
         /* Teken bitmap van karakter */
-        for (int rij = 0; rij < BASE_FONT_SIZE; rij++)
-        {
-            unsigned char rij_data = active_font_data[bitmap_index + rij];
-            int offset_schuin = 0;
-
-            if (is_cursief)
-                offset_schuin = (int)((rij / 3.0) * schaal_factor + 0.5);
-
-            for (int bit = 0; bit < BASE_FONT_SIZE; bit++)
-            {
-                if ((rij_data >> (7 - bit)) & 1)
-                {
-                    for (int s_y = 0; s_y < schaal_factor; s_y++)
-                    {
-                        for (int s_x = 0; s_x < schaal_factor; s_x++)
-                        {
-                            int pixel_x = x + (bit * schaal_factor) + s_x + offset_schuin;
-                            int pixel_y = y + (rij * schaal_factor) + s_y;
-
-                            drawPixel(pixel_x, pixel_y, kleur_str);
-
-                            if (is_vet)
-                                drawPixel(pixel_x + schaal_factor, pixel_y, kleur_str);
-                        }
-                    }
-                }
-            }
-        }
+        raster_karakter(x, y, karakter, active_font_data,
+                        schaal_factor, is_vet, is_cursief, (uint8_t)color);
 
         x += char_width;
         current_char_index++;
@@ -670,3 +718,61 @@ ErrorList tekst(int x, int y, const char *kleur_str, const char *tekst_str,
 
     return errors;
 }
+
+
+/**
+ * @brief Kopieert een rechthoek van het scherm naar een andere plek.
+ *
+ * De pixels van (x,y) met breedte w en hoogte h komen op (doel_x,doel_y).
+ * Bron en doel mogen overlappen: het resultaat is hetzelfde als bij een
+ * kopie via een tweede buffer. Er wordt niets opnieuw getekend, de driver
+ * kopieert de pixels in het framebuffer.
+ *
+ * @param x X-coördinaat linker-bovenhoek van de bron
+ * @param y Y-coördinaat linker-bovenhoek van de bron
+ * @param w Breedte in pixels
+ * @param h Hoogte in pixels
+ * @param doel_x X-coördinaat linker-bovenhoek van het doel
+ * @param doel_y Y-coördinaat linker-bovenhoek van het doel
+ *
+ * @return ErrorList Struct met eventuele fouten
+ */
+ErrorList kopieer(int x, int y, int w, int h, int doel_x, int doel_y)
+{
+    ErrorList errors;
+    int ik_heb_geactiveerd = 0;
+
+    /* Controleer invoer */
+    errors = Error_handling(FUNC_kopieer,
+                            x, y, w, h,
+                            doel_x, doel_y,
+                            0, 0, 0, 0, 0);
+
+    if (errors.error_var1 ||
+        errors.error_var2 ||
+        errors.error_var3 ||
+        errors.error_var4 ||
+        errors.error_var5 ||
+        errors.error_var6 ||
+        errors.error_var7)
+        return errors;
+
+    /* Commando opslaan indien nodig */
+    if (herhaal_hoog == 0)
+    {
+        int params[] = {x, y, w, h, doel_x, doel_y};
+
+        record_command(CMD_KOPIEER, 6, params);
+        herhaal_hoog = 1;
+        ik_heb_geactiveerd = 1;
+    }
+
+    /* Kopieer rechthoek */
+    raster_kopieer(x, y, w, h, doel_x, doel_y);
+
+    /* Herhaalstatus resetten */
+    if (ik_heb_geactiveerd)
+        herhaal_hoog = 0;
+
+    return errors;
+}
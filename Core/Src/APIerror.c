@@ -15,6 +15,7 @@
 #include "bitMap.h"
 #include <stddef.h>
 #include "APIio.h"
+#include "APIraster.h"
 #include "string.h"
 
 /**
@@ -60,12 +61,14 @@ ErrorList Error_handling(FunctionID func,
             ErrorCode y2_error    = check_y(waarde4);
             ErrorCode kleur_error = check_color(waarde5);
             ErrorCode lijn_error  = check_lijn_op_scherm(waarde1, waarde2, waarde3, waarde4, waarde6);
+            ErrorCode kap_error   = check_kap(waarde7);
             if(x1_error != NO_ERROR)    errors.error_var1 = x1_error;
             if(y1_error != NO_ERROR)    errors.error_var2 = y1_error;
             if(x2_error != NO_ERROR)    errors.error_var3 = x2_error;
             if(y2_error != NO_ERROR)    errors.error_var4 = y2_error;
             if(kleur_error != NO_ERROR) errors.error_var5 = kleur_error;
             if(lijn_error != NO_ERROR)  errors.error_var6 = lijn_error;
+            if(kap_error != NO_ERROR)   errors.error_var7 = kap_error;
             break;
         }
 
@@ -119,10 +122,14 @@ ErrorList Error_handling(FunctionID func,
             ErrorCode y_error      = check_y(waarde2);
             ErrorCode radius_error = check_radius_op_scherm(waarde1, waarde2, waarde3);
             ErrorCode kleur_error  = check_color(waarde4);
+            ErrorCode gevuld_error = check_gevuld(waarde5);
+            ErrorCode dikte_error  = check_cirkel_dikte(waarde3, waarde6);
             if(x_error != NO_ERROR)      errors.error_var1 = x_error;
             if(y_error != NO_ERROR)      errors.error_var2 = y_error;
             if(radius_error != NO_ERROR) errors.error_var3 = radius_error;
             if(kleur_error != NO_ERROR)  errors.error_var4 = kleur_error;
+            if(gevuld_error != NO_ERROR) errors.error_var5 = gevuld_error;
+            if(dikte_error != NO_ERROR)  errors.error_var6 = dikte_error;
             break;
         }
 
@@ -150,6 +157,69 @@ ErrorList Error_handling(FunctionID func,
         }
 
 
+        case FUNC_wachtframe:
+        {
+            ErrorCode frames_error = wachtframe_error(waarde1);
+
+            if(frames_error != NO_ERROR) errors.error_var1 = frames_error;
+            break;
+        }
+
+        case FUNC_uitgesteld:
+        {
+            ErrorCode aan_error = check_aan_uit(waarde1);
+
+            if(aan_error != NO_ERROR) errors.error_var1 = aan_error;
+            break;
+        }
+
+        case FUNC_modus:
+        {
+            ErrorCode modus_error = check_modus(waarde1);
+
+            if(modus_error != NO_ERROR) errors.error_var1 = modus_error;
+            break;
+        }
+
+        case FUNC_scroll:
+        {
+            ErrorCode scroll_error = check_scroll(waarde1);
+
+            if(scroll_error != NO_ERROR) errors.error_var1 = scroll_error;
+            break;
+        }
+
+        case FUNC_kopieer:
+        {
+            ErrorCode x_error       = check_x(waarde1);
+            ErrorCode y_error       = check_y(waarde2);
+            ErrorCode breedte_error = check_breedte(waarde1, waarde3);
+            ErrorCode hoogte_error  = check_hoogte(waarde2, waarde4);
+            ErrorCode doel_x_error  = check_breedte(waarde5, waarde3);
+            ErrorCode doel_y_error  = check_hoogte(waarde6, waarde4);
+            ErrorCode modus_error   = check_kopieer();
+            if(x_error != NO_ERROR)       errors.error_var1 = x_error;
+            if(y_error != NO_ERROR)       errors.error_var2 = y_error;
+            if(breedte_error != NO_ERROR) errors.error_var3 = breedte_error;
+            if(hoogte_error != NO_ERROR)  errors.error_var4 = hoogte_error;
+            if(doel_x_error != NO_ERROR)  errors.error_var5 = doel_x_error;
+            if(doel_y_error != NO_ERROR)  errors.error_var6 = doel_y_error;
+            if(modus_error != NO_ERROR)   errors.error_var7 = modus_error;
+            break;
+        }
+
+        case FUNC_veelhoek:
+        {
+            /* De punten zelf controleert veelhoek() met check_x() en check_y() */
+            ErrorCode aantal_error  = check_aantal_punten(waarde1);
+            ErrorCode kleur_error   = check_color(waarde2);
+            ErrorCode vulling_error = check_vulling(waarde3);
+            if(aantal_error != NO_ERROR)  errors.error_var1 = aantal_error;
+            if(kleur_error != NO_ERROR)   errors.error_var2 = kleur_error;
+            if(vulling_error != NO_ERROR) errors.error_var3 = vulling_error;
+            break;
+        }
+
         case FUNC_herhaal:
         {
         	ErrorCode aantal_error = herhaal_aantal_error(waarde1);
@@ -200,25 +270,25 @@ ErrorList Error_handling(FunctionID func,
 }
 
 /**
- * @brief Controleer X-coördinaat binnen scherm
+ * @brief Controleer X-coördinaat binnen het tekendoel (standaard het scherm)
  * @param x X-coördinaat
  * @return ERROR_X1 als fout, anders NO_ERROR
  */
 ErrorCode check_x(int x)
 {
-    if(x < 0 || x >= VGA_DISPLAY_X)
+    if(x < 0 || x >= raster_doel_breedte())
         return ERROR_X1;
     return NO_ERROR;
 }
 
 /**
- * @brief Controleer Y-coördinaat binnen scherm
+ * @brief Controleer Y-coördinaat binnen het tekendoel (standaard het scherm)
  * @param y Y-coördinaat
  * @return ERROR_Y1 als fout, anders NO_ERROR
  */
 ErrorCode check_y(int y)
 {
-    if(y < 0 || y >= VGA_DISPLAY_Y)
+    if(y < 0 || y >= raster_doel_hoogte())
         return ERROR_Y1;
     return NO_ERROR;
 }
@@ -262,14 +332,26 @@ ErrorCode check_lijn_op_scherm(int x1, int y1, int x2, int y2, int dikte)
     minY -= half;
     maxY += half;
 
-    if(minX < 0 || maxX >= VGA_DISPLAY_X)
+    if(minX < 0 || maxX >= raster_doel_breedte())
         return ERROR_X1;
-    if(minY < 0 || maxY >= VGA_DISPLAY_Y)
+    if(minY < 0 || maxY >= raster_doel_hoogte())
         return ERROR_Y1;
 
     return NO_ERROR;
 }
 
+/**
+ * @brief Controleer de vorm van de lijnuiteinden
+ * @param kap RASTER_KAP_VIERKANT, RASTER_KAP_ROND of RASTER_KAP_PLAT
+ * @return ERROR_KAP bij fout, anders NO_ERROR
+ */
+ErrorCode check_kap(int kap)
+{
+    if(kap != RASTER_KAP_VIERKANT && kap != RASTER_KAP_ROND && kap != RASTER_KAP_PLAT)
+        return ERROR_KAP;
+    return NO_ERROR;
+}
+
 /**
  * @brief Controleer breedte van rechthoek binnen scherm
  * @param x Linker X-coördinaat
@@ -280,7 +362,7 @@ ErrorCode check_breedte(int x, int breedte)
 {
     if(breedte < 1)
         return ERROR_BREEDTE;
-    if(x < 0 || x + breedte - 1 >= VGA_DISPLAY_X)
+    if(x < 0 || x + breedte - 1 >= raster_doel_breedte())
         return ERROR_BREEDTE;
     return NO_ERROR;
 }
@@ -295,7 +377,7 @@ ErrorCode check_hoogte(int y, int hoogte)
 {
     if(hoogte < 1)
         return ERROR_HOOGTE;
-    if(y < 0 || y + hoogte - 1 >= VGA_DISPLAY_Y)
+    if(y < 0 || y + hoogte - 1 >= raster_doel_hoogte())
         return ERROR_HOOGTE;
     return NO_ERROR;
 }
@@ -323,13 +405,29 @@ ErrorCode check_radius_op_scherm(int x, int y, int radius)
 {
     if(radius < 1)
         return ERROR_RADIUS_TOO_SMALL;
-    if(x - radius < 0 || x + radius >= VGA_DISPLAY_X)
+    if(x - radius < 0 || x + radius >= raster_doel_breedte())
         return ERROR_X1;
-    if(y - radius < 0 || y + radius >= VGA_DISPLAY_Y)
+    if(y - radius < 0 || y + radius >= raster_doel_hoogte())
         return ERROR_Y1;
     return NO_ERROR;
 }
 
+/**
+ * @brief Controleer dikte van een cirkelring
+ * @param radius Radius van cirkel
+ * @param dikte Dikte van de ring naar binnen
+ * @return ERROR_DIJKTE_TOO_SMALL bij dikte kleiner dan 1,
+ *         ERROR_RADIUS_TOO_SMALL als de ring dikker is dan de radius, anders NO_ERROR
+ */
+ErrorCode check_cirkel_dikte(int radius, int dikte)
+{
+    if(dikte < 1)
+        return ERROR_DIJKTE_TOO_SMALL;
+    if(dikte > radius)
+        return ERROR_RADIUS_TOO_SMALL;
+    return NO_ERROR;
+}
+
 /**
  * @brief Controleer bitmap nummer en positie binnen scherm
  * @param nr Bitmap nummer
@@ -365,9 +463,9 @@ ErrorCode check_nr(int nr, int x, int y)
             return ERROR_bitmap_nr;
     }
 
-    if(x < 0 || x + grootte - 1 >= VGA_DISPLAY_X)
+    if(x < 0 || x + grootte - 1 >= raster_doel_breedte())
         return ERROR_bitmap_buiten_scherm;
-    if(y < 0 || y + grootte - 1 >= VGA_DISPLAY_Y)
+    if(y < 0 || y + grootte - 1 >= raster_doel_hoogte())
         return ERROR_bitmap_buiten_scherm;
 
     return NO_ERROR;
@@ -385,6 +483,102 @@ ErrorCode wacht_error(int ms)
     return NO_ERROR;
 }
 
+/**
+ * @brief Controleer aantal frames van wachtframe-functie (1-600, max. 10 s)
+ * @param frames Aantal frames
+ * @return FRAMES_NOT_IN_RANGE bij fout, anders NO_ERROR
+ */
+ErrorCode wachtframe_error(int frames)
+{
+    if(frames < 1 || frames > 600)
+        return FRAMES_NOT_IN_RANGE;
+    return NO_ERROR;
+}
+
+/**
+ * @brief Controleer aan/uit-waarde (0 of 1)
+ * @param aan Waarde
+ * @return ERROR_AAN_UIT bij fout, anders NO_ERROR
+ */
+ErrorCode check_aan_uit(int aan)
+{
+    if(aan != 0 && aan != 1)
+        return ERROR_AAN_UIT;
+    return NO_ERROR;
+}
+
+/**
+ * @brief Controleer of er een videomodus met deze breedte is
+ * @param breedte Breedte in pixels (bijv. 320 of 160)
+ * @return ERROR_MODUS bij fout, anders NO_ERROR
+ */
+ErrorCode check_modus(int breedte)
+{
+    if(breedte < 1 || breedte > 0xFFFF)
+        return ERROR_MODUS;
+    if(UB_VGA_FindMode((uint16_t)breedte) < 0)
+        return ERROR_MODUS;
+    return NO_ERROR;
+}
+
+/**
+ * @brief Controleer aantal regels om te scrollen
+ *
+ * Geldig is 1 t/m hoogte-1 omhoog of -1 t/m -(hoogte-1) omlaag, en alleen
+ * in een modus met framebuffer-ring (VGA_HAS_SCROLL).
+ *
+ * @param regels Aantal regels
+ * @return ERROR_SCROLL bij fout, anders NO_ERROR
+ */
+ErrorCode check_scroll(int regels)
+{
+    if(!VGA_HAS_SCROLL)
+        return ERROR_SCROLL;
+    if(regels == 0 || regels >= scherm_hoogte() || regels <= -scherm_hoogte())
+        return ERROR_SCROLL;
+    return NO_ERROR;
+}
+
+/**
+ * @brief Controleer of het tekendoel rechthoeken kan kopiëren
+ *
+ * Een surface in geheugen kan dat altijd, het scherm alleen in een modus
+ * met 8-bit framebuffer (VGA_HAS_COPY). De grenzen controleren
+ * check_breedte() en check_hoogte() met de maat van het tekendoel.
+ *
+ * @return ERROR_KOPIEER bij fout, anders NO_ERROR
+ */
+ErrorCode check_kopieer(void)
+{
+    if(raster_doel()->formaat == SURFACE_SCHERM && !VGA_HAS_COPY)
+        return ERROR_KOPIEER;
+    return NO_ERROR;
+}
+
+/**
+ * @brief Controleer het aantal punten van een veelhoek
+ * @param aantal Aantal punten
+ * @return ERROR_PUNTEN bij minder dan 3 of meer dan RASTER_MAX_PUNTEN, anders NO_ERROR
+ */
+ErrorCode check_aantal_punten(int aantal)
+{
+    if(aantal < 3 || aantal > RASTER_MAX_PUNTEN)
+        return ERROR_PUNTEN;
+    return NO_ERROR;
+}
+
+/**
+ * @brief Controleer de vulling van een veelhoek
+ * @param vulling RASTER_VUL_RAND, RASTER_VUL_EVEN_ONEVEN of RASTER_VUL_NIET_NUL
+ * @return ERROR_GEVULD bij fout, anders NO_ERROR
+ */
+ErrorCode check_vulling(int vulling)
+{
+    if(vulling != RASTER_VUL_RAND && vulling != RASTER_VUL_NIET_NUL && vulling != RASTER_VUL_EVEN_ONEVEN)
+        return ERROR_GEVULD;
+    return NO_ERROR;
+}
+
 /**
  * @brief Controleer of herhaal aantal geldig is (1-20)
  * @param aantal Aantal herhalingen
@@ -420,9 +614,9 @@ ErrorCode check_grootte_op_scherm(int x, int y, int grootte)
 {
     if(grootte < 1)
         return ERROR_GROOTTE_TOO_SMALL;
-    if(x + grootte - 1 >= VGA_DISPLAY_X)
+    if(x + grootte - 1 >= raster_doel_breedte())
         return ERROR_X1;
-    if(y + grootte - 1 >= VGA_DISPLAY_Y)
+    if(y + grootte - 1 >= raster_doel_hoogte())
         return ERROR_Y1;
     return NO_ERROR;
 }
@@ -450,9 +644,9 @@ ErrorCode check_toren_op_scherm(int x, int y, int grootte)
     int y_mast_top_pixel = y_toren_top_pixel - mast_hoogte;
     int y_bodem_pixel = y + basis_radius;
 
-    if(x - basis_radius < 0 || x + basis_radius >= VGA_DISPLAY_X)
+    if(x - basis_radius < 0 || x + basis_radius >= raster_doel_breedte())
         return ERROR_TOREN_BUITEN_SCHERM;
-    if(y_mast_top_pixel < 0 || y_bodem_pixel >= VGA_DISPLAY_Y)
+    if(y_mast_top_pixel < 0 || y_bodem_pixel >= raster_doel_hoogte())
         return ERROR_TOREN_BUITEN_SCHERM;
 
     return NO_ERROR;
@@ -537,14 +731,14 @@ ErrorCode check_tekst_op_scherm(int x, int y, const char* tekst_str, int schaal_
         char_width += schaal_factor;
 
         // Wrap naar nieuwe regel als we rechtsrand bereiken
-        if(current_x + char_width > VGA_DISPLAY_X)
+        if(current_x + char_width > raster_doel_breedte())
         {
             current_x = 0;
             current_y += BASE_FONT_SIZE * schaal_factor + schaal_factor;
         }
 
         // Check of we niet onder de Y-rand komen
-        if(current_y + BASE_FONT_SIZE * schaal_factor > VGA_DISPLAY_Y)
+        if(current_y + BASE_FONT_SIZE * schaal_factor > raster_doel_hoogte())
             return ERROR_HOOGTE; // Tekst past niet op scherm
 
         current_x += char_width;
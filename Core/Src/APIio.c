@@ -14,16 +14,17 @@
 #include "APIerror.h"
 #include "logicLayer.h"
 #include "APIdraw.h"
+#include "APIraster.h"
 
 
-// Globalen voor command buffer en history
-uint16_t command_buffer[MAX_COMMAND_BUFFER_SIZE];
+// Globalen voor command buffer en history (in CCM RAM, geen DMA)
+uint16_t command_buffer[MAX_COMMAND_BUFFER_SIZE] VGA_CCMRAM;
 uint16_t command_buffer_index = 0;
 volatile uint32_t ms_tick_counter = 0;
 int herhaal_hoog = 0;
-static uint8_t cmd_starts[MAX_COMMAND_HISTORY_SIZE];
+static uint8_t cmd_starts[MAX_COMMAND_HISTORY_SIZE] VGA_CCMRAM;
 static uint8_t cmd_start_count = 0;
-static char tekst_historie[MAX_TEKST_HISTORY][MAX_WOORD];
+static char tekst_historie[MAX_TEKST_HISTORY][MAX_WOORD] VGA_CCMRAM;
 static int tekst_historie_index = 0;
 
 
@@ -39,6 +40,7 @@ void API_init_io(void)
 {
     UB_VGA_Screen_Init();
     SysTick_Init();
+    DWT_Init();
 }
 
 /**
@@ -72,8 +74,8 @@ ErrorList clearscherm(const char *kleur)
         ik_heb_geactiveerd = 1;
     }
 
-    /* Scherm vullen */
-    UB_VGA_FillScreen(color);
+    /* Tekendoel vullen (standaard het scherm) */
+    raster_rechthoek(0, 0, raster_doel_breedte(), raster_doel_hoogte(), color, 1);
 
     /* Herhaalstatus resetten */
     if (ik_heb_geactiveerd)
@@ -85,7 +87,7 @@ ErrorList clearscherm(const char *kleur)
 /**
  * @brief Tekent een pixel op het VGA-scherm.
  *
- * Wrapt UB_VGA_SetPixel() en valideert alle parameters via
+ * Wrapt raster_pixel() en valideert alle parameters via
  * Error_handling(). Bij ongeldige invoer worden fouten geretourneerd.
  *
  * @param x X-coördinaat van de pixel
@@ -117,7 +119,7 @@ ErrorList drawPixel(int x, int y, const char *kleur)
     }
 
     /* Pixel tekenen */
-    UB_VGA_SetPixel(x, y, color);
+    raster_pixel(x, y, color);
 
     /* Herhaalstatus resetten */
     if (ik_heb_geactiveerd)
@@ -129,7 +131,7 @@ ErrorList drawPixel(int x, int y, const char *kleur)
 /**
  * @brief Tekent een pixel op het VGA-scherm.
  *
- * Wrapt UB_VGA_SetPixel() en valideert alle parameters via Error_handling().
+ * Wrapt raster_pixel() en valideert alle parameters via Error_handling().
  * Bij ongeldige invoer worden fouten geretourneerd, anders wordt de pixel gezet.
  *
  * @param x     X-coördinaat van de pixel
@@ -148,7 +150,7 @@ ErrorList setPixel(int x, int y, int kleur)
         return errors;
 
     /* Pixel tekenen */
-    UB_VGA_SetPixel(x, y, kleur);
+    raster_pixel(x, y, (uint8_t)kleur);
 
     return errors;
 }
@@ -206,6 +208,49 @@ void SysTick_Init(void)
                     SysTick_CTRL_ENABLE_Msk;
 }
 
+/**
+ * @brief Zet de DWT cyclusteller aan.
+ *
+ * De teller loopt op SystemCoreClock en wordt gebruikt om de
+ * doorvoer van de rasterroutines in cycli te meten.
+ */
+void DWT_Init(void)
+{
+    DEMCR_REG      |= DEMCR_TRCENA;
+    DWT_CYCCNT_REG  = 0;
+    DWT_CTRL_REG   |= DWT_CYCCNTENA;
+}
+
+/**
+ * @brief Maakt de getekende buffer zichtbaar.
+ *
+ * Wacht in de 4bpp-modus maximaal één frame (16,7 ms) op de wissel
+ * als wachten 1 is.
+ *
+ * @param wachten 1 = blokkerend, 0 = niet-blokkerend
+ */
+void toon_scherm(int wachten)
+{
+#if VGA_USE_4BPP
+    /* Uitgestelde opdrachten horen bij dit beeld */
+    raster_wachtrij_leeg();
+#endif
+    if (wachten)
+        UB_VGA_Present();
+    else
+        UB_VGA_PresentAsync();
+}
+
+/**
+ * @brief Geeft het aantal frames sinds de start van de VGA-driver.
+ *
+ * @return uint32_t Aantal frames
+ */
+uint32_t frameteller(void)
+{
+    return UB_VGA_GetFrameCount();
+}
+
 /**
  * @brief SysTick Interrupt Service Routine (ISR)
  *
@@ -248,6 +293,49 @@ ErrorList wacht(int ms)
     eindtijd = ms_tick_counter + ms;
     while (ms_tick_counter < eindtijd)
     {
+        raster_wachtrij_verwerk(RASTER_VBLANK_BUDGET);
+        __WFI();
+    }
+
+    /* Herhaalstatus resetten */
+    if (ik_heb_geactiveerd)
+        herhaal_hoog = 0;
+
+    return errors;
+}
+
+/**
+ * @brief Wacht een aantal frames op de VGA-frameteller.
+ *
+ * Gebruikt WFI; de TIM2 interrupt van de VGA-driver maakt de CPU
+ * elke lijn wakker.
+ *
+ * @param frames Aantal frames
+ * @return ErrorList Struct met foutstatus van input-validatie
+ */
+ErrorList wachtframe(int frames)
+{
+    ErrorList errors;
+    int ik_heb_geactiveerd = 0;
+    uint32_t start;
+
+    errors = Error_handling(FUNC_wachtframe, frames, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    if (errors.error_var1)
+        return errors;
+
+    /* Commando opslaan indien nodig */
+    if (herhaal_hoog == 0)
+    {
+        int params[] = {frames};
+        record_command(CMD_WACHTFRAME, 1, params);
+        herhaal_hoog = 1;
+        ik_heb_geactiveerd = 1;
+    }
+
+    start = UB_VGA_GetFrameCount();
+    while ((UB_VGA_GetFrameCount() - start) < (uint32_t)frames)
+    {
+        raster_wachtrij_verwerk(RASTER_VBLANK_BUDGET);
         __WFI();
     }
 
@@ -258,6 +346,111 @@ ErrorList wacht(int ms)
     return errors;
 }
 
+/**
+ * @brief Zet uitgesteld tekenen aan of uit.
+ *
+ * Wordt niet opgenomen in de commando-historie; het is een instelling
+ * en geen tekenopdracht.
+ *
+ * @param aan 1 = aan, 0 = uit
+ * @return ErrorList Struct met foutstatus van input-validatie
+ */
+ErrorList uitgesteld_tekenen(int aan)
+{
+    ErrorList errors;
+
+    errors = Error_handling(FUNC_uitgesteld, aan, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    if (errors.error_var1)
+        return errors;
+
+    raster_uitgesteld(aan);
+
+    return errors;
+}
+
+/**
+ * @brief Kiest de videomodus aan de hand van de breedte.
+ *
+ * Valideert de breedte via Error_handling(). Opdrachten die nog in de
+ * wachtrij staan horen bij de oude modus en worden eerst getekend.
+ * Een instelling, dus niet opgenomen in de historie.
+ *
+ * @param breedte Breedte van de modus in pixels (320 of 160)
+ * @return ErrorList Struct met foutstatus van input-validatie
+ */
+ErrorList scherm_modus(int breedte)
+{
+    ErrorList errors;
+
+    errors = Error_handling(FUNC_modus, breedte, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    if (errors.error_var1)
+        return errors;
+
+    raster_wachtrij_leeg();
+    UB_VGA_SetMode((uint8_t)UB_VGA_FindMode((uint16_t)breedte));
+
+    return errors;
+}
+
+/**
+ * @brief Scrollt het beeld verticaal zonder pixels te verplaatsen.
+ *
+ * Valideert het aantal regels via Error_handling(). De wachtrij van
+ * uitgesteld tekenen wordt eerst afgewerkt, zodat opdrachten van voor
+ * het scrollen mee schuiven. Daarna verschuift UB_VGA_Scroll() de
+ * startregel van de ring en maakt de binnenkomende regels zwart.
+ *
+ * @param regels Aantal regels omhoog (negatief = omlaag)
+ * @return ErrorList Struct met foutstatus van input-validatie
+ */
+ErrorList scherm_scroll(int regels)
+{
+    ErrorList errors;
+    int ik_heb_geactiveerd = 0;
+
+    errors = Error_handling(FUNC_scroll, regels, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    if (errors.error_var1)
+        return errors;
+
+    /* Commando opslaan indien nodig */
+    if (herhaal_hoog == 0)
+    {
+        int params[] = {regels};
+        record_command(CMD_SCROLL, 1, params);
+        herhaal_hoog = 1;
+        ik_heb_geactiveerd = 1;
+    }
+
+    raster_wachtrij_leeg();
+    UB_VGA_Scroll((int16_t)regels, ZWART);
+
+    /* Herhaalstatus resetten */
+    if (ik_heb_geactiveerd)
+        herhaal_hoog = 0;
+
+    return errors;
+}
+
+/**
+ * @brief Geeft de breedte van de actieve videomodus.
+ *
+ * @return int Breedte in pixels
+ */
+int scherm_breedte(void)
+{
+    return UB_VGA_GetMode()->width;
+}
+
+/**
+ * @brief Geeft de hoogte van de actieve videomodus.
+ *
+ * @return int Hoogte in pixels
+ */
+int scherm_hoogte(void)
+{
+    return UB_VGA_GetMode()->height;
+}
+
 /**
  * @brief Slaat een commando en bijbehorende parameters op in de buffer.
  *
@@ -291,6 +484,10 @@ void record_command(COMMANDO_TYPE type, int param_count, const int params[])
         COMMANDO_TYPE oudste_type = (COMMANDO_TYPE)command_buffer[oudste_pos];
         int oudste_omvang = get_command_size(oudste_type);
 
+        /* Een veelhoek heeft een variabele omvang: het aantal punten staat na het ID */
+        if (oudste_type == CMD_VEELHOEK)
+            oudste_omvang = 4 + 2 * command_buffer[oudste_pos + 1];
+
         if (oudste_omvang <= 0 || oudste_omvang > command_buffer_index)
             oudste_omvang = 1;
 
@@ -341,14 +538,18 @@ int get_command_size(COMMANDO_TYPE type)
     {
         case CMD_CLEAR:      return 2;
         case CMD_WACHT:      return 2;
+        case CMD_WACHTFRAME: return 2;
+        case CMD_SCROLL:     return 2;
         case CMD_SETPIXEL:   return 4;
-        case CMD_LIJN:       return 7;
+        case CMD_LIJN:       return 8;
         case CMD_RECHTHOEK:  return 7;
-        case CMD_CIRKEL:     return 5;
+        case CMD_KOPIEER:    return 7;
+        case CMD_CIRKEL:     return 7;
         case CMD_TOREN:      return 6;
         case CMD_FIGUUR:     return 12;
         case CMD_TEKST:      return 8;
         case CMD_BITMAP:     return 4;
+        case CMD_VEELHOEK:   return 4;  // plus 2 per punt, zie record_command()
         default:             return 0;  // Onbekend of CMD_ONBEKEND/CMD_HERHAAL
     }
 }
@@ -418,11 +619,20 @@ ErrorList herhaal(int aantal, int hoevaak)
                     wacht(command_buffer[pos + 1]);
                     break;
 
+                case CMD_WACHTFRAME:
+                    wachtframe(command_buffer[pos + 1]);
+                    break;
+
+                case CMD_SCROLL:
+                    /* negatief aantal staat als uint16_t in de buffer */
+                    scherm_scroll((int16_t)command_buffer[pos + 1]);
+                    break;
+
                 case CMD_LIJN:
                     lijn(command_buffer[pos + 1], command_buffer[pos + 2],
                          command_buffer[pos + 3], command_buffer[pos + 4],
                          get_color_string_from_code(command_buffer[pos + 5]),
-                         command_buffer[pos + 6]);
+                         command_buffer[pos + 6], command_buffer[pos + 7]);
                     break;
 
                 case CMD_RECHTHOEK:
@@ -432,10 +642,17 @@ ErrorList herhaal(int aantal, int hoevaak)
                               command_buffer[pos + 6]);
                     break;
 
+                case CMD_KOPIEER:
+                    kopieer(command_buffer[pos + 1], command_buffer[pos + 2],
+                            command_buffer[pos + 3], command_buffer[pos + 4],
+                            command_buffer[pos + 5], command_buffer[pos + 6]);
+                    break;
+
                 case CMD_CIRKEL:
                     cirkel(command_buffer[pos + 1], command_buffer[pos + 2],
                            command_buffer[pos + 3],
-                           get_color_string_from_code(command_buffer[pos + 4]));
+                           get_color_string_from_code(command_buffer[pos + 4]),
+                           command_buffer[pos + 5], command_buffer[pos + 6]);
                     break;
 
                 case CMD_TOREN:
@@ -449,6 +666,19 @@ ErrorList herhaal(int aantal, int hoevaak)
                     bitMap(command_buffer[pos + 1], command_buffer[pos + 2], command_buffer[pos + 3]);
                     break;
 
+                case CMD_VEELHOEK:
+                {
+                    int punten[2 * RASTER_MAX_PUNTEN];
+                    int n = command_buffer[pos + 1];
+
+                    for (int k = 0; k < 2 * n; k++)
+                        punten[k] = command_buffer[pos + 4 + k];
+
+                    veelhoek(punten, n, get_color_string_from_code(command_buffer[pos + 2]),
+                             command_buffer[pos + 3]);
+                }
+                break;
+
                 case CMD_TEKST:
                 {
                     int tekst_idx = command_buffer[pos + 4];
@@ -0,0 +1,1584 @@
+/**
+ * @file APIraster.c
+ * @brief Rasterlaag: zet gevalideerde tekenopdrachten om naar pixels.
+ *
+ * De publieke API-functies in APIdraw.c zetten de kleur één keer om,
+ * valideren één keer en roepen daarna deze laag aan. Hierdoor gaat een
+ * pixel niet meer door kleur_omzetter(), Error_handling() en
+ * record_command(), maar direct naar de VGA-driver.
+ *
+ * In de uitgestelde modus (raster_uitgesteld()) worden de opdrachten eerst
+ * in een wachtrij gezet en pas tijdens de verticale blanking getekend, zie
+ * raster_wachtrij_verwerk().
+ *
+ * Met VGA_USE_DLIST is er geen framebuffer: lijnen, rechthoeken, cirkels,
+ * karakters en bitmaps worden één item in de display-lijst van de driver
+ * (VGA_DList) en pas per scanlijn getekend. De wachtrij is dan niet nodig,
+ * de lijst wisselt zelf alleen tussen twee frames.
+ *
+ * Met VGA_USE_TEXT schrijft raster_karakter() alleen de tekencel onder
+ * (x, y); de driver tekent de pixels pas tijdens het uitsturen.
+ *
+ * Alle raster-functies tekenen in het huidige tekendoel (raster_zet_doel()).
+ * Standaard is dat het scherm; een Surface in geheugen wordt direct en
+ * geclipt beschreven, zonder wachtrij, display-lijst of tekstcellen.
+ *
+ * @author Thijs, Joost, Luc
+ * @version 1.0
+ * @date 2026-01-20
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "APIraster.h"
+#include "APIdraw.h"
+#include "APIio.h"
+#include "bitMap.h"
+#include "stm32_ub_vga_screen.h"
+
+
+/**
+ * @brief Soorten opdrachten in de wachtrij.
+ */
+typedef enum
+{
+    OP_PIXEL     = 0,
+    OP_LIJN      = 1,
+    OP_RECHTHOEK = 2,
+    OP_CIRKEL    = 3,
+    OP_KARAKTER  = 4,
+    OP_BITMAP    = 5,
+    OP_KOPIEER   = 6,
+    OP_BLIT      = 7,
+    OP_RING      = 8,
+    OP_VEELHOEK  = 9,
+} RasterOp;
+
+/** @brief Vlaggen van een opdracht */
+#define VLAG_GEVULD     0x01
+#define VLAG_VET        0x02
+#define VLAG_CURSIEF    0x04
+#define VLAG_TRANSPARANT 0x08
+
+/**
+ * @brief Eén uitgestelde opdracht.
+ *
+ * p[] bevat de coördinaten en maten in de volgorde van de raster-functie.
+ */
+typedef struct
+{
+    uint8_t op;
+    uint8_t color;
+    uint8_t karakter;
+    uint8_t vlaggen;
+    int16_t p[6];
+    const void *data;  /**< font, bitmap of surface */
+} RasterOpdracht;
+
+static RasterOpdracht wachtrij[RASTER_WACHTRIJ_GROOTTE] VGA_CCMRAM;
+/** @brief Hoekpunten van een gevulde veelhoek, één rij per plaats in de wachtrij */
+static int16_t wachtrij_punten[RASTER_WACHTRIJ_GROOTTE][2 * RASTER_MAX_PUNTEN] VGA_CCMRAM;
+static uint8_t wachtrij_kop = 0;
+static uint8_t wachtrij_aantal = 0;
+static uint8_t uitgesteld = 0;
+
+/** @brief Het scherm als tekendoel; breedte en hoogte volgen de videomodus */
+static Surface scherm = { NULL, 0, 0, 0, SURFACE_SCHERM };
+static const Surface *doel = &scherm;
+
+/** @brief 1 = er wordt in het scherm getekend (via de VGA-driver) */
+#define DOEL_IS_SCHERM()  (doel->formaat == SURFACE_SCHERM)
+
+static void zet_pixel(int x, int y, uint8_t color);
+static void zet_pixel_clip(int x, int y, uint8_t color);
+static void vul_rechthoek(int x, int y, int w, int h, uint8_t color);
+static void kopieer_rechthoek(int x, int y, int w, int h, int doel_x, int doel_y);
+static void blit_rijen(const Surface *bron, int x, int y, int rij, int aantal, int transparant);
+VGA_RAMFUNC static void teken_lijn(int x1, int y1, int x2, int y2, uint8_t color, int dikte, int kap);
+static void teken_balk(int x1, int y1, int x2, int y2, uint8_t color, int dikte, int kap);
+static int beperk_span(int a, int c_min, int c_max, int *lo, int *hi);
+static uint32_t wortel(uint64_t n);
+static void teken_rechthoek(int x, int y, int w, int h, uint8_t color, int gevuld);
+static void teken_cirkel(int x0, int y0, int radius, uint8_t color);
+static void teken_ring(int x0, int y0, int radius, int dikte, uint8_t color, int van, int tot);
+static void teken_veelhoek(const int16_t *punten, int aantal, uint8_t color, int vulling, int van, int tot);
+static void teken_karakter(int x, int y, unsigned char karakter, const unsigned char *font,
+                           int schaal, int is_vet, int is_cursief, uint8_t color);
+static RasterOpdracht *nieuwe_opdracht(RasterOp op, uint8_t color);
+static int voer_opdracht_uit(RasterOpdracht *o);
+
+
+/**
+ * @brief Zet één pixel zonder controle, of zet hem in de wachtrij.
+ *
+ * @param x X-coördinaat
+ * @param y Y-coördinaat
+ * @param color VGA-kleurcode
+ */
+void raster_pixel(int x, int y, uint8_t color)
+{
+    if (uitgesteld && DOEL_IS_SCHERM())
+    {
+        RasterOpdracht *o = nieuwe_opdracht(OP_PIXEL, color);
+        o->p[0] = (int16_t)x;
+        o->p[1] = (int16_t)y;
+        return;
+    }
+
+    zet_pixel(x, y, color);
+}
+
+/**
+ * @brief Zet één pixel, pixels buiten het tekendoel worden overgeslagen.
+ *
+ * @param x X-coördinaat
+ * @param y Y-coördinaat
+ * @param color VGA-kleurcode
+ */
+void raster_pixel_clip(int x, int y, uint8_t color)
+{
+    if (x < 0 || x >= raster_doel_breedte() || y < 0 || y >= raster_doel_hoogte())
+        return;
+
+    raster_pixel(x, y, color);
+}
+
+/**
+ * @brief Rastert een lijn, of zet hem in de wachtrij (uitgestelde modus).
+ *
+ * @param x1 Begin x-coördinaat
+ * @param y1 Begin y-coördinaat
+ * @param x2 Eind x-coördinaat
+ * @param y2 Eind y-coördinaat
+ * @param color VGA-kleurcode
+ * @param dikte Dikte in pixels
+ * @param kap Vorm van de uiteinden (RASTER_KAP_...)
+ */
+void raster_lijn(int x1, int y1, int x2, int y2, uint8_t color, int dikte, int kap)
+{
+#if VGA_USE_DLIST
+    if (DOEL_IS_SCHERM())
+    {
+        (void)kap;
+        UB_VGA_DListLine(&VGA_DList, x1, y1, x2, y2, color, (uint8_t)dikte);
+        return;
+    }
+#endif
+
+    if (uitgesteld && DOEL_IS_SCHERM())
+    {
+        RasterOpdracht *o = nieuwe_opdracht(OP_LIJN, color);
+        o->p[0] = (int16_t)x1;
+        o->p[1] = (int16_t)y1;
+        o->p[2] = (int16_t)x2;
+        o->p[3] = (int16_t)y2;
+        o->p[4] = (int16_t)dikte;
+        o->p[5] = (int16_t)kap;
+        return;
+    }
+
+    teken_lijn(x1, y1, x2, y2, color, dikte, kap);
+}
+
+/**
+ * @brief Rastert een rechthoek, of zet hem in de wachtrij (uitgestelde modus).
+ *
+ * @param x X-coördinaat linker bovenhoek
+ * @param y Y-coördinaat linker bovenhoek
+ * @param w Breedte in pixels
+ * @param h Hoogte in pixels
+ * @param color VGA-kleurcode
+ * @param gevuld 1 = gevuld, 0 = alleen rand
+ */
+void raster_rechthoek(int x, int y, int w, int h, uint8_t color, int gevuld)
+{
+#if VGA_USE_DLIST
+    if (DOEL_IS_SCHERM())
+    {
+        UB_VGA_DListRect(&VGA_DList, x, y, w, h, color, gevuld ? 1 : 0);
+        return;
+    }
+#endif
+
+    if (uitgesteld && DOEL_IS_SCHERM())
+    {
+        RasterOpdracht *o = nieuwe_opdracht(OP_RECHTHOEK, color);
+        o->p[0] = (int16_t)x;
+        o->p[1] = (int16_t)y;
+        o->p[2] = (int16_t)w;
+        o->p[3] = (int16_t)h;
+        o->vlaggen = gevuld ? VLAG_GEVULD : 0;
+        return;
+    }
+
+    teken_rechthoek(x, y, w, h, color, gevuld);
+}
+
+/**
+ * @brief Rastert een cirkelomtrek, of zet hem in de wachtrij (uitgestelde modus).
+ *
+ * @param x0 X-coördinaat middelpunt
+ * @param y0 Y-coördinaat middelpunt
+ * @param radius Straal in pixels
+ * @param color VGA-kleurcode
+ */
+void raster_cirkel(int x0, int y0, int radius, uint8_t color)
+{
+#if VGA_USE_DLIST
+    if (DOEL_IS_SCHERM())
+    {
+        UB_VGA_DListCircle(&VGA_DList, x0, y0, radius, color);
+        return;
+    }
+#endif
+
+    if (uitgesteld && DOEL_IS_SCHERM())
+    {
+        RasterOpdracht *o = nieuwe_opdracht(OP_CIRKEL, color);
+        o->p[0] = (int16_t)x0;
+        o->p[1] = (int16_t)y0;
+        o->p[2] = (int16_t)radius;
+        return;
+    }
+
+    teken_cirkel(x0, y0, radius, color);
+}
+
+/**
+ * @brief Rastert een ring of schijf, of zet hem in de wachtrij (uitgestelde modus).
+ *
+ * @param x0 X-coördinaat middelpunt
+ * @param y0 Y-coördinaat middelpunt
+ * @param radius Buitenstraal in pixels
+ * @param dikte Dikte van de ring in pixels, radius of meer = gevulde schijf
+ * @param color VGA-kleurcode
+ */
+void raster_ring(int x0, int y0, int radius, int dikte, uint8_t color)
+{
+#if VGA_USE_DLIST
+    if (DOEL_IS_SCHERM())
+    {
+        /* de display-lijst kent geen ringen: alleen de buitenrand */
+        (void)dikte;
+        UB_VGA_DListCircle(&VGA_DList, x0, y0, radius, color);
+        return;
+    }
+#endif
+
+    if (uitgesteld && DOEL_IS_SCHERM())
+    {
+        RasterOpdracht *o = nieuwe_opdracht(OP_RING, color);
+        o->p[0] = (int16_t)x0;
+        o->p[1] = (int16_t)y0;
+        o->p[2] = (int16_t)radius;
+        o->p[3] = (int16_t)dikte;
+        o->p[4] = 0;
+        return;
+    }
+
+    teken_ring(x0, y0, radius, dikte, color, 0, radius);
+}
+
+/**
+ * @brief Rastert een veelhoek, of zet de vulling in de wachtrij (uitgestelde modus).
+ *
+ * @param punten x- en y-coördinaten om en om
+ * @param aantal Aantal punten
+ * @param color VGA-kleurcode
+ * @param vulling RASTER_VUL_RAND, RASTER_VUL_EVEN_ONEVEN of RASTER_VUL_NIET_NUL
+ */
+void raster_veelhoek(const int *punten, int aantal, uint8_t color, int vulling)
+{
+    if (aantal < 1 || aantal > RASTER_MAX_PUNTEN)
+        return;
+
+#if VGA_USE_DLIST
+    /* de display-lijst kent geen veelhoeken: alleen de rand */
+    if (DOEL_IS_SCHERM())
+        vulling = RASTER_VUL_RAND;
+#endif
+
+    if (vulling != RASTER_VUL_RAND)
+    {
+        int16_t lokaal[2 * RASTER_MAX_PUNTEN];
+        int16_t *kopie = lokaal;
+        int boven = punten[1];
+        int onder = punten[1];
+        RasterOpdracht *o = NULL;
+
+        if (uitgesteld && DOEL_IS_SCHERM())
+        {
+            /* De punten gaan mee in de eigen rij van deze plaats in de wachtrij */
+            o = nieuwe_opdracht(OP_VEELHOEK, color);
+            kopie = wachtrij_punten[o - wachtrij];
+        }
+
+        for (int i = 0; i < aantal; i++)
+        {
+            kopie[2 * i] = (int16_t)punten[2 * i];
+            kopie[2 * i + 1] = (int16_t)punten[2 * i + 1];
+            if (punten[2 * i + 1] < boven) boven = punten[2 * i + 1];
+            if (punten[2 * i + 1] > onder) onder = punten[2 * i + 1];
+        }
+
+        if (o != NULL)
+        {
+            o->p[0] = (int16_t)aantal;
+            o->p[1] = (int16_t)vulling;
+            o->p[2] = (int16_t)boven;
+            o->p[3] = (int16_t)onder;
+            o->data = kopie;
+        }
+        else
+        {
+            teken_veelhoek(kopie, aantal, color, vulling, boven, onder);
+        }
+    }
+
+    /* De rand; in de uitgestelde modus volgen de lijnen de vulling in de wachtrij */
+    for (int i = 0; i < aantal; i++)
+    {
+        int j = (i + 1 < aantal) ? i + 1 : 0;
+
+        raster_lijn(punten[2 * i], punten[2 * i + 1], punten[2 * j], punten[2 * j + 1],
+                    color, 1, RASTER_KAP_VIERKANT);
+    }
+}
+
+/**
+ * @brief Rastert één karakter, of zet het in de wachtrij (uitgestelde modus).
+ *
+ * @param x X-coördinaat linker bovenhoek
+ * @param y Y-coördinaat linker bovenhoek
+ * @param karakter ASCII-code
+ * @param font Fontdata
+ * @param schaal Schaalfactor
+ * @param is_vet 1 = vet
+ * @param is_cursief 1 = cursief
+ * @param color VGA-kleurcode
+ */
+void raster_karakter(int x, int y, unsigned char karakter, const unsigned char *font,
+                     int schaal, int is_vet, int is_cursief, uint8_t color)
+{
+#if VGA_USE_DLIST
+    if (DOEL_IS_SCHERM())
+    {
+        UB_VGA_DListChar(&VGA_DList, x, y, karakter, font, (uint8_t)schaal,
+                         (is_vet ? VGA_DL_BOLD : 0) | (is_cursief ? VGA_DL_ITALIC : 0), color);
+        return;
+    }
+#endif
+#if VGA_USE_TEXT
+    if (DOEL_IS_SCHERM())
+    {
+        /* tekstmodus: het karakter komt in de cel onder (x, y), zonder schaal of stijl */
+        (void)schaal;
+        (void)is_vet;
+        (void)is_cursief;
+        UB_VGA_TextSetFont(font);
+        UB_VGA_TextChar(x / VGA_TEXT_CELL, y / VGA_TEXT_CELL, karakter, color);
+        return;
+    }
+#endif
+
+    if (uitgesteld && DOEL_IS_SCHERM())
+    {
+        RasterOpdracht *o = nieuwe_opdracht(OP_KARAKTER, color);
+        o->p[0] = (int16_t)x;
+        o->p[1] = (int16_t)y;
+        o->p[2] = (int16_t)schaal;
+        o->karakter = karakter;
+        o->vlaggen = (is_vet ? VLAG_VET : 0) | (is_cursief ? VLAG_CURSIEF : 0);
+        o->data = font;
+        return;
+    }
+
+    teken_karakter(x, y, karakter, font, schaal, is_vet, is_cursief, color);
+}
+
+/**
+ * @brief Tekent een bitmap.
+ *
+ * @param x X-coördinaat linker bovenhoek
+ * @param y Y-coördinaat linker bovenhoek
+ * @param bmp Bitmap
+ * @param transparant 1 = kleur 0xFF niet tekenen
+ */
+void raster_bitmap(int x, int y, const Bitmap *bmp, int transparant)
+{
+#if VGA_USE_DLIST
+    if (DOEL_IS_SCHERM())
+    {
+        /* de eerste twee bytes van de data zijn breedte en hoogte */
+        UB_VGA_DListBitmap(&VGA_DList, x, y, bmp->width, bmp->height, bmp->data + 2,
+                           transparant ? VGA_DL_TRANSPARENT : 0);
+        return;
+    }
+#endif
+
+    if (uitgesteld && DOEL_IS_SCHERM())
+    {
+        RasterOpdracht *o = nieuwe_opdracht(OP_BITMAP, 0);
+        o->p[0] = (int16_t)x;
+        o->p[1] = (int16_t)y;
+        o->vlaggen = transparant ? VLAG_TRANSPARANT : 0;
+        o->data = bmp;
+        return;
+    }
+
+    drawBitmap(x, y, bmp, (uint8_t)transparant);
+}
+
+/**
+ * @brief Kopieert een rechthoek, of zet de kopie in de wachtrij (uitgestelde modus).
+ *
+ * In de wachtrij komt de kopie achter de opdrachten die eerder kwamen, zodat
+ * die eerst in de bron staan.
+ *
+ * @param x X-coördinaat linker bovenhoek van de bron
+ * @param y Y-coördinaat linker bovenhoek van de bron
+ * @param w Breedte in pixels
+ * @param h Hoogte in pixels
+ * @param doel_x X-coördinaat linker bovenhoek van het doel
+ * @param doel_y Y-coördinaat linker bovenhoek van het doel
+ */
+void raster_kopieer(int x, int y, int w, int h, int doel_x, int doel_y)
+{
+#if VGA_USE_DLIST
+    if (DOEL_IS_SCHERM())
+    {
+        /* geen framebuffer om uit te kopiëren */
+        return;
+    }
+#endif
+
+    if (uitgesteld && DOEL_IS_SCHERM())
+    {
+        RasterOpdracht *o = nieuwe_opdracht(OP_KOPIEER, 0);
+        o->p[0] = (int16_t)x;
+        o->p[1] = (int16_t)y;
+        o->p[2] = (int16_t)w;
+        o->p[3] = (int16_t)h;
+        o->p[4] = (int16_t)doel_x;
+        o->p[5] = (int16_t)doel_y;
+        return;
+    }
+
+    kopieer_rechthoek(x, y, w, h, doel_x, doel_y);
+}
+
+/**
+ * @brief Kopieert een surface naar het tekendoel, of zet de kopie in de wachtrij.
+ *
+ * In de wachtrij wordt de surface in banden van RASTER_BAND_HOOGTE rijen
+ * gekopieerd; de pixels van bron moeten dan blijven staan tot de wachtrij
+ * leeg is.
+ *
+ * @param bron Surface in geheugen (SURFACE_R3G3B2)
+ * @param x X-coördinaat linker bovenhoek in het tekendoel
+ * @param y Y-coördinaat linker bovenhoek in het tekendoel
+ * @param transparant 1 = kleur 0xFF niet kopiëren
+ */
+void raster_blit(const Surface *bron, int x, int y, int transparant)
+{
+    if (bron == NULL || bron->formaat != SURFACE_R3G3B2 || bron == doel)
+        return;
+
+#if VGA_USE_DLIST
+    if (DOEL_IS_SCHERM())
+    {
+        /* één bitmap-item; dat leest de pixels aaneengesloten */
+        if (bron->pitch == bron->breedte)
+            UB_VGA_DListBitmap(&VGA_DList, x, y, bron->breedte, bron->hoogte, bron->buffer,
+                               transparant ? VGA_DL_TRANSPARENT : 0);
+        return;
+    }
+#endif
+
+    if (uitgesteld && DOEL_IS_SCHERM())
+    {
+        RasterOpdracht *o = nieuwe_opdracht(OP_BLIT, 0);
+        o->p[0] = (int16_t)x;
+        o->p[1] = (int16_t)y;
+        o->p[2] = 0;
+        o->vlaggen = transparant ? VLAG_TRANSPARANT : 0;
+        o->data = bron;
+        return;
+    }
+
+    blit_rijen(bron, x, y, 0, bron->hoogte, transparant);
+}
+
+/**
+ * @brief Beschrijft een blok geheugen als surface.
+ *
+ * @param s Surface om in te vullen
+ * @param buffer Eerste pixel (pitch * hoogte bytes)
+ * @param breedte Breedte in pixels
+ * @param hoogte Hoogte in pixels
+ * @param pitch Bytes van een rij naar de volgende (>= breedte)
+ */
+void surface_init(Surface *s, uint8_t *buffer, int breedte, int hoogte, int pitch)
+{
+    s->buffer = buffer;
+    s->breedte = (int16_t)breedte;
+    s->hoogte = (int16_t)hoogte;
+    s->pitch = (int16_t)((pitch < breedte) ? breedte : pitch);
+    s->formaat = SURFACE_R3G3B2;
+}
+
+/**
+ * @brief Kiest het tekendoel van de raster-functies.
+ *
+ * Voordat het scherm wordt verlaten, wordt de wachtrij leeggemaakt: de
+ * opdrachten daarin horen bij het scherm.
+ *
+ * @param s Surface in geheugen, of NULL voor het scherm
+ */
+void raster_zet_doel(const Surface *s)
+{
+    if (s == NULL || s->formaat == SURFACE_SCHERM)
+        s = &scherm;
+
+    if (s != &scherm && DOEL_IS_SCHERM())
+        raster_wachtrij_leeg();
+
+    doel = s;
+}
+
+/**
+ * @brief Geeft het huidige tekendoel.
+ *
+ * @return Surface; voor het scherm met de maten van de videomodus
+ */
+const Surface *raster_doel(void)
+{
+    scherm.breedte = (int16_t)VGA.mode.width;
+    scherm.hoogte = (int16_t)VGA.mode.height;
+    return doel;
+}
+
+/**
+ * @brief Geeft de breedte van het tekendoel.
+ *
+ * @return Breedte in pixels
+ */
+int raster_doel_breedte(void)
+{
+    return DOEL_IS_SCHERM() ? VGA.mode.width : doel->breedte;
+}
+
+/**
+ * @brief Geeft de hoogte van het tekendoel.
+ *
+ * @return Hoogte in pixels
+ */
+int raster_doel_hoogte(void)
+{
+    return DOEL_IS_SCHERM() ? VGA.mode.height : doel->hoogte;
+}
+
+/**
+ * @brief Zet één pixel direct in het tekendoel, buiten het doel wordt overgeslagen.
+ *
+ * Gaat nooit via de wachtrij; bedoeld voor drawBitmap(), dat zelf al
+ * uitgesteld kan worden.
+ *
+ * @param x X-coördinaat
+ * @param y Y-coördinaat
+ * @param color VGA-kleurcode
+ */
+void raster_doel_pixel(int x, int y, uint8_t color)
+{
+    zet_pixel_clip(x, y, color);
+}
+
+/**
+ * @brief Zet de uitgestelde modus aan of uit.
+ *
+ * Bij uitzetten wordt de wachtrij eerst leeggemaakt, verdeeld over
+ * zoveel verticale blankings als nodig.
+ *
+ * @param aan 1 = opdrachten in de wachtrij, 0 = direct tekenen
+ */
+void raster_uitgesteld(int aan)
+{
+    if (!aan)
+        raster_wachtrij_leeg();
+
+    uitgesteld = aan ? 1 : 0;
+}
+
+/**
+ * @brief Geeft terug of de uitgestelde modus aan staat.
+ *
+ * @return 1 = aan, 0 = uit
+ */
+int raster_is_uitgesteld(void)
+{
+    return uitgesteld;
+}
+
+/**
+ * @brief Geeft het aantal opdrachten dat nog in de wachtrij staat.
+ *
+ * @return Aantal opdrachten
+ */
+int raster_wachtrij_aantal(void)
+{
+    return wachtrij_aantal;
+}
+
+/**
+ * @brief Tekent opdrachten uit de wachtrij zolang de straal buiten beeld is.
+ *
+ * Doet niets tijdens de zichtbare lijnen. In de blanking worden opdrachten
+ * uitgevoerd tot het budget op is of de blanking voorbij is; de rest blijft
+ * staan voor de volgende blanking. Gevulde rechthoeken worden per
+ * RASTER_BAND_HOOGTE rijen getekend, zodat ook een volledig scherm over
+ * meerdere blankings verdeeld kan worden.
+ *
+ * @param budget Maximaal aantal CPU-cycli
+ */
+void raster_wachtrij_verwerk(uint32_t budget)
+{
+    uint32_t start;
+
+    if (wachtrij_aantal == 0 || !UB_VGA_InVBlank())
+        return;
+
+    start = DWT_CYCCNT_REG;
+    while (wachtrij_aantal > 0 && UB_VGA_InVBlank() &&
+           (uint32_t)(DWT_CYCCNT_REG - start) < budget)
+    {
+        if (voer_opdracht_uit(&wachtrij[wachtrij_kop]))
+        {
+            wachtrij_kop = (uint8_t)((wachtrij_kop + 1) % RASTER_WACHTRIJ_GROOTTE);
+            wachtrij_aantal--;
+        }
+    }
+}
+
+/**
+ * @brief Wacht tot de wachtrij volledig getekend is.
+ */
+void raster_wachtrij_leeg(void)
+{
+    while (wachtrij_aantal > 0)
+    {
+        UB_VGA_WaitVBlank();
+        raster_wachtrij_verwerk(RASTER_VBLANK_BUDGET);
+    }
+}
+
+/**
+ * @brief Reserveert de volgende plaats in de wachtrij.
+ *
+ * Is de wachtrij vol, dan wordt eerst in de volgende blanking(s)
+ * ruimte gemaakt.
+ *
+ * @param op Soort opdracht
+ * @param color VGA-kleurcode
+ * @return Opdracht om verder in te vullen
+ */
+static RasterOpdracht *nieuwe_opdracht(RasterOp op, uint8_t color)
+{
+    RasterOpdracht *o;
+
+    while (wachtrij_aantal >= RASTER_WACHTRIJ_GROOTTE)
+    {
+        UB_VGA_WaitVBlank();
+        raster_wachtrij_verwerk(RASTER_VBLANK_BUDGET);
+    }
+
+    o = &wachtrij[(wachtrij_kop + wachtrij_aantal) % RASTER_WACHTRIJ_GROOTTE];
+    wachtrij_aantal++;
+
+    o->op = (uint8_t)op;
+    o->color = color;
+    o->vlaggen = 0;
+    o->data = NULL;
+    return o;
+}
+
+/**
+ * @brief Voert (een deel van) één opdracht uit.
+ *
+ * @param o Opdracht
+ * @return 1 = klaar, 0 = er is nog een deel over
+ */
+static int voer_opdracht_uit(RasterOpdracht *o)
+{
+    switch (o->op)
+    {
+        case OP_PIXEL:
+            zet_pixel(o->p[0], o->p[1], o->color);
+            break;
+
+        case OP_LIJN:
+            teken_lijn(o->p[0], o->p[1], o->p[2], o->p[3], o->color, o->p[4], o->p[5]);
+            break;
+
+        case OP_RECHTHOEK:
+            if ((o->vlaggen & VLAG_GEVULD) && o->p[3] > RASTER_BAND_HOOGTE)
+            {
+                /* Bovenste band tekenen, de rest blijft staan */
+                teken_rechthoek(o->p[0], o->p[1], o->p[2], RASTER_BAND_HOOGTE, o->color, 1);
+                o->p[1] += RASTER_BAND_HOOGTE;
+                o->p[3] -= RASTER_BAND_HOOGTE;
+                return 0;
+            }
+            teken_rechthoek(o->p[0], o->p[1], o->p[2], o->p[3], o->color,
+                            (o->vlaggen & VLAG_GEVULD) ? 1 : 0);
+            break;
+
+        case OP_CIRKEL:
+            teken_cirkel(o->p[0], o->p[1], o->p[2], o->color);
+            break;
+
+        case OP_KARAKTER:
+            teken_karakter(o->p[0], o->p[1], o->karakter, (const unsigned char *)o->data,
+                           o->p[2], (o->vlaggen & VLAG_VET) ? 1 : 0,
+                           (o->vlaggen & VLAG_CURSIEF) ? 1 : 0, o->color);
+            break;
+
+        case OP_BITMAP:
+            drawBitmap(o->p[0], o->p[1], (const Bitmap *)o->data,
+                       (o->vlaggen & VLAG_TRANSPARANT) ? 1 : 0);
+            break;
+
+        case OP_KOPIEER:
+            if (o->p[3] > RASTER_BAND_HOOGTE)
+            {
+                if (o->p[5] > o->p[1])
+                {
+                    /* Doel lager: onderste band eerst, de bron erboven blijft heel */
+                    UB_VGA_CopyRect(o->p[0], o->p[1] + o->p[3] - RASTER_BAND_HOOGTE,
+                                    o->p[2], RASTER_BAND_HOOGTE,
+                                    o->p[4], o->p[5] + o->p[3] - RASTER_BAND_HOOGTE);
+                }
+                else
+                {
+                    /* Doel hoger of even hoog: bovenste band eerst */
+                    UB_VGA_CopyRect(o->p[0], o->p[1], o->p[2], RASTER_BAND_HOOGTE,
+                                    o->p[4], o->p[5]);
+                    o->p[1] += RASTER_BAND_HOOGTE;
+                    o->p[5] += RASTER_BAND_HOOGTE;
+                }
+                o->p[3] -= RASTER_BAND_HOOGTE;
+                return 0;
+            }
+            UB_VGA_CopyRect(o->p[0], o->p[1], o->p[2], o->p[3], o->p[4], o->p[5]);
+            break;
+
+        case OP_RING:
+            if (o->p[2] - o->p[4] >= RASTER_BAND_HOOGTE / 2)
+            {
+                /* Rijparen van het midden naar buiten, een band per keer */
+                teken_ring(o->p[0], o->p[1], o->p[2], o->p[3], o->color,
+                           o->p[4], o->p[4] + RASTER_BAND_HOOGTE / 2 - 1);
+                o->p[4] += RASTER_BAND_HOOGTE / 2;
+                return 0;
+            }
+            teken_ring(o->p[0], o->p[1], o->p[2], o->p[3], o->color, o->p[4], o->p[2]);
+            break;
+
+        case OP_VEELHOEK:
+            if (o->p[3] - o->p[2] >= RASTER_BAND_HOOGTE)
+            {
+                /* Bovenste band vullen, de rest blijft staan */
+                teken_veelhoek((const int16_t *)o->data, o->p[0], o->color, o->p[1],
+                               o->p[2], o->p[2] + RASTER_BAND_HOOGTE - 1);
+                o->p[2] += RASTER_BAND_HOOGTE;
+                return 0;
+            }
+            teken_veelhoek((const int16_t *)o->data, o->p[0], o->color, o->p[1], o->p[2], o->p[3]);
+            break;
+
+        case OP_BLIT:
+        {
+            const Surface *bron = (const Surface *)o->data;
+            int rest = bron->hoogte - o->p[2];
+
+            if (rest > RASTER_BAND_HOOGTE)
+            {
+                /* Bovenste band kopiëren, de rest blijft staan */
+                blit_rijen(bron, o->p[0], o->p[1], o->p[2], RASTER_BAND_HOOGTE,
+                           (o->vlaggen & VLAG_TRANSPARANT) ? 1 : 0);
+                o->p[2] += RASTER_BAND_HOOGTE;
+                return 0;
+            }
+            blit_rijen(bron, o->p[0], o->p[1], o->p[2], rest,
+                       (o->vlaggen & VLAG_TRANSPARANT) ? 1 : 0);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Zet één pixel direct in het tekendoel.
+ *
+ * Het scherm wordt niet gecontroleerd (coördinaten zijn al gevalideerd);
+ * in een surface wordt altijd geclipt, zodat er nooit buiten de buffer
+ * geschreven wordt.
+ *
+ * @param x X-coördinaat
+ * @param y Y-coördinaat
+ * @param color VGA-kleurcode
+ */
+static void zet_pixel(int x, int y, uint8_t color)
+{
+    if (DOEL_IS_SCHERM())
+    {
+        UB_VGA_SetPixel((uint16_t)x, (uint16_t)y, color);
+        return;
+    }
+
+    if (x < 0 || x >= doel->breedte || y < 0 || y >= doel->hoogte)
+        return;
+
+    doel->buffer[y * doel->pitch + x] = color;
+}
+
+/**
+ * @brief Zet één pixel direct in het tekendoel, buiten het doel wordt overgeslagen.
+ *
+ * @param x X-coördinaat
+ * @param y Y-coördinaat
+ * @param color VGA-kleurcode
+ */
+static void zet_pixel_clip(int x, int y, uint8_t color)
+{
+    if (x < 0 || x >= raster_doel_breedte() || y < 0 || y >= raster_doel_hoogte())
+        return;
+
+    zet_pixel(x, y, color);
+}
+
+/**
+ * @brief Vult een rechthoek in het tekendoel.
+ *
+ * Het scherm gaat via de span-kernels van de driver, een surface wordt
+ * geclipt en per rij gevuld.
+ *
+ * @param x X-coördinaat linker bovenhoek
+ * @param y Y-coördinaat linker bovenhoek
+ * @param w Breedte in pixels
+ * @param h Hoogte in pixels
+ * @param color VGA-kleurcode
+ */
+static void vul_rechthoek(int x, int y, int w, int h, uint8_t color)
+{
+    if (DOEL_IS_SCHERM())
+    {
+        UB_VGA_FillRect((uint16_t)x, (uint16_t)y, (uint16_t)w, (uint16_t)h, color);
+        return;
+    }
+
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (w > doel->breedte - x) w = doel->breedte - x;
+    if (h > doel->hoogte - y) h = doel->hoogte - y;
+    if (w <= 0 || h <= 0)
+        return;
+
+    for (uint8_t *rij = &doel->buffer[y * doel->pitch + x]; h > 0; h--, rij += doel->pitch)
+        memset(rij, color, (size_t)w);
+}
+
+/**
+ * @brief Kopieert een rechthoek binnen het tekendoel (bron en doel mogen overlappen).
+ *
+ * @param x X-coördinaat linker bovenhoek van de bron
+ * @param y Y-coördinaat linker bovenhoek van de bron
+ * @param w Breedte in pixels
+ * @param h Hoogte in pixels
+ * @param doel_x X-coördinaat linker bovenhoek van het doel
+ * @param doel_y Y-coördinaat linker bovenhoek van het doel
+ */
+static void kopieer_rechthoek(int x, int y, int w, int h, int doel_x, int doel_y)
+{
+    int stap = doel->pitch;
+    uint8_t *van;
+    uint8_t *naar;
+
+    if (DOEL_IS_SCHERM())
+    {
+        UB_VGA_CopyRect((uint16_t)x, (uint16_t)y, (uint16_t)w, (uint16_t)h,
+                        (uint16_t)doel_x, (uint16_t)doel_y);
+        return;
+    }
+
+    /* Zelfde clipping als de driver: rechts en onder, voor beide rechthoeken */
+    if (x < 0 || y < 0 || doel_x < 0 || doel_y < 0 ||
+        x >= doel->breedte || y >= doel->hoogte ||
+        doel_x >= doel->breedte || doel_y >= doel->hoogte)
+        return;
+    if (w > doel->breedte - x) w = doel->breedte - x;
+    if (w > doel->breedte - doel_x) w = doel->breedte - doel_x;
+    if (h > doel->hoogte - y) h = doel->hoogte - y;
+    if (h > doel->hoogte - doel_y) h = doel->hoogte - doel_y;
+    if (w <= 0 || h <= 0)
+        return;
+
+    van = &doel->buffer[y * doel->pitch + x];
+    naar = &doel->buffer[doel_y * doel->pitch + doel_x];
+
+    /* Doel lager: onderaan beginnen, zodat geen bronrij overschreven wordt */
+    if (doel_y > y)
+    {
+        van += (h - 1) * stap;
+        naar += (h - 1) * stap;
+        stap = -stap;
+    }
+
+    for (; h > 0; h--, van += stap, naar += stap)
+        memmove(naar, van, (size_t)w);
+}
+
+/**
+ * @brief Kopieert rijen van een surface naar het tekendoel, geclipt.
+ *
+ * Zonder transparantie gaat een rij in één keer naar het doel; met
+ * transparantie elke reeks pixels die niet 0xFF is.
+ *
+ * @param bron Surface in geheugen
+ * @param x X-coördinaat linker bovenhoek van de surface in het doel
+ * @param y Y-coördinaat linker bovenhoek van de surface in het doel
+ * @param rij Eerste rij van de bron
+ * @param aantal Aantal rijen
+ * @param transparant 1 = kleur 0xFF niet kopiëren
+ */
+static void blit_rijen(const Surface *bron, int x, int y, int rij, int aantal, int transparant)
+{
+    int breedte = raster_doel_breedte();
+    int hoogte = raster_doel_hoogte();
+    int eerste = (x < 0) ? -x : 0;
+    int w = bron->breedte - eerste;
+
+    if (w > breedte - (x + eerste))
+        w = breedte - (x + eerste);
+    if (w <= 0)
+        return;
+
+    for (; aantal > 0; aantal--, rij++)
+    {
+        const uint8_t *van = &bron->buffer[rij * bron->pitch + eerste];
+        int doel_y = y + rij;
+        int n = 0;
+
+        if (doel_y < 0 || doel_y >= hoogte)
+            continue;
+
+        while (n < w)
+        {
+            int begin;
+
+            if (transparant)
+            {
+                while (n < w && van[n] == 0xFF)
+                    n++;
+            }
+            begin = n;
+            if (transparant)
+            {
+                while (n < w && van[n] != 0xFF)
+                    n++;
+            }
+            else
+            {
+                n = w;
+            }
+            if (n == begin)
+                break;
+
+            if (DOEL_IS_SCHERM())
+                UB_VGA_PutRow((uint16_t)(x + eerste + begin), (uint16_t)doel_y,
+                              &van[begin], (uint16_t)(n - begin));
+            else
+                memcpy(&doel->buffer[doel_y * doel->pitch + x + eerste + begin],
+                       &van[begin], (size_t)(n - begin));
+        }
+    }
+}
+
+/**
+ * @brief Rastert een lijn met het Bresenham-algoritme.
+ *
+ * Een dikkere lijn gaat naar teken_balk(). Horizontale en verticale lijnen
+ * met vierkante uiteinden (en een losse punt) worden in één keer als
+ * rechthoek gevuld. Draait vanuit RAM (VGA_RAMFUNC).
+ *
+ * @param x1 Begin x-coördinaat
+ * @param y1 Begin y-coördinaat
+ * @param x2 Eind x-coördinaat
+ * @param y2 Eind y-coördinaat
+ * @param color VGA-kleurcode
+ * @param dikte Dikte in pixels
+ * @param kap Vorm van de uiteinden (RASTER_KAP_...)
+ */
+VGA_RAMFUNC static void teken_lijn(int x1, int y1, int x2, int y2, uint8_t color, int dikte, int kap)
+{
+    int dx = abs(x2 - x1);
+    int dy = -abs(y2 - y1);
+    int sx = (x1 < x2) ? 1 : -1;
+    int sy = (y1 < y2) ? 1 : -1;
+    int err = dx + dy;
+    int e2;
+    int half = dikte / 2;
+
+    /* Rechte lijnen met vierkante uiteinden zijn een rechthoek */
+    if ((y1 == y2 || x1 == x2) &&
+        (dikte <= 1 || kap == RASTER_KAP_VIERKANT || (dx == 0 && dy == 0 && kap != RASTER_KAP_ROND)))
+    {
+        int min_x = (x1 < x2) ? x1 : x2;
+        int min_y = (y1 < y2) ? y1 : y2;
+
+        vul_rechthoek(min_x - half, min_y - half, dx + 2 * half + 1, -dy + 2 * half + 1, color);
+        return;
+    }
+
+    if (dikte > 1)
+    {
+        teken_balk(x1, y1, x2, y2, color, dikte, kap);
+        return;
+    }
+
+    while (1)
+    {
+        zet_pixel(x1, y1, color);
+
+        /* Stop als eindpunt bereikt is */
+        if (x1 == x2 && y1 == y2)
+            break;
+
+        e2 = 2 * err;
+
+        if (e2 >= dy)
+        {
+            err += dy;
+            x1 += sx;
+        }
+
+        if (e2 <= dx)
+        {
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+/**
+ * @brief Rastert een dikke lijn als één span per rij.
+ *
+ * Met D = (dx, dy) de richting, L = |D| en (rx, ry) een pixel ten opzichte
+ * van (x1, y1) ligt de pixel in de balk als
+ *  - |2 (dx * ry - dy * rx)| <= dikte * L (afstand tot de middenlijn), en
+ *  - -k <= 2 (dx * rx + dy * ry) <= 2 L * L + k (positie langs de lijn),
+ *    met k = dikte * L voor vierkante en 0 voor platte en ronde uiteinden.
+ * Een rond uiteinde voegt per eindpunt de schijf 4 (rx * rx + ry * ry) <= dikte * dikte
+ * toe. Alle termen zijn gehele getallen; alleen dikte * L wordt één keer
+ * (naar beneden afgerond) berekend, wat de vergelijking niet verandert.
+ *
+ * De vorm is convex, dus elke rij is één span: de doorsnede van de twee
+ * stroken, samen met de schijven. Elke pixel wordt één keer geschreven.
+ *
+ * @param x1 Begin x-coördinaat
+ * @param y1 Begin y-coördinaat
+ * @param x2 Eind x-coördinaat
+ * @param y2 Eind y-coördinaat
+ * @param color VGA-kleurcode
+ * @param dikte Dikte in pixels (> 1)
+ * @param kap Vorm van de uiteinden (RASTER_KAP_...)
+ */
+static void teken_balk(int x1, int y1, int x2, int y2, uint8_t color, int dikte, int kap)
+{
+    int dx = x2 - x1;
+    int dy = y2 - y1;
+    int lengte2 = dx * dx + dy * dy;
+    int breed = (int)wortel((uint64_t)dikte * (uint64_t)dikte * (uint64_t)lengte2);
+    int verleng = (kap == RASTER_KAP_VIERKANT) ? breed : 0;
+    int eerste = ((y1 < y2) ? y1 : y2) - dikte;
+    int laatste = ((y1 > y2) ? y1 : y2) + dikte;
+
+    /* Een hoek van de balk ligt hooguit dikte / sqrt(2) boven of onder een eindpunt */
+    if (eerste < 0)
+        eerste = 0;
+    if (laatste > raster_doel_hoogte() - 1)
+        laatste = raster_doel_hoogte() - 1;
+
+    for (int y = eerste; y <= laatste; y++)
+    {
+        int ry = y - y1;
+        int lo = -32768;
+        int hi = 32767;
+
+        if (lengte2 == 0 ||
+            !beperk_span(2 * dy, 2 * dx * ry - breed, 2 * dx * ry + breed, &lo, &hi) ||
+            !beperk_span(2 * dx, -verleng - 2 * dy * ry, 2 * lengte2 + verleng - 2 * dy * ry, &lo, &hi))
+        {
+            lo = 1;
+            hi = 0;
+        }
+
+        if (kap == RASTER_KAP_ROND)
+        {
+            for (int eind = 0; eind < 2; eind++)
+            {
+                int cx = (eind == 0) ? 0 : dx;
+                int cy = (eind == 0) ? 0 : dy;
+                int rest = dikte * dikte - 4 * (ry - cy) * (ry - cy);
+                int w;
+
+                if (rest < 0)
+                    continue;
+
+                /* De schijf en de balk overlappen, de vereniging blijft één span */
+                w = (int)wortel((uint64_t)(rest / 4));
+                if (lo > hi)
+                {
+                    lo = cx - w;
+                    hi = cx + w;
+                }
+                else
+                {
+                    if (cx - w < lo) lo = cx - w;
+                    if (cx + w > hi) hi = cx + w;
+                }
+            }
+        }
+
+        if (lo > hi)
+            continue;
+
+        lo += x1;
+        hi += x1;
+        if (lo < 0)
+            lo = 0;
+        if (hi > raster_doel_breedte() - 1)
+            hi = raster_doel_breedte() - 1;
+        if (lo <= hi)
+            vul_rechthoek(lo, y, hi - lo + 1, 1, color);
+    }
+}
+
+/**
+ * @brief Beperkt een span tot de gehele r met c_min <= a * r <= c_max.
+ *
+ * @param a Factor van r
+ * @param c_min Ondergrens
+ * @param c_max Bovengrens
+ * @param lo Ondergrens van de span, wordt zo nodig verhoogd
+ * @param hi Bovengrens van de span, wordt zo nodig verlaagd
+ * @return 0 = de span is leeg, anders 1
+ */
+static int beperk_span(int a, int c_min, int c_max, int *lo, int *hi)
+{
+    int van;
+    int tot;
+
+    if (a == 0)
+        return (c_min <= 0 && c_max >= 0);
+
+    if (a < 0)
+    {
+        int t = c_min;
+
+        a = -a;
+        c_min = -c_max;
+        c_max = -t;
+    }
+
+    /* Naar boven en naar beneden afronden, ook voor negatieve grenzen */
+    van = (c_min >= 0) ? (c_min + a - 1) / a : -((-c_min) / a);
+    tot = (c_max >= 0) ? c_max / a : -((-c_max + a - 1) / a);
+
+    if (van > *lo)
+        *lo = van;
+    if (tot < *hi)
+        *hi = tot;
+
+    return (*lo <= *hi);
+}
+
+/**
+ * @brief Gehele vierkantswortel, naar beneden afgerond.
+ *
+ * @param n Getal
+ * @return De grootste w met w * w <= n
+ */
+static uint32_t wortel(uint64_t n)
+{
+    uint64_t w = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > n)
+        bit >>= 2;
+
+    while (bit != 0)
+    {
+        if (n >= w + bit)
+        {
+            n -= w + bit;
+            w = (w >> 1) + bit;
+        }
+        else
+        {
+            w >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)w;
+}
+
+/**
+ * @brief Rastert een rechthoek met de span-kernels van de VGA-driver of in een surface.
+ *
+ * @param x X-coördinaat linker bovenhoek
+ * @param y Y-coördinaat linker bovenhoek
+ * @param w Breedte in pixels
+ * @param h Hoogte in pixels
+ * @param color VGA-kleurcode
+ * @param gevuld 1 = gevuld, 0 = alleen rand
+ */
+static void teken_rechthoek(int x, int y, int w, int h, uint8_t color, int gevuld)
+{
+    if (gevuld)
+    {
+        vul_rechthoek(x, y, w, h, color);
+        return;
+    }
+
+    if (!DOEL_IS_SCHERM())
+    {
+        vul_rechthoek(x, y, w, 1, color);
+        vul_rechthoek(x, y + h - 1, w, 1, color);
+        vul_rechthoek(x, y, 1, h, color);
+        vul_rechthoek(x + w - 1, y, 1, h, color);
+        return;
+    }
+
+    /* Rand: boven- en onderkant als rij, zijkanten als kolom */
+    UB_VGA_DrawHLine((uint16_t)x, (uint16_t)y, (uint16_t)w, color);
+    UB_VGA_DrawHLine((uint16_t)x, (uint16_t)(y + h - 1), (uint16_t)w, color);
+    UB_VGA_DrawVLine((uint16_t)x, (uint16_t)y, (uint16_t)h, color);
+    UB_VGA_DrawVLine((uint16_t)(x + w - 1), (uint16_t)y, (uint16_t)h, color);
+}
+
+/**
+ * @brief Rastert de omtrek van een cirkel.
+ *
+ * @param x0 X-coördinaat middelpunt
+ * @param y0 Y-coördinaat middelpunt
+ * @param radius Straal in pixels
+ * @param color VGA-kleurcode
+ */
+static void teken_cirkel(int x0, int y0, int radius, uint8_t color)
+{
+    int x = radius;
+    int y = 0;
+    int err = 0;
+
+    while (x >= y)
+    {
+        zet_pixel(x0 + x, y0 + y, color);
+        zet_pixel(x0 + y, y0 + x, color);
+        zet_pixel(x0 - y, y0 + x, color);
+        zet_pixel(x0 - x, y0 + y, color);
+        zet_pixel(x0 - x, y0 - y, color);
+        zet_pixel(x0 - y, y0 - x, color);
+        zet_pixel(x0 + y, y0 - x, color);
+        zet_pixel(x0 + x, y0 - y, color);
+
+        y++;
+
+        if (err <= 0)
+            err += 2 * y + 1;
+
+        if (err > 0)
+        {
+            x--;
+            err -= 2 * x + 1;
+        }
+    }
+}
+
+/**
+ * @brief Rastert een ring of schijf als horizontale spans.
+ *
+ * Een pixel (dx, dy) ligt in de schijf met straal r als
+ * dx * dx + dy * dy <= r * r + r, het midpoint-criterium (afstand tot
+ * r + 0,5); de omtrek van raster_cirkel() valt daar altijd binnen. De
+ * ring is de schijf met straal radius zonder de schijf met straal
+ * radius - dikte. Per rij is dat één span, of twee naast het gat;
+ * elke pixel wordt precies één keer geschreven. Vanaf dikte = radius is
+ * er geen gat: een binnenschijf met straal 0 zou alleen het middelpunt
+ * weglaten.
+ *
+ * De rijen gaan in paren y0 - dy en y0 + dy, met dy van van tot en met
+ * tot. Zo krimpt de halve breedte alleen en volgt hij zonder wortel uit
+ * de vorige rij.
+ *
+ * @param x0 X-coördinaat middelpunt
+ * @param y0 Y-coördinaat middelpunt
+ * @param radius Buitenstraal in pixels
+ * @param dikte Dikte in pixels, radius of meer = geen gat
+ * @param color VGA-kleurcode
+ * @param van Eerste dy (>= 0)
+ * @param tot Laatste dy (<= radius)
+ */
+static void teken_ring(int x0, int y0, int radius, int dikte, uint8_t color, int van, int tot)
+{
+    int binnen = (dikte >= radius) ? -1 : radius - dikte;
+    int grens = radius * radius + radius;
+    int grens_binnen = binnen * binnen + binnen;
+    int w = radius;
+    int w_binnen = binnen;
+
+    for (int dy = van; dy <= tot; dy++)
+    {
+        int dy2 = dy * dy;
+        int gat = -1;
+
+        while (w * w + dy2 > grens)
+            w--;
+
+        if (dy <= binnen)
+        {
+            while (w_binnen * w_binnen + dy2 > grens_binnen)
+                w_binnen--;
+            gat = w_binnen;
+        }
+
+        for (int kant = 0; kant < 2; kant++)
+        {
+            int y = (kant == 0) ? y0 - dy : y0 + dy;
+
+            if (kant == 1 && dy == 0)
+                break;
+
+            if (gat < 0)
+            {
+                vul_rechthoek(x0 - w, y, 2 * w + 1, 1, color);
+            }
+            else if (w > gat)
+            {
+                vul_rechthoek(x0 - w, y, w - gat, 1, color);
+                vul_rechthoek(x0 + gat + 1, y, w - gat, 1, color);
+            }
+        }
+    }
+}
+
+/** @brief Fractiebits van de x-coördinaat van een rand (x < 2048, 20 bits) */
+#define VEELHOEK_FRACTIE   20
+
+/**
+ * @brief Eén rand van een veelhoek, van boven naar beneden.
+ */
+typedef struct
+{
+    int32_t x;        /**< x op de huidige rij, vaste komma */
+    int32_t stap;     /**< verandering van x per rij, vaste komma */
+    int16_t boven;    /**< eerste rij */
+    int16_t onder;    /**< eerste rij onder de rand */
+    int8_t richting;  /**< +1 = omlaag getekend, -1 = omhoog */
+} VeelhoekRand;
+
+/**
+ * @brief Vult een veelhoek rij voor rij met een tabel van actieve randen.
+ *
+ * Een rand bedekt de rijen van zijn bovenste punt tot (zonder) zijn
+ * onderste punt, zodat een hoekpunt tussen twee randen één keer telt en
+ * horizontale randen niet meedoen. Per rij wordt x met een vaste stap
+ * opgeteld. stap wordt naar beneden afgerond; de fout na hooguit 480
+ * rijen (< 480 / 2^20) is kleiner dan de kleinste afstand tot een
+ * geheel getal (1 / 480), dus naar boven afronden geeft precies de
+ * eerste pixel rechts van de rand.
+ *
+ * De actieve randen worden op x gesorteerd (insertion sort, de volgorde
+ * verandert van rij tot rij nauwelijks). Tussen twee randen ligt een span
+ * van de pixels met xl <= x < xr; de vulregel bepaalt welke spans binnen
+ * liggen. Elke pixel binnen wordt één keer geschreven.
+ *
+ * @param punten x- en y-coördinaten om en om
+ * @param aantal Aantal punten
+ * @param color VGA-kleurcode
+ * @param vulling RASTER_VUL_EVEN_ONEVEN of RASTER_VUL_NIET_NUL
+ * @param van Eerste rij
+ * @param tot Laatste rij
+ */
+static void teken_veelhoek(const int16_t *punten, int aantal, uint8_t color, int vulling, int van, int tot)
+{
+    VeelhoekRand randen[RASTER_MAX_PUNTEN];
+    VeelhoekRand *actief[RASTER_MAX_PUNTEN];
+    int n_randen = 0;
+    int n_actief = 0;
+    int volgende = 0;
+
+    if (van < 0)
+        van = 0;
+    if (tot > raster_doel_hoogte() - 1)
+        tot = raster_doel_hoogte() - 1;
+
+    /* Randtabel, gesorteerd op de bovenste rij */
+    for (int i = 0; i < aantal; i++)
+    {
+        int j = (i + 1 < aantal) ? i + 1 : 0;
+        int x0 = punten[2 * i];
+        int y0 = punten[2 * i + 1];
+        int x1 = punten[2 * j];
+        int y1 = punten[2 * j + 1];
+        int richting = 1;
+        int32_t teller;
+        VeelhoekRand r;
+        int k;
+
+        if (y0 == y1)
+            continue;
+
+        if (y0 > y1)
+        {
+            int t = x0; x0 = x1; x1 = t;
+            t = y0; y0 = y1; y1 = t;
+            richting = -1;
+        }
+
+        /* stap = floor((x1 - x0) * 2^20 / (y1 - y0)), ook voor een negatieve teller */
+        teller = (int32_t)(x1 - x0) * (1 << VEELHOEK_FRACTIE);
+        r.stap = teller / (y1 - y0);
+        if (teller < 0 && r.stap * (y1 - y0) != teller)
+            r.stap--;
+        r.x = (int32_t)x0 * (1 << VEELHOEK_FRACTIE);
+        r.boven = (int16_t)y0;
+        r.onder = (int16_t)y1;
+        r.richting = (int8_t)richting;
+
+        for (k = n_randen; k > 0 && randen[k - 1].boven > r.boven; k--)
+            randen[k] = randen[k - 1];
+        randen[k] = r;
+        n_randen++;
+    }
+
+    for (int y = van; y <= tot; y++)
+    {
+        int binnen = 0;
+        int32_t begin = 0;
+        int n = 0;
+
+        /* Nieuwe randen erbij; een band kan halverwege een rand beginnen */
+        while (volgende < n_randen && randen[volgende].boven <= y)
+        {
+            VeelhoekRand *r = &randen[volgende++];
+
+            if (r->onder <= y)
+                continue;
+            r->x += r->stap * (y - r->boven);
+            actief[n_actief++] = r;
+        }
+
+        /* Afgelopen randen eruit */
+        for (int k = 0; k < n_actief; k++)
+        {
+            if (actief[k]->onder > y)
+                actief[n++] = actief[k];
+        }
+        n_actief = n;
+
+        for (int k = 1; k < n_actief; k++)
+        {
+            VeelhoekRand *r = actief[k];
+            int m;
+
+            for (m = k; m > 0 && actief[m - 1]->x > r->x; m--)
+                actief[m] = actief[m - 1];
+            actief[m] = r;
+        }
+
+        /* Spans tussen de randen volgens de vulregel */
+        for (int k = 0; k < n_actief; k++)
+        {
+            int was_binnen = (binnen != 0);
+
+            if (vulling == RASTER_VUL_EVEN_ONEVEN)
+                binnen ^= 1;
+            else
+                binnen += actief[k]->richting;
+
+            if (!was_binnen && binnen != 0)
+            {
+                begin = actief[k]->x;
+            }
+            else if (was_binnen && binnen == 0)
+            {
+                /* Naar boven afronden: eerste pixel rechts van elke rand */
+                int links = (int)((begin + (1 << VEELHOEK_FRACTIE) - 1) >> VEELHOEK_FRACTIE);
+                int rechts = (int)((actief[k]->x + (1 << VEELHOEK_FRACTIE) - 1) >> VEELHOEK_FRACTIE);
+
+                if (links < 0)
+                    links = 0;
+                if (rechts > raster_doel_breedte())
+                    rechts = raster_doel_breedte();
+                if (rechts > links)
+                    vul_rechthoek(links, y, rechts - links, 1, color);
+            }
+        }
+
+        for (int k = 0; k < n_actief; k++)
+            actief[k]->x += actief[k]->stap;
+    }
+}
+
+/**
+ * @brief Rastert één karakter uit een 8x8 bitmap font.
+ *
+ * @param x X-coördinaat linker bovenhoek
+ * @param y Y-coördinaat linker bovenhoek
+ * @param karakter ASCII-code
+ * @param font Fontdata
+ * @param schaal Schaalfactor
+ * @param is_vet 1 = vet
+ * @param is_cursief 1 = cursief
+ * @param color VGA-kleurcode
+ */
+static void teken_karakter(int x, int y, unsigned char karakter, const unsigned char *font,
+                           int schaal, int is_vet, int is_cursief, uint8_t color)
+{
+    int bitmap_index = karakter * BASE_FONT_SIZE;
+
+    for (int rij = 0; rij < BASE_FONT_SIZE; rij++)
+    {
+        unsigned char rij_data = font[bitmap_index + rij];
+        int offset_schuin = 0;
+
+        if (is_cursief)
+            offset_schuin = (int)((rij / 3.0) * schaal + 0.5);
+
+        for (int bit = 0; bit < BASE_FONT_SIZE; bit++)
+        {
+            if (((rij_data >> (7 - bit)) & 1) == 0)
+                continue;
+
+            for (int s_y = 0; s_y < schaal; s_y++)
+            {
+                for (int s_x = 0; s_x < schaal; s_x++)
+                {
+                    int pixel_x = x + (bit * schaal) + s_x + offset_schuin;
+                    int pixel_y = y + (rij * schaal) + s_y;
+
+                    zet_pixel_clip(pixel_x, pixel_y, color);
+
+                    if (is_vet)
+                        zet_pixel_clip(pixel_x + schaal, pixel_y, color);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,298 @@
+/**
+ * @file APIstempel.c
+ * @brief Stempelcache: samengestelde vormen één keer tekenen, daarna kopiëren.
+ *
+ * Een stempel is een Surface in de arena met de vorm op een achtergrond van
+ * 0xFF. Een treffer is één raster_blit() met transparantie; een misser
+ * tekent de vorm eerst met de tekenfunctie van de aanroeper in een nieuwe
+ * stempel. Omdat de tekenfunctie de gewone API gebruikt, is de stempel
+ * pixel voor pixel gelijk aan de vorm die direct getekend wordt.
+ *
+ * Een stempel in de wachtrij van de rasterlaag wijst naar de arena. Daarom
+ * wordt de wachtrij leeggemaakt voordat een stempel wordt verwijderd of
+ * verschoven.
+ *
+ * @author Thijs, Joost, Luc
+ * @version 1.0
+ * @date 2026-01-20
+ */
+
+#include <string.h>
+
+#include "APIstempel.h"
+#include "APIraster.h"
+#include "stm32_ub_vga_screen.h"
+
+
+/**
+ * @brief 1 = de cache wordt gebruikt.
+ *
+ * Niet met een display-lijst: een bitmap-item zou naar de arena blijven wijzen.
+ */
+#define STEMPEL_ACTIEF  (STEMPEL_CACHE && (VGA_USE_DLIST == 0))
+
+#if STEMPEL_ACTIEF
+/**
+ * @brief Eén plaats in de cache.
+ */
+typedef struct
+{
+    StempelVorm vorm;
+    Surface surface;    /**< pixels in de arena */
+    uint16_t offset;    /**< eerste byte in de arena */
+    uint16_t bytes;     /**< breedte * hoogte */
+    uint32_t gebruikt;  /**< stand van de klok bij het laatste gebruik */
+    uint8_t bezet;
+} Stempel;
+
+static uint8_t arena[STEMPEL_ARENA_GROOTTE] VGA_CCMRAM;
+static Stempel stempels[STEMPEL_AANTAL] VGA_CCMRAM;
+static uint32_t klok = 0;
+static uint8_t cache_aan = 1;
+
+static Stempel *zoek_stempel(const StempelVorm *vorm);
+static Stempel *nieuwe_stempel(const StempelVorm *vorm);
+static void verwijder_oudste(void);
+static uint16_t comprimeer(void);
+#endif
+
+static StempelStatistiek statistiek VGA_CCMRAM;
+
+
+/**
+ * @brief Tekent een vorm via de stempelcache.
+ *
+ * @param vorm Sleutel en kader
+ * @param x X-coördinaat van het ankerpunt
+ * @param y Y-coördinaat van het ankerpunt
+ * @param teken Tekenfunctie van de vorm
+ * @param arg Argument voor teken()
+ * @return 1 = getekend, 0 = niet getekend (de aanroeper tekent zelf)
+ */
+int stempel_teken(const StempelVorm *vorm, int x, int y, StempelTeken teken, const void *arg)
+{
+#if !STEMPEL_ACTIEF
+    (void)vorm;
+    (void)x;
+    (void)y;
+    (void)teken;
+    (void)arg;
+    return 0;
+#else
+    Stempel *s;
+
+    if (!cache_aan || vorm->kleur1 == 0xFF || vorm->kleur2 == 0xFF)
+        return 0;
+
+    /* Alleen als de hele vorm past, anders zou de stempel meer tekenen dan de API */
+    if (x + vorm->links < 0 || y + vorm->boven < 0 ||
+        x + vorm->links + vorm->breedte > raster_doel_breedte() ||
+        y + vorm->boven + vorm->hoogte > raster_doel_hoogte())
+        return 0;
+
+    s = zoek_stempel(vorm);
+    if (s != NULL)
+    {
+        statistiek.treffers++;
+    }
+    else
+    {
+        const Surface *vorig;
+
+        s = nieuwe_stempel(vorm);
+        if (s == NULL)
+            return 0;
+
+        /* Vorm tekenen met het ankerpunt binnen de stempel */
+        vorig = raster_doel();
+        raster_zet_doel(&s->surface);
+        raster_rechthoek(0, 0, vorm->breedte, vorm->hoogte, 0xFF, 1);
+        teken(-vorm->links, -vorm->boven, arg);
+        raster_zet_doel(vorig);
+
+        statistiek.missers++;
+    }
+
+    s->gebruikt = ++klok;
+    raster_blit(&s->surface, x + vorm->links, y + vorm->boven, 1);
+    return 1;
+#endif
+}
+
+/**
+ * @brief Zet de stempelcache aan of uit.
+ *
+ * @param aan 1 = aan, 0 = uit
+ */
+void stempel_cache_aan(int aan)
+{
+#if STEMPEL_ACTIEF
+    cache_aan = aan ? 1 : 0;
+#else
+    (void)aan;
+#endif
+}
+
+/**
+ * @brief Verwijdert alle stempels en zet de tellers op nul.
+ */
+void stempel_leeg(void)
+{
+#if STEMPEL_ACTIEF
+    raster_wachtrij_leeg();
+    memset(stempels, 0, sizeof(stempels));
+#endif
+    memset(&statistiek, 0, sizeof(statistiek));
+}
+
+/**
+ * @brief Geeft de tellers van de stempelcache.
+ *
+ * @param st Struct om in te vullen
+ */
+void stempel_statistiek(StempelStatistiek *st)
+{
+    *st = statistiek;
+}
+
+#if STEMPEL_ACTIEF
+/**
+ * @brief Zoekt de stempel met dezelfde sleutel.
+ *
+ * @param vorm Sleutel
+ * @return Stempel, of NULL als die er niet is
+ */
+static Stempel *zoek_stempel(const StempelVorm *vorm)
+{
+    for (int i = 0; i < STEMPEL_AANTAL; i++)
+    {
+        Stempel *s = &stempels[i];
+
+        if (s->bezet && s->vorm.vorm == vorm->vorm && s->vorm.grootte == vorm->grootte &&
+            s->vorm.kleur1 == vorm->kleur1 && s->vorm.kleur2 == vorm->kleur2)
+            return s;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Reserveert een stempel voor de vorm, zo nodig ten koste van de oudste.
+ *
+ * Nieuwe pixels komen achter de laatste stempel. Past dat niet, maar is er
+ * in totaal genoeg ruimte, dan worden de stempels eerst aaneengeschoven.
+ *
+ * @param vorm Sleutel en kader
+ * @return Stempel met een lege Surface, of NULL als de vorm niet in de arena past
+ */
+static Stempel *nieuwe_stempel(const StempelVorm *vorm)
+{
+    uint32_t bytes = (uint32_t)vorm->breedte * (uint32_t)vorm->hoogte;
+
+    if (bytes == 0 || bytes > STEMPEL_ARENA_GROOTTE)
+        return NULL;
+
+    /* Opdrachten in de wachtrij kunnen nog naar een stempel wijzen */
+    raster_wachtrij_leeg();
+
+    while (1)
+    {
+        Stempel *vrij = NULL;
+        uint32_t eind = 0;
+
+        for (int i = 0; i < STEMPEL_AANTAL; i++)
+        {
+            if (!stempels[i].bezet)
+            {
+                if (vrij == NULL)
+                    vrij = &stempels[i];
+            }
+            else if ((uint32_t)stempels[i].offset + stempels[i].bytes > eind)
+            {
+                eind = (uint32_t)stempels[i].offset + stempels[i].bytes;
+            }
+        }
+
+        if (vrij != NULL && eind + bytes > STEMPEL_ARENA_GROOTTE &&
+            (uint32_t)statistiek.bytes + bytes <= STEMPEL_ARENA_GROOTTE)
+            eind = comprimeer();
+
+        if (vrij != NULL && eind + bytes <= STEMPEL_ARENA_GROOTTE)
+        {
+            vrij->vorm = *vorm;
+            vrij->offset = (uint16_t)eind;
+            vrij->bytes = (uint16_t)bytes;
+            vrij->bezet = 1;
+            surface_init(&vrij->surface, &arena[eind], vorm->breedte, vorm->hoogte, vorm->breedte);
+
+            statistiek.bytes += (uint16_t)bytes;
+            statistiek.aantal++;
+            return vrij;
+        }
+
+        verwijder_oudste();
+    }
+}
+
+/**
+ * @brief Verwijdert de stempel die het langst niet gebruikt is.
+ */
+static void verwijder_oudste(void)
+{
+    Stempel *oudste = NULL;
+
+    for (int i = 0; i < STEMPEL_AANTAL; i++)
+    {
+        if (stempels[i].bezet && (oudste == NULL || stempels[i].gebruikt < oudste->gebruikt))
+            oudste = &stempels[i];
+    }
+
+    if (oudste == NULL)
+        return;
+
+    oudste->bezet = 0;
+    statistiek.bytes -= oudste->bytes;
+    statistiek.aantal--;
+    statistiek.verwijderd++;
+}
+
+/**
+ * @brief Schuift alle stempels naar het begin van de arena.
+ *
+ * @return Eerste vrije byte achter de laatste stempel
+ */
+static uint16_t comprimeer(void)
+{
+    uint8_t klaar[STEMPEL_AANTAL] = {0};
+    uint16_t eind = 0;
+
+    /* Steeds de laagste stempel die nog niet verschoven is */
+    while (1)
+    {
+        Stempel *laagste = NULL;
+        int index = 0;
+
+        for (int i = 0; i < STEMPEL_AANTAL; i++)
+        {
+            if (stempels[i].bezet && !klaar[i] &&
+                (laagste == NULL || stempels[i].offset < laagste->offset))
+            {
+                laagste = &stempels[i];
+                index = i;
+            }
+        }
+
+        if (laagste == NULL)
+            return eind;
+
+        if (laagste->offset != eind)
+        {
+            memmove(&arena[eind], &arena[laagste->offset], laagste->bytes);
+            laagste->offset = eind;
+            laagste->surface.buffer = &arena[eind];
+        }
+        eind += laagste->bytes;
+        klaar[index] = 1;
+    }
+}
+#endif
@@ -3,7 +3,7 @@
  * @brief Bevat de front layer handlers voor teken- en commandoverwerking via UART.
  * @details
  * Dit bestand verwerkt alle commando's die via interrupt-driven UART binnenkomen.
- * Het omvat commando's voor tekenen (lijn, rechthoek, cirkel, figuur, bitmap),
+ * Het omvat commando's voor tekenen (lijn, rechthoek, cirkel, figuur, veelhoek, bitmap),
  * tekst, pixels, scherm wissen, toren tekenen, herhaling en kleurinformatie.
  * @author Luc, Joost, Thijs
  * @version 1.1
@@ -25,14 +25,20 @@ static void Handle_HELP(void)
 {
     UART2_WriteString("\r\n--- Beschikbare Commando's ---\r\n");
     UART2_WriteString("KLEUR\r\n");
-    UART2_WriteString("lijn,x1,y1,x2,y2,kleur,dikte\r\n");
+    UART2_WriteString("lijn,x1,y1,x2,y2,kleur,dikte[,kap]\r\n");
     UART2_WriteString("rechthoek,x,y,w,h,kleur,gevuld\r\n");
     UART2_WriteString("tekst,x,y,kleur,tekst,font,grootte,stijl\r\n");
     UART2_WriteString("bitmap,x,y,nr\r\n");
     UART2_WriteString("clearscherm,kleur\r\n");
-    UART2_WriteString("cirkel,x,y,straal,kleur\r\n");
+    UART2_WriteString("cirkel,x,y,straal,kleur[,gevuld[,dikte]]\r\n");
     UART2_WriteString("figuur,x1,y1,x2,y2,x3,y3,x4,y4,x5,y5,kleur\r\n");
+    UART2_WriteString("veelhoek,kleur,gevuld,x1,y1,x2,y2,x3,y3[,...]\r\n");
     UART2_WriteString("wacht,msecs\r\n");
+    UART2_WriteString("wachtframe,frames\r\n");
+    UART2_WriteString("uitgesteld,aan\r\n");
+    UART2_WriteString("modus,breedte\r\n");
+    UART2_WriteString("scroll,regels\r\n");
+    UART2_WriteString("kopieer,x,y,w,h,doel_x,doel_y\r\n");
     UART2_WriteString("setPixel,x,y,kleur\r\n");
 }
 
@@ -65,7 +71,7 @@ static void Handle_setPixel(const char *cmd)
 /**
  * @brief Verwerk het lijn commando
  * @param cmd De string met het commando, bv. "lijn,10,10,100,100,rood,2"
- * @details Parseert begin- en eindpunt, kleur en dikte en toont debug info via UART.
+ * @details Parseert begin- en eindpunt, kleur, dikte en (optioneel) kap en toont debug info via UART.
  */
 static void Handle_Lijn(const char *cmd)
 {
@@ -74,11 +80,12 @@ static void Handle_Lijn(const char *cmd)
     int x2 = 0;
     int y2 = 0;
     int dikte = 1;
+    int kap = 0;
     char kleur[16] = "zwart";
 
-    int resultaat = sscanf(cmd, "lijn,%d,%d,%d,%d,%15[^,],%d", &x1, &y1, &x2, &y2, kleur, &dikte);
+    int resultaat = sscanf(cmd, "lijn,%d,%d,%d,%d,%15[^,],%d,%d", &x1, &y1, &x2, &y2, kleur, &dikte, &kap);
 
-    if (resultaat == 6)
+    if (resultaat >= 6)
     {
         char msg[80];
         snprintf(msg, sizeof(msg), "DEBUG: Lijn van (%d,%d) naar (%d,%d) kleur=%s\r\n", x1, y1, x2, y2, kleur);
@@ -87,7 +94,7 @@ static void Handle_Lijn(const char *cmd)
     }
     else
     {
-        UART2_WriteString("FOUT: Gebruik: lijn,x1,y1,x2,y2,kleur,dikte\r\n");
+        UART2_WriteString("FOUT: Gebruik: lijn,x1,y1,x2,y2,kleur,dikte[,kap]\r\n");
     }
 }
 
@@ -184,23 +191,25 @@ static void Handle_Clear(const char *cmd)
 
 /**
  * @brief Verwerk cirkel commando
- * @param cmd Commando string: "cirkel,x,y,straal,kleur"
+ * @param cmd Commando string: "cirkel,x,y,straal,kleur[,gevuld[,dikte]]"
  */
 static void Handle_Cirkel(const char *cmd)
 {
     int x = 0;
     int y = 0;
     int r = 0;
+    int gevuld = 0;
+    int dikte = 1;
     char kleur[16] = {0};
 
-    if (sscanf(cmd, "cirkel,%d,%d,%d,%15s", &x, &y, &r, kleur) == 4)
+    if (sscanf(cmd, "cirkel,%d,%d,%d,%15[^,],%d,%d", &x, &y, &r, kleur, &gevuld, &dikte) >= 4)
     {
         UART2_WriteString("Cirkel getekend\r\n");
         // API_draw_circle(x, y, r, kleur_naar_int(kleur), 0);
     }
     else
     {
-        UART2_WriteString("FOUT: Gebruik: cirkel,x,y,straal,kleur\r\n");
+        UART2_WriteString("FOUT: Gebruik: cirkel,x,y,straal,kleur[,gevuld[,dikte]]\r\n");
     }
 }
 
@@ -223,6 +232,96 @@ static void Handle_Wacht(const char *cmd)
     }
 }
 
+/**
+ * @brief Wacht een aantal frames (60 Hz)
+ * @param cmd Commando string: "wachtframe,frames"
+ */
+static void Handle_Wachtframe(const char *cmd)
+{
+    int frames = 0;
+
+    if (sscanf(cmd, "wachtframe,%d", &frames) == 1)
+    {
+        UART2_WriteString("Wachten op frames...\r\n");
+    }
+    else
+    {
+        UART2_WriteString("FOUT: Gebruik: wachtframe,frames\r\n");
+    }
+}
+
+/**
+ * @brief Zet uitgesteld tekenen aan of uit
+ * @param cmd Commando string: "uitgesteld,aan" (aan = 0 of 1)
+ */
+static void Handle_Uitgesteld(const char *cmd)
+{
+    int aan = 0;
+
+    if (sscanf(cmd, "uitgesteld,%d", &aan) == 1)
+    {
+        UART2_WriteString(aan ? "Uitgesteld tekenen aan\r\n" : "Uitgesteld tekenen uit\r\n");
+    }
+    else
+    {
+        UART2_WriteString("FOUT: Gebruik: uitgesteld,aan\r\n");
+    }
+}
+
+/**
+ * @brief Kies de videomodus
+ * @param cmd Commando string: "modus,breedte" (320 of 160, bijv. "modus,160x120")
+ */
+static void Handle_Modus(const char *cmd)
+{
+    int breedte = 0;
+
+    if (sscanf(cmd, "modus,%d", &breedte) == 1)
+    {
+        UART2_WriteString("Videomodus gekozen\r\n");
+    }
+    else
+    {
+        UART2_WriteString("FOUT: Gebruik: modus,breedte\r\n");
+    }
+}
+
+/**
+ * @brief Scroll het beeld
+ * @param cmd Commando string: "scroll,regels" (negatief = omlaag)
+ */
+static void Handle_Scroll(const char *cmd)
+{
+    int regels = 0;
+
+    if (sscanf(cmd, "scroll,%d", &regels) == 1)
+    {
+        UART2_WriteString("Beeld gescrolld\r\n");
+    }
+    else
+    {
+        UART2_WriteString("FOUT: Gebruik: scroll,regels\r\n");
+    }
+}
+
+/**
+ * @brief Kopieer een rechthoek van het scherm
+ * @param cmd Commando string: "kopieer,x,y,w,h,doel_x,doel_y"
+ */
+static void Handle_Kopieer(const char *cmd)
+{
+    int x = 0, y = 0, w = 0, h = 0, doel_x = 0, doel_y = 0;
+
+    if (sscanf(cmd, "kopieer,%d,%d,%d,%d,%d,%d", &x, &y, &w, &h, &doel_x, &doel_y) == 6)
+    {
+        UART2_WriteString("Rechthoek gekopieerd\r\n");
+    }
+    else
+    {
+        UART2_WriteString("FOUT: Gebruik: kopieer,x,y,w,h,doel_x,doel_y\r\n");
+    }
+}
+
 /**
  * @brief Verwerk figuur commando
  * @param cmd Commando string: "figuur,x1,y1,x2,y2,x3,y3,x4,y4,x5,y5,kleur"
@@ -244,6 +343,34 @@ static void Handle_Figuur(const char *cmd)
     }
 }
 
+/**
+ * @brief Verwerk veelhoek commando
+ * @param cmd Commando string: "veelhoek,kleur,gevuld,x1,y1,x2,y2,x3,y3[,...]"
+ */
+static void Handle_Veelhoek(const char *cmd)
+{
+    int gevuld = 0;
+    int getallen = 0;
+    char kleur[16] = {0};
+
+    /* Elke komma na kleur en gevuld begint een coördinaat */
+    for (const char *c = strchr(cmd, ','); c != NULL; c = strchr(c + 1, ','))
+        getallen++;
+    getallen -= 2;
+
+    if (sscanf(cmd, "veelhoek,%15[^,],%d", kleur, &gevuld) == 2 &&
+        getallen >= 6 && getallen % 2 == 0)
+    {
+        char msg[48];
+        snprintf(msg, sizeof(msg), "Veelhoek getekend (%d punten)\r\n", getallen / 2);
+        UART2_WriteString(msg);
+    }
+    else
+    {
+        UART2_WriteString("FOUT: Gebruik: veelhoek,kleur,gevuld,x1,y1,x2,y2,x3,y3[,...]\r\n");
+    }
+}
+
 /**
  * @brief Verwerk toren commando
  * @param cmd Commando string: "toren,x,y,grootte,kleur1,kleur2"
@@ -338,8 +465,14 @@ void Handel_UART_Input(UserInput_t *in)
     else if (strncmp(in->full_command, "clearscherm", 11) == 0) Handle_Clear(in->full_command);
     else if (strncmp(in->full_command, "cirkel", 6) == 0)      Handle_Cirkel(in->full_command);
     else if (strncmp(in->full_command, "figuur", 6) == 0)      Handle_Figuur(in->full_command);
+    else if (strncmp(in->full_command, "veelhoek", 8) == 0)    Handle_Veelhoek(in->full_command);
     else if (strncmp(in->full_command, "toren", 5) == 0)       Handle_Toren(in->full_command);
+    else if (strncmp(in->full_command, "wachtframe", 10) == 0) Handle_Wachtframe(in->full_command);
     else if (strncmp(in->full_command, "wacht", 5) == 0)       Handle_Wacht(in->full_command);
+    else if (strncmp(in->full_command, "uitgesteld", 10) == 0) Handle_Uitgesteld(in->full_command);
+    else if (strncmp(in->full_command, "modus", 5) == 0)       Handle_Modus(in->full_command);
+    else if (strncmp(in->full_command, "scroll", 6) == 0)      Handle_Scroll(in->full_command);
+    else if (strncmp(in->full_command, "kopieer", 7) == 0)     Handle_Kopieer(in->full_command);
     else if (strncmp(in->full_command, "herhaal", 7) == 0)     Handle_Herhaal(in->full_command);
     else if (strncmp(in->full_command, "setPixel", 8) == 0)    Handle_setPixel(in->full_command);
     else
@@ -16,11 +16,13 @@
  */
 
 #include "UART.h"
+#include "stm32_ub_vga_ramfunc.h"
 
 volatile uint32_t uart_pclk1_debug = 0;
-volatile char uart_rx_buffer[RX_BUFFER_SIZE];
+volatile char uart_rx_buffer[RX_BUFFER_SIZE] VGA_CCMRAM;
 volatile uint32_t uart_rx_index = 0;
 volatile uint8_t uart_command_ready = 0;
+volatile uint8_t uart_rx_te_lang = 0;
 
 /**
  * @brief Initialiseert UART2 op de STM32F4
@@ -116,6 +118,8 @@ void UART2_ReadString(char *buf, uint32_t maxlen)
 /**
  * @brief USART2 interrupt handler
  * @details Ontvangt characters, zet uart_command_ready wanneer een commando compleet is.
+ *          Past een commando niet in de buffer, dan wordt uart_rx_te_lang gezet
+ *          in plaats van het commando af te kappen.
  */
 void USART2_IRQHandler(void)
 {
@@ -133,5 +137,9 @@ void USART2_IRQHandler(void)
         {
             uart_rx_buffer[uart_rx_index++] = c;
         }
+        else
+        {
+            uart_rx_te_lang = 1;
+        }
     }
 }
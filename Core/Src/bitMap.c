@@ -10,6 +10,7 @@
 
 #include "bitMap.h"
 #include "APIio.h"   // voor drawPixel
+#include "APIraster.h"  // tekendoel
 #include <stddef.h>  // voor NULL
 
 
@@ -2693,13 +2694,15 @@ const Bitmap skeleton_banging_on_shield_meme_frame_06 = {skalet_afbeelding, skal
 const Bitmap KIP = {KIP_afbeelding, KIP_afbeelding, kip_data, 1};
 
 /**
- * @brief Tekent een bitmap op het scherm
- * @param x0 Linker X-coördinaat op het scherm
- * @param y0 Boven Y-coördinaat op het scherm
+ * @brief Tekent een bitmap in het tekendoel (standaard het scherm)
+ * @param x0 Linker X-coördinaat in het tekendoel
+ * @param y0 Boven Y-coördinaat in het tekendoel
  * @param bmp Pointer naar de bitmapstruct
  * @param use_transparency 1 = transparantie toepassen, 0 = geen transparantie
+ *
+ * Draait vanuit RAM (VGA_RAMFUNC), de pixeldata blijft in flash.
  */
-void drawBitmap(int x0, int y0, const Bitmap *bmp, uint8_t use_transparency)
+VGA_RAMFUNC void drawBitmap(int x0, int y0, const Bitmap *bmp, uint8_t use_transparency)
 {
     int width  = bmp->width;
     int height = bmp->height;
@@ -2709,14 +2712,14 @@ void drawBitmap(int x0, int y0, const Bitmap *bmp, uint8_t use_transparency)
     for(int y = 0; y < height; y++)
     {
         int screen_y = y0 + y;
-        if(screen_y < 0 || screen_y >= VGA_DISPLAY_Y)
+        if(screen_y < 0 || screen_y >= raster_doel_hoogte())
             continue; // buiten scherm, overslaan
 
         // Loop door alle kolommen van de bitmap
         for(int x = 0; x < width; x++)
         {
             int screen_x = x0 + x;
-            if(screen_x < 0 || screen_x >= VGA_DISPLAY_X)
+            if(screen_x < 0 || screen_x >= raster_doel_breedte())
                 continue; // buiten scherm, overslaan
 
             // Index in pixel array aanpassen als W/H als eerste 2 bytes aanwezig zijn
@@ -2728,8 +2731,8 @@ void drawBitmap(int x0, int y0, const Bitmap *bmp, uint8_t use_transparency)
                 continue;
             }
 
-            // Zet pixel op scherm
-            UB_VGA_SetPixel(screen_x, screen_y, color);
+            // Zet pixel in het tekendoel (scherm of surface)
+            raster_doel_pixel(screen_x, screen_y, color);
         }
     }
 }
@@ -15,6 +15,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "logicLayer.h"
+#include "APIraster.h"
 
 
 /**
@@ -67,6 +68,20 @@ const char* errorCodeToString(int code)
         return "ERROR_TEXT_EMPTY";
     case ERROR_INVALID_STYL:
         return "ERROR_INVALID_STYL";
+    case FRAMES_NOT_IN_RANGE:
+        return "FRAMES_NOT_IN_RANGE";
+    case ERROR_AAN_UIT:
+        return "ERROR_AAN_UIT";
+    case ERROR_MODUS:
+        return "ERROR_MODUS";
+    case ERROR_SCROLL:
+        return "ERROR_SCROLL";
+    case ERROR_KOPIEER:
+        return "ERROR_KOPIEER";
+    case ERROR_KAP:
+        return "ERROR_KAP";
+    case ERROR_PUNTEN:
+        return "ERROR_PUNTEN";
     default:
         return "UNKNOWN_ERROR";
     }
@@ -179,8 +194,14 @@ COMMANDO_TYPE bepaal_commando(const char *woord)
     if (strcmp(woord, "herhaal") == 0)      return CMD_HERHAAL;
     if (strcmp(woord, "cirkel") == 0)       return CMD_CIRKEL;
     if (strcmp(woord, "figuur") == 0)       return CMD_FIGUUR;
+    if (strcmp(woord, "veelhoek") == 0)     return CMD_VEELHOEK;
     if (strcmp(woord, "toren") == 0)        return CMD_TOREN;
     if (strcmp(woord, "setPixel") == 0)     return CMD_SETPIXEL;
+    if (strcmp(woord, "wachtframe") == 0)   return CMD_WACHTFRAME;
+    if (strcmp(woord, "uitgesteld") == 0)   return CMD_UITGESTELD;
+    if (strcmp(woord, "modus") == 0)        return CMD_MODUS;
+    if (strcmp(woord, "scroll") == 0)       return CMD_SCROLL;
+    if (strcmp(woord, "kopieer") == 0)      return CMD_KOPIEER;
 
     return CMD_ONBEKEND;
 }
@@ -197,8 +218,8 @@ COMMANDO_TYPE bepaal_commando(const char *woord)
 
 void verwerk_commando(const char *input)
 {
-	static char buff[MAX_INPUT];
-	static char *delen[20];
+	static char buff[MAX_INPUT] VGA_CCMRAM;
+	static char *delen[MAX_DELEN] VGA_CCMRAM;
     int aantal = 0;
     ErrorList errors = {NO_ERROR, NO_ERROR, NO_ERROR, NO_ERROR, NO_ERROR, NO_ERROR,
             NO_ERROR, NO_ERROR, NO_ERROR, NO_ERROR, NO_ERROR};
@@ -207,7 +228,7 @@ void verwerk_commando(const char *input)
     buff[MAX_INPUT - 1] = '\0';
 
     char *ptr = strtok(buff, ",");
-    while (ptr != NULL && aantal < 20)
+    while (ptr != NULL && aantal < MAX_DELEN)
     {
         delen[aantal++] = ptr;
         ptr = strtok(NULL, ",");
@@ -226,7 +247,9 @@ void verwerk_commando(const char *input)
     switch (type)
     {
         case CMD_LIJN:
-        	errors = lijn(atoi(delen[1]), atoi(delen[2]), atoi(delen[3]), atoi(delen[4]), delen[5], atoi(delen[6]));
+        	/* kap is optioneel: standaard vierkante uiteinden */
+        	errors = lijn(atoi(delen[1]), atoi(delen[2]), atoi(delen[3]), atoi(delen[4]), delen[5], atoi(delen[6]),
+        	              (aantal > 7) ? atoi(delen[7]) : 0);
             break;
 
         case CMD_RECHTHOEK:
@@ -275,18 +298,60 @@ void verwerk_commando(const char *input)
         	errors = wacht(atoi(delen[1]));
             break;
 
+        case CMD_WACHTFRAME:
+        	errors = wachtframe(atoi(delen[1]));
+            break;
+
+        case CMD_UITGESTELD:
+        	errors = uitgesteld_tekenen(atoi(delen[1]));
+            break;
+
+        case CMD_MODUS:
+        	errors = scherm_modus(atoi(delen[1]));
+            break;
+
+        case CMD_SCROLL:
+        	errors = scherm_scroll(atoi(delen[1]));
+            break;
+
+        case CMD_KOPIEER:
+        	errors = kopieer(atoi(delen[1]), atoi(delen[2]), atoi(delen[3]), atoi(delen[4]), atoi(delen[5]), atoi(delen[6]));
+            break;
+
         case CMD_HERHAAL:
         	errors = herhaal(atoi(delen[1]), atoi(delen[2]));
             break;
 
         case CMD_CIRKEL:
-        	errors = cirkel(atoi(delen[1]), atoi(delen[2]), atoi(delen[3]), delen[4]);
+        	/* gevuld en dikte zijn optioneel: standaard een omtrek van 1 pixel */
+        	errors = cirkel(atoi(delen[1]), atoi(delen[2]), atoi(delen[3]), delen[4],
+        	                (aantal > 5) ? atoi(delen[5]) : 0, (aantal > 6) ? atoi(delen[6]) : 1);
             break;
 
         case CMD_FIGUUR:
         	errors = figuur(atoi(delen[1]), atoi(delen[2]), atoi(delen[3]), atoi(delen[4]), atoi(delen[5]), atoi(delen[6]), atoi(delen[7]), atoi(delen[8]), atoi(delen[9]), atoi(delen[10]), delen[11]);
             break;
 
+        case CMD_VEELHOEK:
+        {
+        	/* veelhoek,kleur,gevuld,x1,y1,...,xn,yn */
+        	static int punten[2 * RASTER_MAX_PUNTEN] VGA_CCMRAM;
+        	int n = (aantal > 3) ? (aantal - 3) / 2 : 0;
+
+        	/* een x zonder y is een fout, niet een punt minder */
+        	if (aantal < 3 || (aantal - 3) % 2 != 0)
+        	{
+        		errors.error_var1 = ERROR_PUNTEN;
+        		break;
+        	}
+
+        	for (int i = 0; i < 2 * n && i < 2 * RASTER_MAX_PUNTEN; i++)
+        		punten[i] = atoi(delen[3 + i]);
+
+        	errors = veelhoek(punten, n, delen[1], atoi(delen[2]));
+            break;
+        }
+
         case CMD_TOREN:
         	errors = toren(atoi(delen[1]), atoi(delen[2]), atoi(delen[3]), delen[4], delen[5]);
             break;
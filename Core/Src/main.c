@@ -40,7 +40,18 @@ int main(void)
     static UserInput_t input;
     while (1)
     {
-    	if (uart_command_ready)
+    	/* Uitgestelde tekenopdrachten in de verticale blanking */
+    	raster_wachtrij_verwerk(RASTER_VBLANK_BUDGET);
+
+    	if (uart_command_ready && uart_rx_te_lang)
+    	{
+    	    /* Een afgekapt commando zou met verkeerde waarden tekenen */
+    	    UART2_WriteString("\r\nFOUT: commando te lang, niet uitgevoerd\r\n> ");
+    	    uart_rx_te_lang = 0;
+    	    uart_command_ready = 0;
+    	    uart_rx_index = 0;
+    	}
+    	else if (uart_command_ready)
     	{
     	    memset(&input, 0, sizeof(UserInput_t));
     	    strncpy(input.full_command, (const char *)uart_rx_buffer, MAX_CMD_LENGTH - 1);
@@ -59,6 +70,7 @@ int main(void)
     	    Handel_UART_Input(&input);
 
     	    string_ophalen(input.full_command);
+    	    toon_scherm(0);
 
     	    UART2_WriteString("> ");
 
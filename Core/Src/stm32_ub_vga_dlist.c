@@ -0,0 +1,613 @@
+//--------------------------------------------------------------
+// File     : stm32_ub_vga_dlist.c
+// CPU      : STM32F4 (and PC for tests)
+// Module   : none
+// Function : display list and scanline renderer for the
+//            framebuffer-less VGA mode
+//
+// All functions only work on the list and the buffers they get
+// and use no hardware, so they can be tested and measured on the
+// PC (render a frame line by line, compare with the rasterizers).
+//--------------------------------------------------------------
+
+
+//--------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------
+#include "stm32_ub_vga_dlist.h"
+
+
+
+//--------------------------------------------------------------
+// most items on one line (the renderer sorts them by age)
+//--------------------------------------------------------------
+#define VGA_DLIST_LINE_MAX   VGA_DLIST_MAX
+
+
+
+//--------------------------------------------------------------
+// internal Functions
+//--------------------------------------------------------------
+static int16_t P_DList_Add(VGA_DList_t *dl, const VGA_DListItem_t *it);
+static void P_DList_Extent(VGA_DListItem_t *it);
+static void P_DList_Publish(VGA_DList_t *dl);
+VGA_RAMFUNC static uint32_t P_DList_Isqrt(uint32_t v);
+VGA_RAMFUNC static void P_DList_Fill(uint8_t *ptr, int32_t len, uint8_t color);
+VGA_RAMFUNC static void P_DList_Span(uint8_t *dst, int32_t xa, int32_t xb, int32_t xs, int32_t xe, uint8_t color);
+VGA_RAMFUNC static int32_t P_DList_LineRow(int32_t a, int32_t d, int32_t j);
+VGA_RAMFUNC static int32_t P_DList_LineFirst(int32_t a, int32_t d, int32_t j);
+VGA_RAMFUNC static int32_t P_DList_LineLast(int32_t a, int32_t d, int32_t j);
+VGA_RAMFUNC static void P_DList_RenderItem(const VGA_DListItem_t *it, uint8_t *dst, int32_t y, int32_t xs, int32_t xe);
+
+
+
+//--------------------------------------------------------------
+// clear the list
+// back_color : color of all pixels without an item
+//--------------------------------------------------------------
+void UB_VGA_DListInit(VGA_DList_t *dl, uint8_t back_color)
+{
+  uint8_t n;
+
+  for(n=0;n<VGA_DLIST_MAX;n++) {
+    dl->item[n].type=VGA_DL_FREE;
+  }
+  dl->back_color=back_color;
+  dl->used=0;
+  dl->z_next=0;
+  P_DList_Publish(dl);
+}
+
+
+//--------------------------------------------------------------
+// add a rectangle of w*h pixels (filled or only the border)
+// return : handle, -1 = list full
+//--------------------------------------------------------------
+int16_t UB_VGA_DListRect(VGA_DList_t *dl, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color, uint8_t filled)
+{
+  VGA_DListItem_t it;
+
+  if((w<=0) || (h<=0)) return -1;
+
+  it.type=VGA_DL_RECT;
+  it.color=color;
+  it.flags=(filled!=0) ? VGA_DL_FILLED : 0;
+  it.size=0;
+  it.x0=x;
+  it.y0=y;
+  it.x1=w;
+  it.y1=h;
+  it.data=0;
+  return P_DList_Add(dl,&it);
+}
+
+
+//--------------------------------------------------------------
+// add a line from x1,y1 to x2,y2
+// (Bresenham, square stamp of thickness/2*2+1 pixels per point)
+// return : handle, -1 = list full
+//--------------------------------------------------------------
+int16_t UB_VGA_DListLine(VGA_DList_t *dl, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color, uint8_t thickness)
+{
+  VGA_DListItem_t it;
+
+  it.type=VGA_DL_LINE;
+  it.color=color;
+  it.flags=0;
+  it.size=thickness;
+  it.x0=x1;
+  it.y0=y1;
+  it.x1=x2;
+  it.y1=y2;
+  it.data=0;
+  return P_DList_Add(dl,&it);
+}
+
+
+//--------------------------------------------------------------
+// add the outline of a circle (midpoint, 8 octants)
+// return : handle, -1 = list full
+//--------------------------------------------------------------
+int16_t UB_VGA_DListCircle(VGA_DList_t *dl, int16_t x0, int16_t y0, int16_t radius, uint8_t color)
+{
+  VGA_DListItem_t it;
+
+  if(radius<0) return -1;
+
+  it.type=VGA_DL_CIRCLE;
+  it.color=color;
+  it.flags=0;
+  it.size=0;
+  it.x0=x0;
+  it.y0=y0;
+  it.x1=radius;
+  // last octant step : largest y with (2y+1)^2 <= 2r^2+1
+  it.y1=(int16_t)((P_DList_Isqrt(2UL*radius*radius+1)-1)>>1);
+  it.data=0;
+  return P_DList_Add(dl,&it);
+}
+
+
+//--------------------------------------------------------------
+// add one character of an 8x8 font
+// scale : 1.. (pixels per font pixel)
+// flags : VGA_DL_BOLD, VGA_DL_ITALIC
+// return : handle, -1 = list full
+//--------------------------------------------------------------
+int16_t UB_VGA_DListChar(VGA_DList_t *dl, int16_t x, int16_t y, uint8_t code, const uint8_t *font,
+                         uint8_t scale, uint8_t flags, uint8_t color)
+{
+  VGA_DListItem_t it;
+
+  if(scale==0) return -1;
+
+  it.type=VGA_DL_CHAR;
+  it.color=color;
+  it.flags=flags & (VGA_DL_BOLD | VGA_DL_ITALIC);
+  it.size=scale;
+  it.x0=x;
+  it.y0=y;
+  it.x1=code;
+  it.y1=0;
+  it.data=font;
+  return P_DList_Add(dl,&it);
+}
+
+
+//--------------------------------------------------------------
+// add a bitmap of w*h R3G3B2 pixels (row by row)
+// flags : VGA_DL_TRANSPARENT
+// the data must stay valid (flash) while the item is in the list
+// return : handle, -1 = list full
+//--------------------------------------------------------------
+int16_t UB_VGA_DListBitmap(VGA_DList_t *dl, int16_t x, int16_t y, int16_t w, int16_t h,
+                           const uint8_t *data, uint8_t flags)
+{
+  VGA_DListItem_t it;
+
+  if((w<=0) || (h<=0)) return -1;
+
+  it.type=VGA_DL_BITMAP;
+  it.color=0;
+  it.flags=flags & VGA_DL_TRANSPARENT;
+  it.size=0;
+  it.x0=x;
+  it.y0=y;
+  it.x1=w;
+  it.y1=h;
+  it.data=data;
+  return P_DList_Add(dl,&it);
+}
+
+
+//--------------------------------------------------------------
+// move an item by dx,dy pixels (it stays at its depth)
+// return : 0 = ok, 1 = no such item
+//--------------------------------------------------------------
+uint8_t UB_VGA_DListMove(VGA_DList_t *dl, int16_t handle, int16_t dx, int16_t dy)
+{
+  VGA_DListItem_t *it;
+
+  if((handle<0) || (handle>=VGA_DLIST_MAX)) return 1;
+  it=&dl->item[handle];
+  if(it->type==VGA_DL_FREE) return 1;
+
+  it->x0+=dx;
+  it->y0+=dy;
+  if(it->type==VGA_DL_LINE) {
+    // both end points move
+    it->x1+=dx;
+    it->y1+=dy;
+  }
+  P_DList_Extent(it);
+  // the renderer keeps its copy until the next frame
+  P_DList_Publish(dl);
+  return 0;
+}
+
+
+//--------------------------------------------------------------
+// remove an item, the handle is free again
+// return : 0 = ok, 1 = no such item
+//--------------------------------------------------------------
+uint8_t UB_VGA_DListDelete(VGA_DList_t *dl, int16_t handle)
+{
+  if((handle<0) || (handle>=VGA_DLIST_MAX)) return 1;
+  if(dl->item[handle].type==VGA_DL_FREE) return 1;
+
+  dl->item[handle].type=VGA_DL_FREE;
+  dl->used--;
+  P_DList_Publish(dl);
+  return 0;
+}
+
+
+//--------------------------------------------------------------
+// call before the first line of a frame (renderer side)
+// takes the newest order table, the list functions may change
+// the items and the other table during the frame
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_DListFrameStart(VGA_DList_t *dl)
+{
+  if(dl->order_new!=0) {
+    dl->order_rd^=1;
+    dl->order_new=0;
+  }
+}
+
+
+//--------------------------------------------------------------
+// render the pixels x_start..x_end-1 of line y into dst
+// dst     : one line, pixel x at dst[x]
+// x_start : multiple of 4 (word aligned background fill)
+//
+// the items of the line are drawn in the order they were added,
+// like in a frame buffer (newer items cover older ones)
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_DListRenderLine(const VGA_DList_t *dl, uint8_t *dst, int16_t y,
+                                        int16_t x_start, int16_t x_end)
+{
+  const VGA_DListItem_t *order=dl->order[dl->order_rd];
+  uint8_t cnt=dl->order_cnt[dl->order_rd];
+  uint8_t hit[VGA_DLIST_LINE_MAX];
+  uint8_t hit_cnt=0;
+  uint8_t n,m;
+  const VGA_DListItem_t *it;
+
+  // background
+  P_DList_Fill(&dst[x_start],x_end-x_start,dl->back_color);
+
+  // items of this line (order is sorted by y_min)
+  for(n=0;n<cnt;n++) {
+    it=&order[n];
+    if(it->y_min>y) break;
+    if(it->y_max<y) continue;
+
+    // insert sorted by age (z), mostly only a few items per line
+    m=hit_cnt;
+    while((m>0) && (order[hit[m-1]].z>it->z)) {
+      hit[m]=hit[m-1];
+      m--;
+    }
+    hit[m]=n;
+    hit_cnt++;
+  }
+
+  for(n=0;n<hit_cnt;n++) {
+    P_DList_RenderItem(&order[hit[n]],dst,y,x_start,x_end);
+  }
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// copy an item into a free place of the list
+//--------------------------------------------------------------
+static int16_t P_DList_Add(VGA_DList_t *dl, const VGA_DListItem_t *it)
+{
+  uint8_t tmp[VGA_DLIST_MAX];
+  uint8_t cnt=0,m,k;
+  int16_t n;
+
+  for(n=0;n<VGA_DLIST_MAX;n++) {
+    if(dl->item[n].type==VGA_DL_FREE) break;
+  }
+  if(n>=VGA_DLIST_MAX) return -1;
+
+  if(dl->z_next==0xFFFF) {
+    // depth counter at the end : renumber 0.. in the same order
+    for(m=0;m<VGA_DLIST_MAX;m++) {
+      if(dl->item[m].type==VGA_DL_FREE) continue;
+      k=cnt;
+      while((k>0) && (dl->item[tmp[k-1]].z>dl->item[m].z)) {
+        tmp[k]=tmp[k-1];
+        k--;
+      }
+      tmp[k]=m;
+      cnt++;
+    }
+    for(k=0;k<cnt;k++) {
+      dl->item[tmp[k]].z=k;
+    }
+    dl->z_next=cnt;
+  }
+
+  dl->item[n]=*it;
+  dl->item[n].z=dl->z_next++;
+  P_DList_Extent(&dl->item[n]);
+  dl->used++;
+  P_DList_Publish(dl);
+  return n;
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// first and last line with pixels of an item
+//--------------------------------------------------------------
+static void P_DList_Extent(VGA_DListItem_t *it)
+{
+  int16_t half;
+
+  switch(it->type) {
+    case VGA_DL_RECT:
+    case VGA_DL_BITMAP:
+      it->y_min=it->y0;
+      it->y_max=it->y0+it->y1-1;
+      break;
+    case VGA_DL_LINE:
+      half=it->size>>1;
+      it->y_min=((it->y0<it->y1) ? it->y0 : it->y1)-half;
+      it->y_max=((it->y0<it->y1) ? it->y1 : it->y0)+half;
+      break;
+    case VGA_DL_CIRCLE:
+      it->y_min=it->y0-it->x1;
+      it->y_max=it->y0+it->x1;
+      break;
+    case VGA_DL_CHAR:
+      it->y_min=it->y0;
+      it->y_max=it->y0+(VGA_DLIST_FONT_SIZE*it->size)-1;
+      break;
+    default:
+      break;
+  }
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// build the order table the renderer does not use
+// (copies of the used items sorted by y_min)
+//--------------------------------------------------------------
+static void P_DList_Publish(VGA_DList_t *dl)
+{
+  uint8_t wr,n,m,cnt=0;
+  VGA_DListItem_t *order;
+
+  // no switch while the table is written, then read which
+  // table the renderer uses (it can have switched just now)
+  dl->order_new=0;
+  wr=dl->order_rd^1;
+  order=dl->order[wr];
+
+  for(n=0;n<VGA_DLIST_MAX;n++) {
+    if(dl->item[n].type==VGA_DL_FREE) continue;
+    m=cnt;
+    while((m>0) && (order[m-1].y_min>dl->item[n].y_min)) {
+      order[m]=order[m-1];
+      m--;
+    }
+    order[m]=dl->item[n];
+    cnt++;
+  }
+  dl->order_cnt[wr]=cnt;
+
+  // table complete before the renderer may take it
+  __asm__ __volatile__("" ::: "memory");
+  dl->order_new=1;
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// integer square root (floor)
+//--------------------------------------------------------------
+VGA_RAMFUNC static uint32_t P_DList_Isqrt(uint32_t v)
+{
+  uint32_t res=0;
+  uint32_t bit=1UL<<30;
+
+  while(bit>v) bit>>=2;
+  while(bit!=0) {
+    if(v>=res+bit) {
+      v-=res+bit;
+      res=(res>>1)+bit;
+    }
+    else {
+      res>>=1;
+    }
+    bit>>=2;
+  }
+  return res;
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// fill len bytes with color (32bit stores in the middle)
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_DList_Fill(uint8_t *ptr, int32_t len, uint8_t color)
+{
+  uint32_t value=color*0x01010101UL;
+  uint32_t *wptr;
+
+  while((len>0) && (((uintptr_t)ptr & 0x03)!=0)) {
+    *ptr++=color;
+    len--;
+  }
+  wptr=(uint32_t *)ptr;
+  while(len>=4) {
+    *wptr++=value;
+    len-=4;
+  }
+  ptr=(uint8_t *)wptr;
+  while(len>0) {
+    *ptr++=color;
+    len--;
+  }
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// pixels xa..xb (inclusive), clipped to xs..xe-1
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_DList_Span(uint8_t *dst, int32_t xa, int32_t xb, int32_t xs, int32_t xe, uint8_t color)
+{
+  if(xa<xs) xa=xs;
+  if(xb>=xe) xb=xe-1;
+  if(xa>xb) return;
+  if(xa==xb) {
+    dst[xa]=color;
+    return;
+  }
+  P_DList_Fill(&dst[xa],xb-xa+1,color);
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// Bresenham line with a=|dx|, d=|dy| (d>0) and err=a-d at the
+// start : the x step (0..a) at which row j (0..d) is left,
+// before the limits of the first and last row
+// (row j is left at the first x step with 2*err <= a)
+//--------------------------------------------------------------
+VGA_RAMFUNC static int32_t P_DList_LineRow(int32_t a, int32_t d, int32_t j)
+{
+  int32_t n=a*(2*j+1)-2*d;
+
+  if(n<=0) return 0;
+  return (n+2*d-1)/(2*d);
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// first x step of row j (the x step of a diagonal step counts
+// for the new row)
+//--------------------------------------------------------------
+VGA_RAMFUNC static int32_t P_DList_LineFirst(int32_t a, int32_t d, int32_t j)
+{
+  int32_t k;
+
+  if(j==0) return 0;
+  k=P_DList_LineRow(a,d,j-1);
+  if((2*(a-d+(j-1)*a-k*d))>=-d) k++;
+  return k;
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// last x step of row j
+//--------------------------------------------------------------
+VGA_RAMFUNC static int32_t P_DList_LineLast(int32_t a, int32_t d, int32_t j)
+{
+  int32_t k,f;
+
+  if(j>=d) return a;
+  k=P_DList_LineRow(a,d,j);
+  f=P_DList_LineFirst(a,d,j);
+  return (k>f) ? k : f;
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// pixels of one item on line y (y_min <= y <= y_max)
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_DList_RenderItem(const VGA_DListItem_t *it, uint8_t *dst, int32_t y, int32_t xs, int32_t xe)
+{
+  int32_t x0=it->x0,y0=it->y0,x1=it->x1,y1=it->y1;
+  int32_t a,d,half,ja,jb,k_lo,k_hi,r,r2,lo,hi,m;
+  uint8_t color=it->color;
+  uint8_t bits,bit;
+  const uint8_t *src;
+
+  switch(it->type) {
+    case VGA_DL_RECT:
+      if(((it->flags & VGA_DL_FILLED)!=0) || (y==y0) || (y==(y0+y1-1))) {
+        P_DList_Span(dst,x0,x0+x1-1,xs,xe,color);
+      }
+      else {
+        P_DList_Span(dst,x0,x0,xs,xe,color);
+        P_DList_Span(dst,x0+x1-1,x0+x1-1,xs,xe,color);
+      }
+      break;
+
+    case VGA_DL_LINE:
+      half=it->size>>1;
+      if((y0==y1) || (x0==x1)) {
+        // horizontal or vertical : the stamps make a rectangle
+        if(x0>x1) { a=x0; x0=x1; x1=a; }
+        P_DList_Span(dst,x0-half,x1+half,xs,xe,color);
+        break;
+      }
+      a=(x1>x0) ? (x1-x0) : (x0-x1);
+      d=(y1>y0) ? (y1-y0) : (y0-y1);
+      // Bresenham rows whose stamp covers line y
+      if(y1>y0) {
+        ja=y-half-y0;
+        jb=y+half-y0;
+      }
+      else {
+        ja=y0-(y+half);
+        jb=y0-(y-half);
+      }
+      if(ja<0) ja=0;
+      if(jb>d) jb=d;
+      if(ja>jb) break;
+      // x steps of these rows, the stamps fill the gaps
+      k_lo=P_DList_LineFirst(a,d,ja);
+      k_hi=P_DList_LineLast(a,d,jb);
+      if(x1>x0) {
+        P_DList_Span(dst,x0+k_lo-half,x0+k_hi+half,xs,xe,color);
+      }
+      else {
+        P_DList_Span(dst,x0-k_hi-half,x0-k_lo+half,xs,xe,color);
+      }
+      break;
+
+    case VGA_DL_CIRCLE:
+      // octant points (x,y) : x = isqrt(r^2-y^2-2y) for y = 0..y1
+      r=(y>y0) ? (y-y0) : (y0-y);
+      r2=x1*x1;
+      if(r<=y1) {
+        // points with y == r
+        m=(int32_t)P_DList_Isqrt((uint32_t)(r2-r*r-2*r));
+        P_DList_Span(dst,x0+m,x0+m,xs,xe,color);
+        P_DList_Span(dst,x0-m,x0-m,xs,xe,color);
+      }
+      // points with x == r : y = lo..hi
+      hi=(int32_t)P_DList_Isqrt((uint32_t)(r2-r*r+1))-1;
+      if(hi>y1) hi=y1;
+      m=r2-(r+1)*(r+1)+1;
+      lo=(m>0) ? (int32_t)P_DList_Isqrt((uint32_t)m) : 0;
+      if(lo<=hi) {
+        P_DList_Span(dst,x0+lo,x0+hi,xs,xe,color);
+        P_DList_Span(dst,x0-hi,x0-lo,xs,xe,color);
+      }
+      break;
+
+    case VGA_DL_CHAR:
+      r=(y-y0)/it->size;
+      bits=it->data[(x1*VGA_DLIST_FONT_SIZE)+r];
+      if(bits==0) break;
+      if((it->flags & VGA_DL_ITALIC)!=0) {
+        // round(r/3*scale)
+        x0+=(2*r*it->size+3)/6;
+      }
+      // bold : the same pixels once more, one scale to the right
+      m=((it->flags & VGA_DL_BOLD)!=0) ? (2*it->size) : it->size;
+      for(bit=0;bit<VGA_DLIST_FONT_SIZE;bit++) {
+        if(((bits>>(7-bit)) & 0x01)==0) continue;
+        a=x0+bit*it->size;
+        P_DList_Span(dst,a,a+m-1,xs,xe,color);
+      }
+      break;
+
+    case VGA_DL_BITMAP:
+      src=&it->data[(y-y0)*x1];
+      lo=(x0>xs) ? x0 : xs;
+      hi=((x0+x1)<xe) ? (x0+x1) : xe;
+      for(m=lo;m<hi;m++) {
+        bits=src[m-x0];
+        if(((it->flags & VGA_DL_TRANSPARENT)!=0) && (bits==0xFF)) continue;
+        dst[m]=bits;
+      }
+      break;
+
+    default:
+      break;
+  }
+}
@@ -0,0 +1,225 @@
+//--------------------------------------------------------------
+// File     : stm32_ub_vga_expand.c
+// CPU      : STM32F4 (and PC for tests)
+// Module   : none
+// Function : line expanders for the palettized scanout modes
+//
+// All functions only work on the buffers they get and use no
+// hardware, so they can be tested and measured on the PC.
+//--------------------------------------------------------------
+
+
+//--------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------
+#include "stm32_ub_vga_expand.h"
+
+
+
+//--------------------------------------------------------------
+// build the pair table of a palette
+// one entry per 4bpp source byte (= 2 pixels) with the two
+// R3G3B2 colors in memory order (left pixel in the low byte)
+// pair_lut : VGA_EXPAND_PAIR_SIZE entries
+// palette  : VGA_EXPAND_PAL_SIZE entries
+//--------------------------------------------------------------
+void UB_VGA_BuildPairLut(uint16_t *pair_lut, const uint8_t *palette)
+{
+  uint16_t n;
+
+  for(n=0;n<VGA_EXPAND_PAIR_SIZE;n++) {
+    pair_lut[n]=(uint16_t)(palette[n>>4] | (palette[n & 0x0F]<<8));
+  }
+}
+
+
+//--------------------------------------------------------------
+// expand one 4bpp line to 8bit R3G3B2
+// dst      : width bytes, must be 4-byte aligned
+// src      : width/2 bytes
+// width    : pixels, must be a multiple of 4
+//
+// 2 source bytes give one 32bit store, 8 pixels per loop
+// (runs from RAM, called by the line interrupt)
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_ExpandLine4bpp(uint8_t *dst, const uint8_t *src, const uint16_t *pair_lut, uint16_t width)
+{
+  uint32_t *wptr=(uint32_t *)dst;
+  uint16_t n=width>>2;
+
+  while(n>=2) {
+    wptr[0]=pair_lut[src[0]] | ((uint32_t)pair_lut[src[1]]<<16);
+    wptr[1]=pair_lut[src[2]] | ((uint32_t)pair_lut[src[3]]<<16);
+    wptr+=2;
+    src+=4;
+    n-=2;
+  }
+  if(n!=0) {
+    wptr[0]=pair_lut[src[0]] | ((uint32_t)pair_lut[src[1]]<<16);
+  }
+}
+
+
+//--------------------------------------------------------------
+// search the palette entry that is closest to an R3G3B2 color
+// (squared distance, blue scaled to 3bit)
+// return : palette index 0..15
+//--------------------------------------------------------------
+uint8_t UB_VGA_NearestIndex(const uint8_t *palette, uint8_t color)
+{
+  return UB_VGA_NearestIndexN(palette,VGA_EXPAND_PAL_SIZE,color);
+}
+
+
+//--------------------------------------------------------------
+// same as UB_VGA_NearestIndex for a palette of count entries
+// return : palette index 0..count-1
+//--------------------------------------------------------------
+uint8_t UB_VGA_NearestIndexN(const uint8_t *palette, uint8_t count, uint8_t color)
+{
+  int16_t dr,dg,db;
+  uint16_t dist,best_dist=0xFFFF;
+  uint8_t n,best=0;
+
+  for(n=0;n<count;n++) {
+    dr=(int16_t)(color>>5)-(int16_t)(palette[n]>>5);
+    dg=(int16_t)((color>>2) & 0x07)-(int16_t)((palette[n]>>2) & 0x07);
+    db=2*((int16_t)(color & 0x03)-(int16_t)(palette[n] & 0x03));
+    dist=(uint16_t)(dr*dr+dg*dg+db*db);
+    if(dist<best_dist) {
+      best_dist=dist;
+      best=n;
+      if(dist==0) break;
+    }
+  }
+  return best;
+}
+
+
+//--------------------------------------------------------------
+// build the table of the 1bpp or 2bpp expander
+// every entry gives 4 pixels as one word in memory order
+// (left pixel in the low byte)
+// lut     : VGA_EXPAND_LUT1_SIZE (bpp=1) or
+//           VGA_EXPAND_LUT2_SIZE (bpp=2) entries
+// palette : 2 (bpp=1) or 4 (bpp=2) entries
+//--------------------------------------------------------------
+void UB_VGA_BuildPackedLut(uint32_t *lut, const uint8_t *palette, uint8_t bpp)
+{
+  uint16_t n,size;
+  uint8_t px,idx;
+
+  size=(bpp==1) ? VGA_EXPAND_LUT1_SIZE : VGA_EXPAND_LUT2_SIZE;
+  for(n=0;n<size;n++) {
+    lut[n]=0;
+    for(px=0;px<4;px++) {
+      if(bpp==1) {
+        idx=(n>>(3-px)) & 0x01;
+      }
+      else {
+        idx=(n>>(6-(2*px))) & 0x03;
+      }
+      lut[n]|=(uint32_t)palette[idx]<<(8*px);
+    }
+  }
+}
+
+
+//--------------------------------------------------------------
+// expand one 1bpp line to 8bit R3G3B2
+// dst      : width bytes, must be 4-byte aligned
+// src      : width/8 bytes
+// width    : pixels, must be a multiple of 8
+//
+// one source byte gives two 32bit stores
+// (runs from RAM, called by the line interrupt)
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_ExpandLine1bpp(uint8_t *dst, const uint8_t *src, const uint32_t *lut, uint16_t width)
+{
+  uint32_t *wptr=(uint32_t *)dst;
+  uint16_t n=width>>3;
+
+  while(n--) {
+    wptr[0]=lut[src[0]>>4];
+    wptr[1]=lut[src[0] & 0x0F];
+    wptr+=2;
+    src++;
+  }
+}
+
+
+//--------------------------------------------------------------
+// expand one 2bpp line to 8bit R3G3B2
+// dst      : width bytes, must be 4-byte aligned
+// src      : width/4 bytes
+// width    : pixels, must be a multiple of 8
+//
+// one source byte gives one 32bit store, 8 pixels per loop
+// (runs from RAM, called by the line interrupt)
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_ExpandLine2bpp(uint8_t *dst, const uint8_t *src, const uint32_t *lut, uint16_t width)
+{
+  uint32_t *wptr=(uint32_t *)dst;
+  uint16_t n=width>>3;
+
+  while(n--) {
+    wptr[0]=lut[src[0]];
+    wptr[1]=lut[src[1]];
+    wptr+=2;
+    src+=2;
+  }
+}
+
+
+//--------------------------------------------------------------
+// build the tables of the text expander
+// nib_mask : VGA_EXPAND_MASK_SIZE entries, 4 font bits -> 4 bytes
+//            0xFF (foreground) or 0x00 (background) in memory
+//            order (left pixel = bit 3 of the nibble = low byte)
+// color32  : VGA_EXPAND_PAL_SIZE entries, palette color in all
+//            4 bytes of a word
+//--------------------------------------------------------------
+void UB_VGA_BuildTextLuts(uint32_t *nib_mask, uint32_t *color32, const uint8_t *palette)
+{
+  uint8_t n,bit;
+
+  for(n=0;n<VGA_EXPAND_MASK_SIZE;n++) {
+    nib_mask[n]=0;
+    for(bit=0;bit<4;bit++) {
+      if((n & (0x08>>bit))!=0) nib_mask[n]|=0xFFUL<<(8*bit);
+    }
+  }
+  for(n=0;n<VGA_EXPAND_PAL_SIZE;n++) {
+    color32[n]=palette[n]*0x01010101UL;
+  }
+}
+
+
+//--------------------------------------------------------------
+// expand one pixel row of a line of text cells to 8bit R3G3B2
+// dst      : cols*8 bytes, must be 4-byte aligned
+// cells    : cols cells (code, attribute)
+// font_row : font + pixel row in the cell (0..7)
+// cols     : cells
+//
+// one font byte gives two 32bit stores, the nibble mask selects
+// foreground or background per byte (no branch per pixel)
+// (runs from RAM, called by the line interrupt)
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_ExpandTextLine(uint8_t *dst, const uint8_t *cells, const uint8_t *font_row,
+                                       const uint32_t *nib_mask, const uint32_t *color32, uint16_t cols)
+{
+  uint32_t *wptr=(uint32_t *)dst;
+  uint32_t bg,diff;
+  uint8_t bits;
+
+  while(cols--) {
+    bits=font_row[cells[0]*VGA_EXPAND_FONT_H];
+    bg=color32[cells[1]>>4];
+    diff=color32[cells[1] & 0x0F]^bg;
+    wptr[0]=bg^(diff & nib_mask[bits>>4]);
+    wptr[1]=bg^(diff & nib_mask[bits & 0x0F]);
+    wptr+=2;
+    cells+=2;
+  }
+}
@@ -3,16 +3,19 @@
 // CPU      : STM32F4
 // IDE      : CooCox CoIDE 1.7.0
 // Module   : GPIO, TIM, MISC, DMA
-// Function : VGA out by GPIO (320x240 Pixel, 8bit color)
+// Function : VGA out by GPIO (320x240 Pixel, 8bit color
+//            or 4bpp palettized double buffer, see VGA_USE_4BPP)
 //
 // signals  : PB11      = HSync-Signal
-//            PB12      = VSync-Signal
+//            PB12      = VSync-Signal (PB0 with VGA_VSYNC_HW)
 //            PE8+PE9   = color Blue
 //            PE10-PE12 = color Green
 //            PE13-PE15 = color red
 //
-// uses     : TIM1, TIM2
+// uses     : TIM1, TIM2 (TIM3 with VGA_VSYNC_HW,
+//                        TIM4 with VGA_SCANOUT_DBM)
 //            DMA2, Channel6, Stream5
+//            (DMA2, Stream0 with VGA_USE_BLIT)
 //--------------------------------------------------------------
 
 
@@ -20,9 +23,81 @@
 // Includes
 //--------------------------------------------------------------
 #include "stm32_ub_vga_screen.h"
+#include "font_pearl_8x8.h"
 
 VGA_t VGA;
-uint8_t VGA_RAM1[(VGA_DISPLAY_X+1)*VGA_DISPLAY_Y];
+static VGA_Dirty_t VGA_Dirty VGA_CCMRAM;
+// video modes (see VGA_Mode_t)
+static const VGA_Mode_t VGA_Modes[VGA_MODE_CNT]={
+  // width,height,line_repeat,pitch,tim1_periode,dma_len,bild_start
+  {VGA_DISPLAY_X,VGA_DISPLAY_Y,VGA_LINE_REPEAT,VGA_PITCH,
+   VGA_TIM1_PERIODE,VGA_DMA_LEN,VGA_VSYNC_BILD_START},
+#if VGA_MODE_CNT>1
+  {VGA_LO_DISPLAY_X,VGA_LO_DISPLAY_Y,VGA_LO_LINE_REPEAT,VGA_LO_PITCH,
+   VGA_LO_TIM1_PERIODE,VGA_LO_DMA_LEN,VGA_VSYNC_BILD_START},
+#endif
+};
+#if VGA_USE_4BPP || VGA_USE_TEXT
+// default palette = the 16 named colors of the API
+static uint8_t VGA_Palette[VGA_EXPAND_PAL_SIZE] VGA_CCMDATA={
+  0x00,0x03,0x07,0x1C,0x1E,0x1F,0xE0,0xE1,
+  0xE3,0xE2,0xAC,0xFC,0x92,0xFF,0xEF,0xA3
+};
+#endif
+#if VGA_USE_4BPP
+uint8_t VGA_FB4[2][VGA_4BPP_PITCH*VGA_DISPLAY_Y] __attribute__((aligned(4)));
+uint8_t VGA_LineBuf[2][VGA_PITCH] __attribute__((aligned(4)));
+// (tables in CCM RAM : the CPU reads them without waiting for the pixel DMA)
+static uint16_t VGA_PairLut[VGA_EXPAND_PAIR_SIZE] VGA_CCMRAM;  // source byte -> 2 pixels
+static uint8_t VGA_ColorIndex[256] VGA_CCMRAM;                 // R3G3B2 -> palette index
+static uint8_t VGA_CopyPending;                     // back buffer not yet updated after a swap
+#elif VGA_USE_DLIST
+// the list is only read by the CPU (CCM RAM), the line buffers by the DMA
+VGA_DList_t VGA_DList VGA_CCMRAM;
+uint8_t VGA_LineBuf[2][VGA_PITCH] __attribute__((aligned(4)));
+#elif VGA_USE_TEXT
+// the cells are only read by the CPU (CCM RAM), the line buffers by the DMA
+uint8_t VGA_Text[VGA_TEXT_ROWS*VGA_TEXT_COLS*2] VGA_CCMRAM;
+uint8_t VGA_LineBuf[2][VGA_PITCH] __attribute__((aligned(4)));
+static uint32_t VGA_NibMask[VGA_EXPAND_MASK_SIZE] VGA_CCMRAM;    // 4 font bits -> 4 byte masks
+static uint32_t VGA_TextColor32[VGA_EXPAND_PAL_SIZE] VGA_CCMRAM; // palette color in all 4 bytes
+static const uint8_t *VGA_TextFont=fontdata_pearl8x8;
+#elif VGA_USE_HIRES
+uint8_t VGA_FBHi[VGA_HIRES_PITCH*VGA_DISPLAY_Y] __attribute__((aligned(4)));
+uint8_t VGA_LineBuf[2][VGA_PITCH] __attribute__((aligned(4)));
+// default palette : black, white (2bpp : + green, red)
+static uint8_t VGA_Palette[VGA_HIRES_COLORS] VGA_CCMDATA={
+#if VGA_HIRES_BPP==1
+  0x00,0xFF
+#else
+  0x00,0xFF,0x1C,0xE0
+#endif
+};
+#if VGA_HIRES_BPP==1
+static uint32_t VGA_HiresLut[VGA_EXPAND_LUT1_SIZE] VGA_CCMRAM;  // 4 source pixels -> 4 bytes
+#else
+static uint32_t VGA_HiresLut[VGA_EXPAND_LUT2_SIZE] VGA_CCMRAM;  // 4 source pixels -> 4 bytes
+#endif
+static uint8_t VGA_ColorIndex[256] VGA_CCMRAM;                 // R3G3B2 -> palette index
+#else
+uint8_t VGA_RAM1[VGA_PITCH*VGA_DISPLAY_Y] __attribute__((aligned(4)));
+// buffer line of every screen line, the scanout reads [VGA.tab_front]
+// (CCM RAM : only the CPU reads it, the DMA gets the address)
+static uint16_t VGA_LineTab[2][VGA_DISPLAY_Y] VGA_CCMRAM;
+static uint8_t VGA_TabCopyPending;                  // back table not yet updated after a swap
+#endif
+#if VGA_HAS_BLIT
+// job of the DMA blitter (only read by the CPU)
+static VGA_Blit_t VGA_Blit VGA_CCMRAM;
+static void (*VGA_BlitCallback)(void);
+// fill pattern, read by the DMA (not in the CCM RAM, DMA2 can not reach it)
+static uint32_t VGA_BlitPattern;
+#endif
+#if VGA_ISR_PROFILE
+// DWT cycle counter (core_cm4.h of this project has no DWT)
+#define VGA_DWT_CYCCNT   (*(volatile uint32_t *)0xE0001004)
+static volatile VGA_IsrProfile_t VGA_IsrProfile={0,0,0,0xFFFFFFFF,0};
+#endif
 //--------------------------------------------------------------
 // internal Functions
 //--------------------------------------------------------------
@@ -30,6 +105,44 @@ void P_VGA_InitIO(void);
 void P_VGA_InitTIM(void);
 void P_VGA_InitINT(void);
 void P_VGA_InitDMA(void);
+#if (VGA_USE_DLIST==0) && (VGA_USE_TEXT==0)
+VGA_RAMFUNC static void P_VGA_FillRow(uint8_t *ptr, uint16_t len, uint8_t color);
+#endif
+VGA_RAMFUNC static void P_VGA_MarkDirty(uint16_t yp, uint16_t x_min, uint16_t x_max);
+VGA_RAMFUNC static void P_VGA_PutSpan(uint16_t xp, uint16_t yp, uint16_t len, uint8_t color);
+#if VGA_HAS_SCROLL
+VGA_RAMFUNC static uint16_t P_VGA_Row(uint16_t yp);
+#endif
+#if VGA_HAS_LINETAB
+static void P_VGA_DefaultTab(uint16_t *tab, uint16_t scroll);
+static void P_VGA_FinishTab(void);
+#endif
+#if VGA_HAS_COPY
+VGA_RAMFUNC static void P_VGA_CopyRow(uint8_t *dst, const uint8_t *src, uint16_t len);
+#endif
+#if VGA_HAS_BLIT
+static void P_VGA_InitBlit(void);
+static void P_VGA_BlitStart(uint8_t op, uint16_t xs, uint16_t ys, uint16_t w, uint16_t h,
+                            uint16_t xd, uint16_t yd, uint8_t color);
+VGA_RAMFUNC static void P_VGA_BlitNext(void);
+#endif
+#if VGA_USE_4BPP || VGA_USE_TEXT || VGA_USE_HIRES
+static void P_VGA_BuildLuts(void);
+#endif
+#if VGA_USE_4BPP
+static void P_VGA_FinishFlip(void);
+#endif
+#if VGA_USE_TEXT
+VGA_RAMFUNC static void P_VGA_TextCell(uint16_t col, uint16_t row, uint8_t code, uint8_t attr);
+VGA_RAMFUNC static void P_VGA_TextLine(uint8_t *dst, uint16_t yp);
+#endif
+#if VGA_USE_HIRES
+VGA_RAMFUNC static void P_VGA_HiresLine(uint8_t *dst, uint16_t yp);
+#endif
+#if VGA_SCANOUT_DBM
+VGA_RAMFUNC static uint32_t P_VGA_LineAdr(uint16_t line);
+VGA_RAMFUNC static void P_VGA_DbmLine(uint16_t line);
+#endif
 
 
 //--------------------------------------------------------------
@@ -42,58 +155,1461 @@ void UB_VGA_Screen_Init(void)
   VGA.hsync_cnt=0;
   VGA.start_adr=0;
   VGA.dma2_cr_reg=0;
+  VGA.frame_cnt=0;
+  VGA.src_row=0;
+  VGA.front=0;
+  VGA.flip=0;
+  VGA.mode=VGA_Modes[VGA_MODE_DEFAULT];
+  VGA.mode_id=VGA_MODE_DEFAULT;
+  VGA.line_cnt=0;
+  VGA.scroll=0;
+  VGA.tab_front=0;
+  VGA.tab_flip=0;
+  VGA.blit_busy=0;
+
+#if VGA_USE_4BPP
+  P_VGA_BuildLuts();
+  // both buffers index 0 (black), line buffers total black
+  for(yp=0;yp<VGA_DISPLAY_Y;yp++) {
+    for(xp=0;xp<VGA_4BPP_PITCH;xp++) {
+      VGA_FB4[0][(yp*VGA_4BPP_PITCH)+xp]=0;
+      VGA_FB4[1][(yp*VGA_4BPP_PITCH)+xp]=0;
+    }
+    P_VGA_MarkDirty(yp,0,VGA_DISPLAY_X-1);
+  }
+  for(xp=0;xp<VGA_PITCH;xp++) {
+    VGA_LineBuf[0][xp]=0;
+    VGA_LineBuf[1][xp]=0;
+  }
+#elif VGA_USE_DLIST
+  // empty list (black), line buffers total black
+  UB_VGA_DListInit(&VGA_DList,0);
+  for(xp=0;xp<VGA_PITCH;xp++) {
+    VGA_LineBuf[0][xp]=0;
+    VGA_LineBuf[1][xp]=0;
+  }
+  for(yp=0;yp<VGA_DISPLAY_Y;yp++) {
+    P_VGA_MarkDirty(yp,0,VGA_DISPLAY_X-1);
+  }
+#elif VGA_USE_TEXT
+  P_VGA_BuildLuts();
+  // all cells empty (white on black), line buffers total black
+  for(yp=0;yp<VGA_TEXT_ROWS;yp++) {
+    for(xp=0;xp<VGA_TEXT_COLS;xp++) {
+      P_VGA_TextCell(xp,yp,' ',VGA_TEXT_ATTR_DEFAULT);
+    }
+  }
+  for(xp=0;xp<VGA_PITCH;xp++) {
+    VGA_LineBuf[0][xp]=0;
+    VGA_LineBuf[1][xp]=0;
+  }
+#elif VGA_USE_HIRES
+  P_VGA_BuildLuts();
+  // buffer index 0 (black), line buffers total black
+  for(yp=0;yp<VGA_DISPLAY_Y;yp++) {
+    for(xp=0;xp<VGA_HIRES_PITCH;xp++) {
+      VGA_FBHi[(yp*VGA_HIRES_PITCH)+xp]=0;
+    }
+    P_VGA_MarkDirty(yp,0,VGA_DISPLAY_X-1);
+  }
+  for(xp=0;xp<VGA_PITCH;xp++) {
+    VGA_LineBuf[0][xp]=0;
+    VGA_LineBuf[1][xp]=0;
+  }
+#else
+  // RAM init total black (including the padding of every line)
+  for(yp=0;yp<VGA_DISPLAY_Y;yp++) {
+    for(xp=0;xp<VGA_PITCH;xp++) {
+      VGA_RAM1[(yp*VGA_PITCH)+xp]=0;
+    }
+    // the whole screen is new for any consumer
+    P_VGA_MarkDirty(yp,0,VGA_DISPLAY_X-1);
+  }
+  // both line tables : line y shows buffer line y
+  P_VGA_DefaultTab(VGA_LineTab[0],0);
+  P_VGA_DefaultTab(VGA_LineTab[1],0);
+  VGA_TabCopyPending=0;
+#endif
+
+  // init IO-Pins
+  P_VGA_InitIO();
+  // init Timer
+  P_VGA_InitTIM();
+  // init DMA
+  P_VGA_InitDMA();
+  // init Interrupts
+  P_VGA_InitINT();
+#if VGA_HAS_BLIT
+  // init DMA blitter
+  P_VGA_InitBlit();
+#endif
+
+  //-----------------------
+  // Register swap and safe
+  //-----------------------
+  // content of CR-Register read and save
+  VGA.dma2_cr_reg=DMA2_Stream5->CR;
+}
+
+
+//--------------------------------------------------------------
+// fill the DMA RAM buffer with one color
+//--------------------------------------------------------------
+void UB_VGA_FillScreen(uint8_t color)
+{
+#if VGA_USE_DLIST
+  uint16_t yp;
+
+  // all items are hidden anyway : start with an empty list
+  UB_VGA_DListInit(&VGA_DList,color);
+  for(yp=0;yp<VGA_DISPLAY_Y;yp++) {
+    P_VGA_MarkDirty(yp,0,VGA_DISPLAY_X-1);
+  }
+#else
+  UB_VGA_FillRect(0,0,VGA.mode.width,VGA.mode.height,color);
+#endif
+}
+
+
+//--------------------------------------------------------------
+// put one Pixel on the screen with one color
+// (the padding behind every line is never written, see VGA_PITCH)
+// (runs from RAM, like all pixel kernels)
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_SetPixel(uint16_t xp, uint16_t yp, uint8_t color)
+{
+  if(xp>=VGA.mode.width) xp=0;
+  if(yp>=VGA.mode.height) yp=0;
+
+  // Write pixel to ram
+  P_VGA_PutSpan(xp,yp,1,color);
+  P_VGA_MarkDirty(yp,xp,xp);
+}
+
+
+//--------------------------------------------------------------
+// draw a horizontal line of len pixels starting at xp,yp
+// (clipped at the right border)
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_DrawHLine(uint16_t xp, uint16_t yp, uint16_t len, uint8_t color)
+{
+  if((xp>=VGA.mode.width) || (yp>=VGA.mode.height)) return;
+  if(len>(VGA.mode.width-xp)) len=VGA.mode.width-xp;
+  if(len==0) return;
+
+  P_VGA_PutSpan(xp,yp,len,color);
+  P_VGA_MarkDirty(yp,xp,xp+len-1);
+}
+
+
+//--------------------------------------------------------------
+// draw a vertical line of len pixels starting at xp,yp
+// (clipped at the bottom border)
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_DrawVLine(uint16_t xp, uint16_t yp, uint16_t len, uint8_t color)
+{
+#if VGA_USE_DLIST
+  // one item for the whole line
+  UB_VGA_FillRect(xp,yp,1,len,color);
+#elif VGA_USE_4BPP || VGA_USE_TEXT || VGA_USE_HIRES
+  if((xp>=VGA.mode.width) || (yp>=VGA.mode.height)) return;
+  if(len>(VGA.mode.height-yp)) len=VGA.mode.height-yp;
+
+  while(len--) {
+    P_VGA_PutSpan(xp,yp,1,color);
+    P_VGA_MarkDirty(yp++,xp,xp);
+  }
+#else
+  uint8_t *ptr;
+  uint16_t row;
+
+  if((xp>=VGA.mode.width) || (yp>=VGA.mode.height)) return;
+  if(len>(VGA.mode.height-yp)) len=VGA.mode.height-yp;
+#if VGA_HAS_BLIT
+  UB_VGA_BlitWait();
+#endif
+
+  row=P_VGA_Row(yp);
+  ptr=&VGA_RAM1[(row*VGA.mode.pitch)+xp];
+  while(len--) {
+    *ptr=color;
+    ptr+=VGA.mode.pitch;
+    // last line of the ring -> first line
+    if(++row>=VGA.mode.height) {
+      row=0;
+      ptr=&VGA_RAM1[xp];
+    }
+    P_VGA_MarkDirty(yp++,xp,xp);
+  }
+#endif
+}
+
+
+//--------------------------------------------------------------
+// fill a rectangle of w*h pixels with its top left corner at xp,yp
+// (clipped at the right and bottom border)
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_FillRect(uint16_t xp, uint16_t yp, uint16_t w, uint16_t h, uint8_t color)
+{
+  if((xp>=VGA.mode.width) || (yp>=VGA.mode.height)) return;
+  if(w>(VGA.mode.width-xp)) w=VGA.mode.width-xp;
+  if(h>(VGA.mode.height-yp)) h=VGA.mode.height-yp;
+
+  if((w==0) || (h==0)) return;
+
+#if VGA_USE_DLIST
+  // one item for the whole rectangle
+  UB_VGA_DListRect(&VGA_DList,xp,yp,w,h,color,1);
+  while(h--) {
+    P_VGA_MarkDirty(yp++,xp,xp+w-1);
+  }
+#elif VGA_USE_TEXT
+  {
+    // all cells the rectangle touches : empty, background = color
+    uint8_t bg=UB_VGA_NearestIndex(VGA_Palette,color);
+    uint16_t col,row;
+    uint8_t *cell;
+
+    for(row=yp/VGA_TEXT_CELL;row<=(yp+h-1)/VGA_TEXT_CELL;row++) {
+      for(col=xp/VGA_TEXT_CELL;col<=(xp+w-1)/VGA_TEXT_CELL;col++) {
+        cell=&VGA_Text[((row*VGA_TEXT_COLS)+col)*2];
+        P_VGA_TextCell(col,row,' ',VGA_TEXT_ATTR(cell[1] & 0x0F,bg));
+      }
+    }
+  }
+#else
+#if VGA_HAS_BLIT
+  if((w>=VGA_BLIT_MIN_W) && (((uint32_t)w*h)>=VGA_BLIT_MIN_PIXELS)) {
+    // DMA blitter, returns after the first line is started
+    P_VGA_BlitStart(VGA_BLIT_FILL,0,0,w,h,xp,yp,color);
+    while(h--) {
+      P_VGA_MarkDirty(yp++,xp,xp+w-1);
+    }
+    return;
+  }
+#endif
+  while(h--) {
+    P_VGA_PutSpan(xp,yp,w,color);
+    P_VGA_MarkDirty(yp++,xp,xp+w-1);
+  }
+#endif
+}
+
+
+//--------------------------------------------------------------
+// write len pixels (R3G3B2) from src to the line yp, starting at xp
+// (clipped at the right border, used to blit off-screen buffers)
+//--------------------------------------------------------------
+VGA_RAMFUNC void UB_VGA_PutRow(uint16_t xp, uint16_t yp, const uint8_t *src, uint16_t len)
+{
+  if((xp>=VGA.mode.width) || (yp>=VGA.mode.height)) return;
+  if(len>(VGA.mode.width-xp)) len=VGA.mode.width-xp;
+  if(len==0) return;
+
+#if VGA_HAS_COPY
+#if VGA_HAS_BLIT
+  UB_VGA_BlitWait();
+#endif
+  P_VGA_CopyRow(&VGA_RAM1[(P_VGA_Row(yp)*VGA.mode.pitch)+xp],src,len);
+  P_VGA_MarkDirty(yp,xp,xp+len-1);
+#else
+  {
+    // no plain byte buffer : one span per pixel (color conversion)
+    uint16_t n;
+
+    for(n=0;n<len;n++) {
+      P_VGA_PutSpan(xp+n,yp,1,src[n]);
+    }
+    P_VGA_MarkDirty(yp,xp,xp+len-1);
+  }
+#endif
+}
+
+
+//--------------------------------------------------------------
+// read the dirty state of one line
+// return : 1 = line changed since the last clear
+//              (x_min/x_max = changed column range)
+//          0 = line unchanged
+//--------------------------------------------------------------
+uint8_t UB_VGA_GetDirtyRow(uint16_t yp, uint16_t *x_min, uint16_t *x_max)
+{
+  if(yp>=VGA.mode.height) return 0;
+  if((VGA_Dirty.rows[yp>>5] & (1UL<<(yp & 0x1F)))==0) return 0;
+
+  if(x_min!=0) *x_min=VGA_Dirty.x_min[yp];
+  if(x_max!=0) *x_max=VGA_Dirty.x_max[yp];
+  return 1;
+}
+
+
+//--------------------------------------------------------------
+// search the first dirty line from yp on
+// (skips 32 clean lines per bitmap word)
+// return : line number or -1 if no more dirty lines
+//--------------------------------------------------------------
+int16_t UB_VGA_NextDirtyRow(uint16_t yp)
+{
+  uint32_t bits;
+
+  while(yp<VGA.mode.height) {
+    bits=VGA_Dirty.rows[yp>>5] >> (yp & 0x1F);
+    if(bits==0) {
+      // rest of this word clean -> next word
+      yp=(yp|0x1F)+1;
+      continue;
+    }
+    while((bits & 0x01)==0) {
+      bits>>=1;
+      yp++;
+    }
+    return (yp<VGA.mode.height) ? (int16_t)yp : -1;
+  }
+  return -1;
+}
+
+
+//--------------------------------------------------------------
+// mark one line as clean
+//--------------------------------------------------------------
+void UB_VGA_ClearDirtyRow(uint16_t yp)
+{
+  if(yp>=VGA.mode.height) return;
+  VGA_Dirty.rows[yp>>5]&=~(1UL<<(yp & 0x1F));
+}
+
+
+//--------------------------------------------------------------
+// mark the whole screen as clean
+//--------------------------------------------------------------
+void UB_VGA_ClearDirty(void)
+{
+  uint16_t n;
+
+  for(n=0;n<VGA_DIRTY_WORDS;n++) {
+    VGA_Dirty.rows[n]=0;
+  }
+}
+
+
+//--------------------------------------------------------------
+// number of frames since init
+// (+1 at the start of every vertical blanking, 60Hz)
+//--------------------------------------------------------------
+uint32_t UB_VGA_GetFrameCount(void)
+{
+  return VGA.frame_cnt;
+}
+
+
+//--------------------------------------------------------------
+// test if the beam is outside the visible window
+// return : 1 = vertical blanking, 0 = visible lines
+//--------------------------------------------------------------
+uint8_t UB_VGA_InVBlank(void)
+{
+  uint16_t line=VGA.hsync_cnt;
+
+  if((line<VGA.mode.bild_start) || (line>VGA_VSYNC_BILD_STOP)) return 1;
+  return 0;
+}
+
+
+//--------------------------------------------------------------
+// wait for the start of the next vertical blanking
+// (max. one frame = 16,7ms, then 46 blank lines = 1,46ms
+//  before the visible window starts again)
+//--------------------------------------------------------------
+void UB_VGA_WaitVBlank(void)
+{
+  uint32_t start=VGA.frame_cnt;
+
+  while(VGA.frame_cnt==start) {
+    // wait for TIM2-Interrupt
+  }
+}
+
+
+//--------------------------------------------------------------
+// show the drawn back buffer (4bpp mode) and wait for it
+// the buffers are swapped at the next vertical blanking (max.
+// one frame = 16,7ms). After the swap the new back buffer gets
+// a copy of the visible picture, so drawing goes on where it was.
+// 8bit mode : every write is visible at once, only waits for
+//             the DMA blitter (see VGA_USE_BLIT)
+//--------------------------------------------------------------
+void UB_VGA_Present(void)
+{
+#if VGA_USE_4BPP
+  UB_VGA_PresentAsync();
+  P_VGA_FinishFlip();
+#elif VGA_HAS_BLIT
+  UB_VGA_BlitWait();
+#endif
+}
+
+
+//--------------------------------------------------------------
+// show the drawn back buffer (4bpp mode) without waiting
+// the swap is done by the TIM2-Interrupt at the next vertical
+// blanking. The next draw function (or Present) waits for it
+// and copies the visible picture, so the CPU is free until then.
+// 8bit mode : nothing to do
+//--------------------------------------------------------------
+void UB_VGA_PresentAsync(void)
+{
+#if VGA_USE_4BPP
+  // a swap that is still pending must be finished first
+  P_VGA_FinishFlip();
+  VGA_CopyPending=1;
+  VGA.flip=1;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// test if a swap from UB_VGA_PresentAsync() is still pending
+// return : 1 = not yet swapped, 0 = done
+//--------------------------------------------------------------
+uint8_t UB_VGA_PresentBusy(void)
+{
+  return (VGA.flip!=0) ? 1 : 0;
+}
+
+
+//--------------------------------------------------------------
+// change one palette entry (4bpp, text and hires mode)
+// index : 0..15 (hires : 0..VGA_HIRES_COLORS-1)
+// color : R3G3B2 color
+// pixels already drawn with this index change color too
+// 8bit mode : nothing to do
+//--------------------------------------------------------------
+void UB_VGA_SetPalette(uint8_t index, uint8_t color)
+{
+#if VGA_USE_4BPP || VGA_USE_TEXT || VGA_USE_HIRES
+  if(index>=sizeof(VGA_Palette)) return;
+
+  VGA_Palette[index]=color;
+  P_VGA_BuildLuts();
+#else
+  (void)index;
+  (void)color;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// select the font of the text mode (8 bytes per character,
+// 256 characters). All cells use the same font.
+// other modes : nothing to do
+//--------------------------------------------------------------
+void UB_VGA_TextSetFont(const uint8_t *font)
+{
+#if VGA_USE_TEXT
+  uint16_t yp;
+
+  if((font==0) || (font==VGA_TextFont)) return;
+
+  VGA_TextFont=font;
+  for(yp=0;yp<VGA_DISPLAY_Y;yp++) {
+    P_VGA_MarkDirty(yp,0,VGA_DISPLAY_X-1);
+  }
+#else
+  (void)font;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// write one cell of the text mode
+// col,row : cell (0..VGA_TEXT_COLS-1, 0..VGA_TEXT_ROWS-1)
+// attr    : VGA_TEXT_ATTR(foreground index, background index)
+// other modes : nothing to do
+//--------------------------------------------------------------
+void UB_VGA_TextPut(uint16_t col, uint16_t row, uint8_t code, uint8_t attr)
+{
+#if VGA_USE_TEXT
+  if((col>=VGA_TEXT_COLS) || (row>=VGA_TEXT_ROWS)) return;
+
+  P_VGA_TextCell(col,row,code,attr);
+#else
+  (void)col;
+  (void)row;
+  (void)code;
+  (void)attr;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// write one character of the text mode, the background of the
+// cell stays
+// color : R3G3B2, drawn with the nearest palette color
+// other modes : nothing to do
+//--------------------------------------------------------------
+void UB_VGA_TextChar(uint16_t col, uint16_t row, uint8_t code, uint8_t color)
+{
+#if VGA_USE_TEXT
+  uint8_t bg;
+
+  if((col>=VGA_TEXT_COLS) || (row>=VGA_TEXT_ROWS)) return;
+
+  bg=VGA_Text[((row*VGA_TEXT_COLS)+col)*2+1]>>4;
+  P_VGA_TextCell(col,row,code,VGA_TEXT_ATTR(UB_VGA_NearestIndex(VGA_Palette,color),bg));
+#else
+  (void)col;
+  (void)row;
+  (void)code;
+  (void)color;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// switch the video mode (VGA_MODE_xxx)
+// waits for the next vertical blanking, then the new geometry
+// and pixel clock are used from the first visible line on.
+// the screen is black after the switch (the whole screen dirty)
+// return : 0 = ok, 1 = no such mode
+//--------------------------------------------------------------
+uint8_t UB_VGA_SetMode(uint8_t mode)
+{
+#if VGA_MODE_CNT>1
+  uint16_t yp;
+#endif
+
+  if(mode>=VGA_MODE_CNT) return 1;
+  if(mode==VGA.mode_id) return 0;
+
+#if VGA_MODE_CNT>1
+  // the blitter uses the geometry of the old mode
+  UB_VGA_BlitWait();
+  // the line interrupt reads the descriptor only in the visible lines
+  UB_VGA_WaitVBlank();
+  VGA.mode=VGA_Modes[mode];
+  VGA.mode_id=mode;
+  VGA.scroll=0;
+
+  // both line tables default, a swap that is still pending is dropped
+  // (first : the line interrupt reads the table at line 0)
+  P_VGA_DefaultTab(VGA_LineTab[0],0);
+  P_VGA_DefaultTab(VGA_LineTab[1],0);
+  VGA.tab_flip=0;
+  VGA_TabCopyPending=0;
+
+  // new pixel clock, loaded at once (the DMA is off in the blanking)
+  TIM1->ARR=VGA.mode.tim1_periode;
+  TIM1->EGR=TIM_EGR_UG;
+
+  // all lines of the buffer black, the padding of the new pitch too
+  for(yp=0;yp<VGA_DISPLAY_Y;yp++) {
+    P_VGA_FillRow(&VGA_RAM1[yp*VGA_PITCH],VGA_PITCH,0);
+  }
+  UB_VGA_ClearDirty();
+  for(yp=0;yp<VGA.mode.height;yp++) {
+    P_VGA_MarkDirty(yp,0,VGA.mode.width-1);
+  }
+#endif
+  return 0;
+}
+
+
+//--------------------------------------------------------------
+// descriptor of the active video mode
+//--------------------------------------------------------------
+const VGA_Mode_t *UB_VGA_GetMode(void)
+{
+  return &VGA.mode;
+}
+
+
+//--------------------------------------------------------------
+// search the video mode with this width
+// return : VGA_MODE_xxx or -1 if there is none
+//--------------------------------------------------------------
+int16_t UB_VGA_FindMode(uint16_t width)
+{
+  int16_t n;
+
+  for(n=0;n<VGA_MODE_CNT;n++) {
+    if(VGA_Modes[n].width==width) return n;
+  }
+  return -1;
+}
+
+
+//--------------------------------------------------------------
+// scroll the picture up by lines (lines<0 : down)
+// only the start line of the scanout changes (see VGA_HAS_SCROLL),
+// the lines that come in at the bottom (top) are filled with color.
+// waits for the next vertical blanking, so the filled lines are
+// never seen at their old place
+// return : 0 = ok, 1 = no scroll in this mode or |lines|>=height
+//--------------------------------------------------------------
+uint8_t UB_VGA_Scroll(int16_t lines, uint8_t color)
+{
+#if VGA_HAS_SCROLL
+  uint16_t h=VGA.mode.height;
+  uint16_t n,yp,scroll;
+
+  if((lines<=-(int16_t)h) || (lines>=(int16_t)h)) return 1;
+  if(lines==0) return 0;
+
+  if(lines>0) {
+    n=(uint16_t)lines;
+    scroll=(VGA.scroll+n)%h;
+  }
+  else {
+    n=(uint16_t)(-lines);
+    scroll=(VGA.scroll+h-n)%h;
+  }
+
+  // the blitter uses the old offset
+  UB_VGA_BlitWait();
+
+#if VGA_HAS_LINETAB
+  // default line table with the new offset (h entries, no pixels)
+  P_VGA_FinishTab();
+  P_VGA_DefaultTab(VGA_LineTab[VGA.tab_front^1],scroll);
+#endif
+
+  // the line interrupt takes the offset at the start of the frame
+  UB_VGA_WaitVBlank();
+  VGA.scroll=scroll;
+#if VGA_HAS_LINETAB
+  VGA_TabCopyPending=1;
+  VGA.tab_flip=1;
+#endif
+  if(lines>0) {
+    // the old top lines come in at the bottom
+    UB_VGA_FillRect(0,h-n,VGA.mode.width,n,color);
+  }
+  else {
+    // the old bottom lines come in at the top
+    UB_VGA_FillRect(0,0,VGA.mode.width,n,color);
+  }
+
+  // every line of the screen shows other pixels now
+  for(yp=0;yp<h;yp++) {
+    P_VGA_MarkDirty(yp,0,VGA.mode.width-1);
+  }
+  return 0;
+#else
+  (void)lines;
+  (void)color;
+  return 1;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// set one entry of the line table (see VGA_HAS_LINETAB)
+// screen line yp shows buffer line row of VGA_RAM1 (with the
+// pitch of the active mode, so it can be behind the visible
+// lines). Visible after UB_VGA_LineTabApply()
+// return : 0 = ok, 1 = no line table or out of range
+//--------------------------------------------------------------
+uint8_t UB_VGA_LineTabSet(uint16_t yp, uint16_t row)
+{
+#if VGA_HAS_LINETAB
+  if(yp>=VGA.mode.height) return 1;
+  if(((uint32_t)row+1)*VGA.mode.pitch>sizeof(VGA_RAM1)) return 1;
+
+  P_VGA_FinishTab();
+  VGA_LineTab[VGA.tab_front^1][yp]=row;
+  return 0;
+#else
+  (void)yp;
+  (void)row;
+  return 1;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// read one entry of the line table that is set up
+// return : buffer line or -1 (no line table or out of range)
+//--------------------------------------------------------------
+int16_t UB_VGA_LineTabGet(uint16_t yp)
+{
+#if VGA_HAS_LINETAB
+  if(yp>=VGA.mode.height) return -1;
+
+  P_VGA_FinishTab();
+  return (int16_t)VGA_LineTab[VGA.tab_front^1][yp];
+#else
+  (void)yp;
+  return -1;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// set up the default line table : screen line y shows the buffer
+// line the draw functions write (y + VGA.scroll)
+// visible after UB_VGA_LineTabApply()
+//--------------------------------------------------------------
+void UB_VGA_LineTabReset(void)
+{
+#if VGA_HAS_LINETAB
+  P_VGA_FinishTab();
+  P_VGA_DefaultTab(VGA_LineTab[VGA.tab_front^1],VGA.scroll);
+#endif
+}
+
+
+//--------------------------------------------------------------
+// show the line table that is set up
+// the tables are swapped at the next vertical blanking, without
+// waiting. The next LineTab function waits for the swap and
+// copies the new table, so changes go on from there.
+//--------------------------------------------------------------
+void UB_VGA_LineTabApply(void)
+{
+#if VGA_HAS_LINETAB
+  P_VGA_FinishTab();
+  VGA_TabCopyPending=1;
+  VGA.tab_flip=1;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// copy w*h pixels from xs,ys to xd,yd (see VGA_HAS_COPY)
+// source and destination may overlap, the result is the same
+// as with a copy through a second buffer.
+// (clipped at the right and bottom border, for both rectangles)
+// return : 0 = ok, 1 = no copy in this mode
+//--------------------------------------------------------------
+uint8_t UB_VGA_CopyRect(uint16_t xs, uint16_t ys, uint16_t w, uint16_t h, uint16_t xd, uint16_t yd)
+{
+#if VGA_HAS_COPY
+  uint16_t n;
+  int16_t step;
+
+  if((xs>=VGA.mode.width) || (ys>=VGA.mode.height)) return 0;
+  if((xd>=VGA.mode.width) || (yd>=VGA.mode.height)) return 0;
+  if(w>(VGA.mode.width-xs)) w=VGA.mode.width-xs;
+  if(w>(VGA.mode.width-xd)) w=VGA.mode.width-xd;
+  if(h>(VGA.mode.height-ys)) h=VGA.mode.height-ys;
+  if(h>(VGA.mode.height-yd)) h=VGA.mode.height-yd;
+
+  if((w==0) || (h==0)) return 0;
+  if((xs==xd) && (ys==yd)) return 0;
+
+#if VGA_HAS_BLIT
+  if((ys!=yd) && (w>=VGA_BLIT_MIN_W) && (((uint32_t)w*h)>=VGA_BLIT_MIN_PIXELS)) {
+    // DMA blitter (same order of the lines as below)
+    P_VGA_BlitStart(VGA_BLIT_COPY,xs,ys,w,h,xd,yd,0);
+    for(n=0;n<h;n++) {
+      P_VGA_MarkDirty(yd+n,xd,xd+w-1);
+    }
+    return 0;
+  }
+  UB_VGA_BlitWait();
+#endif
+
+  // destination lower : bottom up, so no source line is
+  // overwritten before it is read
+  if(yd>ys) {
+    ys+=h-1;
+    yd+=h-1;
+    step=-1;
+  }
+  else {
+    step=1;
+  }
+
+  for(n=0;n<h;n++) {
+    P_VGA_CopyRow(&VGA_RAM1[(P_VGA_Row(yd)*VGA.mode.pitch)+xd],
+                  &VGA_RAM1[(P_VGA_Row(ys)*VGA.mode.pitch)+xs],w);
+    P_VGA_MarkDirty(yd,xd,xd+w-1);
+    ys+=step;
+    yd+=step;
+  }
+  return 0;
+#else
+  (void)xs;
+  (void)ys;
+  (void)w;
+  (void)h;
+  (void)xd;
+  (void)yd;
+  return 1;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// test if the DMA blitter is still running (see VGA_USE_BLIT)
+// return : 1 = busy, 0 = done (or no blitter)
+//--------------------------------------------------------------
+uint8_t UB_VGA_BlitBusy(void)
+{
+  return (VGA.blit_busy!=0) ? 1 : 0;
+}
+
+
+//--------------------------------------------------------------
+// wait until the DMA blitter is done
+// (max. one full screen fill, ~77000 bytes)
+//--------------------------------------------------------------
+void UB_VGA_BlitWait(void)
+{
+  while(VGA.blit_busy!=0) {
+    // wait for the DMA2 Stream0-Interrupt
+  }
+}
+
+
+//--------------------------------------------------------------
+// set the function that is called when a blitter job is done
+// (called in the DMA2 Stream0-Interrupt, keep it short)
+// callback : function or 0 = none
+//--------------------------------------------------------------
+void UB_VGA_BlitSetCallback(void (*callback)(void))
+{
+#if VGA_HAS_BLIT
+  VGA_BlitCallback=callback;
+#else
+  (void)callback;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// read the cycle profile of the line interrupt
+// (all zero without VGA_ISR_PROFILE)
+//--------------------------------------------------------------
+void UB_VGA_GetIsrProfile(VGA_IsrProfile_t *prof)
+{
+#if VGA_ISR_PROFILE
+  prof->cnt=VGA_IsrProfile.cnt;
+  prof->sum=VGA_IsrProfile.sum;
+  prof->max=VGA_IsrProfile.max;
+  prof->lat_min=VGA_IsrProfile.lat_min;
+  prof->lat_max=VGA_IsrProfile.lat_max;
+#else
+  prof->cnt=0;
+  prof->sum=0;
+  prof->max=0;
+  prof->lat_min=0;
+  prof->lat_max=0;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// restart the cycle profile of the line interrupt
+//--------------------------------------------------------------
+void UB_VGA_ResetIsrProfile(void)
+{
+#if VGA_ISR_PROFILE
+  VGA_IsrProfile.cnt=0;
+  VGA_IsrProfile.sum=0;
+  VGA_IsrProfile.max=0;
+  VGA_IsrProfile.lat_min=0xFFFFFFFF;
+  VGA_IsrProfile.lat_max=0;
+#endif
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// write len pixels of one color from xp,yp to the draw buffer
+// (no clipping, the caller has checked the range)
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_VGA_PutSpan(uint16_t xp, uint16_t yp, uint16_t len, uint8_t color)
+{
+#if VGA_USE_4BPP
+  uint8_t idx=VGA_ColorIndex[color];
+  uint8_t *ptr;
+
+  if(VGA_CopyPending!=0) P_VGA_FinishFlip();
+  ptr=&VGA_FB4[VGA.front^1][(yp*VGA_4BPP_PITCH)+(xp>>1)];
+
+  // odd start : right pixel (low nibble) of the first byte
+  if((xp & 0x01)!=0) {
+    *ptr=(*ptr & 0xF0) | idx;
+    ptr++;
+    len--;
+  }
+  // full bytes (2 pixels each)
+  P_VGA_FillRow(ptr,len>>1,(uint8_t)(idx*0x11));
+  // odd end : left pixel (high nibble) of the last byte
+  if((len & 0x01)!=0) {
+    ptr+=len>>1;
+    *ptr=(*ptr & 0x0F) | (uint8_t)(idx<<4);
+  }
+#elif VGA_USE_DLIST
+  UB_VGA_DListRect(&VGA_DList,xp,yp,len,1,color,1);
+#elif VGA_USE_TEXT
+  // no single pixels in the text mode
+  (void)xp;
+  (void)yp;
+  (void)len;
+  (void)color;
+#elif VGA_USE_HIRES
+  uint8_t fill=(uint8_t)(VGA_ColorIndex[color]*((VGA_HIRES_BPP==1) ? 0xFF : 0x55));
+  uint8_t *ptr=&VGA_FBHi[(P_VGA_Row(yp)*VGA_HIRES_PITCH)+(xp/VGA_HIRES_PPB)];
+  uint16_t first=xp%VGA_HIRES_PPB;
+  uint16_t n;
+  uint8_t mask;
+
+  // head : pixels in the first byte (bit mask)
+  if(first!=0) {
+    n=VGA_HIRES_PPB-first;
+    if(n>len) n=len;
+    mask=(uint8_t)(((1U<<(n*VGA_HIRES_BPP))-1)<<(8-((first+n)*VGA_HIRES_BPP)));
+    *ptr=(*ptr & ~mask) | (fill & mask);
+    ptr++;
+    len-=n;
+  }
+  // body : full bytes
+  n=len/VGA_HIRES_PPB;
+  if(n!=0) {
+    P_VGA_FillRow(ptr,n,fill);
+    ptr+=n;
+  }
+  // tail : pixels in the last byte (bit mask)
+  len%=VGA_HIRES_PPB;
+  if(len!=0) {
+    mask=(uint8_t)(((1U<<(len*VGA_HIRES_BPP))-1)<<(8-(len*VGA_HIRES_BPP)));
+    *ptr=(*ptr & ~mask) | (fill & mask);
+  }
+#else
+  uint8_t *ptr=&VGA_RAM1[(P_VGA_Row(yp)*VGA.mode.pitch)+xp];
+
+#if VGA_HAS_BLIT
+  // the blitter writes the same buffer : first wait for it
+  while(VGA.blit_busy!=0) {
+  }
+#endif
+  if(len==1) {
+    *ptr=color;
+    return;
+  }
+  P_VGA_FillRow(ptr,len,color);
+#endif
+}
+
+
+#if VGA_HAS_SCROLL
+//--------------------------------------------------------------
+// internal Function
+// buffer line of screen line yp (ring offset VGA.scroll)
+//--------------------------------------------------------------
+VGA_RAMFUNC static uint16_t P_VGA_Row(uint16_t yp)
+{
+  yp+=VGA.scroll;
+  if(yp>=VGA.mode.height) yp-=VGA.mode.height;
+  return yp;
+}
+#endif
+
+
+#if VGA_HAS_LINETAB
+//--------------------------------------------------------------
+// internal Function
+// line table without remapping : screen line y -> y + scroll
+// (wrapped at the height of the mode)
+//--------------------------------------------------------------
+static void P_VGA_DefaultTab(uint16_t *tab, uint16_t scroll)
+{
+  uint16_t yp,row=scroll;
+
+  for(yp=0;yp<VGA.mode.height;yp++) {
+    tab[yp]=row;
+    if(++row>=VGA.mode.height) row=0;
+  }
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// wait for a requested swap of the line tables and copy the now
+// used table to the other one
+//--------------------------------------------------------------
+static void P_VGA_FinishTab(void)
+{
+  uint16_t yp;
+
+  if(VGA_TabCopyPending==0) return;
+
+  while(VGA.tab_flip!=0) {
+    // wait for TIM2-Interrupt
+  }
 
-  // RAM init total black
   for(yp=0;yp<VGA_DISPLAY_Y;yp++) {
-    for(xp=0;xp<(VGA_DISPLAY_X+1);xp++) {
-      VGA_RAM1[(yp*(VGA_DISPLAY_X+1))+xp]=0;
+    VGA_LineTab[VGA.tab_front^1][yp]=VGA_LineTab[VGA.tab_front][yp];
+  }
+  VGA_TabCopyPending=0;
+}
+#endif
+
+
+#if VGA_USE_4BPP || VGA_USE_TEXT || VGA_USE_HIRES
+//--------------------------------------------------------------
+// internal Function
+// rebuild the expand table and the color->index table
+// (text mode : the nibble masks and the color words)
+// from VGA_Palette
+//--------------------------------------------------------------
+static void P_VGA_BuildLuts(void)
+{
+#if VGA_USE_TEXT
+  UB_VGA_BuildTextLuts(VGA_NibMask,VGA_TextColor32,VGA_Palette);
+#elif VGA_USE_HIRES
+  uint16_t n;
+
+  UB_VGA_BuildPackedLut(VGA_HiresLut,VGA_Palette,VGA_HIRES_BPP);
+  for(n=0;n<256;n++) {
+    VGA_ColorIndex[n]=UB_VGA_NearestIndexN(VGA_Palette,VGA_HIRES_COLORS,(uint8_t)n);
+  }
+#else
+  uint16_t n;
+
+  UB_VGA_BuildPairLut(VGA_PairLut,VGA_Palette);
+  for(n=0;n<256;n++) {
+    VGA_ColorIndex[n]=UB_VGA_NearestIndex(VGA_Palette,(uint8_t)n);
+  }
+#endif
+}
+#endif
+
+
+#if VGA_USE_4BPP
+//--------------------------------------------------------------
+// internal Function
+// wait for a requested swap and copy the now visible picture
+// to the new back buffer
+//--------------------------------------------------------------
+static void P_VGA_FinishFlip(void)
+{
+  uint32_t *src,*dst;
+  uint16_t n;
+
+  if(VGA_CopyPending==0) return;
+
+  while(VGA.flip!=0) {
+    // wait for TIM2-Interrupt
+  }
+
+  src=(uint32_t *)VGA_FB4[VGA.front];
+  dst=(uint32_t *)VGA_FB4[VGA.front^1];
+  for(n=0;n<(VGA_4BPP_PITCH*VGA_DISPLAY_Y)/4;n++) {
+    dst[n]=src[n];
+  }
+  VGA_CopyPending=0;
+}
+#endif
+
+
+//--------------------------------------------------------------
+// internal Function
+// add the columns x_min..x_max of line yp to the dirty state
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_VGA_MarkDirty(uint16_t yp, uint16_t x_min, uint16_t x_max)
+{
+  uint32_t mask=1UL<<(yp & 0x1F);
+
+  if((VGA_Dirty.rows[yp>>5] & mask)==0) {
+    // first change of this line
+    VGA_Dirty.rows[yp>>5]|=mask;
+    VGA_Dirty.x_min[yp]=x_min;
+    VGA_Dirty.x_max[yp]=x_max;
+    return;
+  }
+  if(x_min<VGA_Dirty.x_min[yp]) VGA_Dirty.x_min[yp]=x_min;
+  if(x_max>VGA_Dirty.x_max[yp]) VGA_Dirty.x_max[yp]=x_max;
+}
+
+
+#if (VGA_USE_DLIST==0) && (VGA_USE_TEXT==0)
+//--------------------------------------------------------------
+// internal Function
+// fill len bytes of one line with color
+// bytes until the first word boundary, then 32bit stores
+// (4 words per loop), then the remaining bytes
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_VGA_FillRow(uint8_t *ptr, uint16_t len, uint8_t color)
+{
+  uint32_t value=color*0x01010101UL;
+  uint32_t *wptr;
+
+  // head : until 4-byte aligned
+  while((len>0) && (((uint32_t)ptr & 0x03)!=0)) {
+    *ptr++=color;
+    len--;
+  }
+
+  // body : 32bit stores
+  wptr=(uint32_t*)ptr;
+  while(len>=16) {
+    wptr[0]=value;
+    wptr[1]=value;
+    wptr[2]=value;
+    wptr[3]=value;
+    wptr+=4;
+    len-=16;
+  }
+  while(len>=4) {
+    *wptr++=value;
+    len-=4;
+  }
+
+  // tail : remaining bytes
+  ptr=(uint8_t*)wptr;
+  while(len--) {
+    *ptr++=color;
+  }
+}
+#endif
+
+
+#if VGA_HAS_COPY
+// 32bit word at any address (the M4 allows unaligned LDR/STR)
+typedef struct {
+  uint32_t w;
+} __attribute__((packed)) P_VGA_Word_t;
+
+//--------------------------------------------------------------
+// internal Function
+// copy len bytes of one line from src to dst (may overlap)
+// dst before src : forward, else backward (like memmove).
+// bytes until dst is 4-byte aligned, then 32bit stores with
+// 32bit loads from src (4 words per loop), then the remaining bytes
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_VGA_CopyRow(uint8_t *dst, const uint8_t *src, uint16_t len)
+{
+  uint32_t *wdst;
+  const P_VGA_Word_t *wsrc;
+  uint32_t w0,w1,w2,w3;
+
+  if(dst<=src) {
+    // head : until 4-byte aligned
+    while((len>0) && (((uint32_t)dst & 0x03)!=0)) {
+      *dst++=*src++;
+      len--;
+    }
+    // body : 32bit stores (a word is read before it is written)
+    wdst=(uint32_t*)dst;
+    wsrc=(const P_VGA_Word_t*)src;
+    while(len>=16) {
+      w0=wsrc[0].w;
+      w1=wsrc[1].w;
+      w2=wsrc[2].w;
+      w3=wsrc[3].w;
+      wdst[0]=w0;
+      wdst[1]=w1;
+      wdst[2]=w2;
+      wdst[3]=w3;
+      wdst+=4;
+      wsrc+=4;
+      len-=16;
+    }
+    while(len>=4) {
+      *wdst++=(wsrc++)->w;
+      len-=4;
+    }
+    // tail : remaining bytes
+    dst=(uint8_t*)wdst;
+    src=(const uint8_t*)wsrc;
+    while(len--) {
+      *dst++=*src++;
     }
   }
+  else {
+    // from the end of the line to the start
+    dst+=len;
+    src+=len;
+    while((len>0) && (((uint32_t)dst & 0x03)!=0)) {
+      *--dst=*--src;
+      len--;
+    }
+    wdst=(uint32_t*)dst;
+    wsrc=(const P_VGA_Word_t*)src;
+    while(len>=16) {
+      wdst-=4;
+      wsrc-=4;
+      w3=wsrc[3].w;
+      w2=wsrc[2].w;
+      w1=wsrc[1].w;
+      w0=wsrc[0].w;
+      wdst[3]=w3;
+      wdst[2]=w2;
+      wdst[1]=w1;
+      wdst[0]=w0;
+      len-=16;
+    }
+    while(len>=4) {
+      *--wdst=(--wsrc)->w;
+      len-=4;
+    }
+    dst=(uint8_t*)wdst;
+    src=(const uint8_t*)wsrc;
+    while(len--) {
+      *--dst=*--src;
+    }
+  }
+}
+#endif
 
-  // init IO-Pins
-  P_VGA_InitIO();
-  // init Timer
-  P_VGA_InitTIM();
-  // init DMA
-  P_VGA_InitDMA();
-  // init Interrupts
-  P_VGA_InitINT();
 
-  //-----------------------
-  // Register swap and safe
-  //-----------------------
-  // content of CR-Register read and save
-  VGA.dma2_cr_reg=DMA2_Stream5->CR;
+#if VGA_HAS_BLIT
+//--------------------------------------------------------------
+// internal Function
+// start a job of the DMA blitter (coordinates already clipped)
+// waits for the job before, then starts the first line
+//--------------------------------------------------------------
+static void P_VGA_BlitStart(uint8_t op, uint16_t xs, uint16_t ys, uint16_t w, uint16_t h,
+                            uint16_t xd, uint16_t yd, uint8_t color)
+{
+  UB_VGA_BlitWait();
+
+  VGA_Blit.op=op;
+  VGA_Blit.color=color;
+  VGA_Blit.xs=xs;
+  VGA_Blit.ys=ys;
+  VGA_Blit.xd=xd;
+  VGA_Blit.yd=yd;
+  VGA_Blit.w=w;
+  VGA_Blit.h=h;
+  VGA_Blit.row=0;
+  // destination lower : bottom up (like UB_VGA_CopyRect)
+  VGA_Blit.step=((op==VGA_BLIT_COPY) && (yd>ys)) ? -1 : 1;
+  VGA_BlitPattern=color*0x01010101UL;
+
+  VGA.blit_busy=1;
+  P_VGA_BlitNext();
 }
 
 
 //--------------------------------------------------------------
-// fill the DMA RAM buffer with one color
+// internal Function
+// start the next line of the blitter job
+// the CPU writes the bytes before the first and after the last
+// word boundary of the destination, the DMA the words between.
+// (lines without words are done at once)
+// called by P_VGA_BlitStart and the DMA2 Stream0-Interrupt
 //--------------------------------------------------------------
-void UB_VGA_FillScreen(uint8_t color)
+VGA_RAMFUNC static void P_VGA_BlitNext(void)
 {
-  uint16_t xp,yp;
+  uint16_t yd,ys,head,n;
+  uint8_t *dst;
+  const uint8_t *src;
+
+  while(VGA_Blit.row<VGA_Blit.h) {
+    if(VGA_Blit.step>0) {
+      yd=VGA_Blit.yd+VGA_Blit.row;
+      ys=VGA_Blit.ys+VGA_Blit.row;
+    }
+    else {
+      yd=VGA_Blit.yd+VGA_Blit.h-1-VGA_Blit.row;
+      ys=VGA_Blit.ys+VGA_Blit.h-1-VGA_Blit.row;
+    }
+    VGA_Blit.row++;
 
-  for(yp=0;yp<VGA_DISPLAY_Y;yp++) {
-    for(xp=0;xp<VGA_DISPLAY_X;xp++) {
-      UB_VGA_SetPixel(xp,yp,color);
+    dst=&VGA_RAM1[(P_VGA_Row(yd)*VGA.mode.pitch)+VGA_Blit.xd];
+    head=(uint16_t)((4-((uint32_t)dst & 0x03)) & 0x03);
+    if(head>VGA_Blit.w) head=VGA_Blit.w;
+    n=(uint16_t)((VGA_Blit.w-head) & ~0x03);
+
+    if(VGA_Blit.op==VGA_BLIT_FILL) {
+      P_VGA_FillRow(dst,head,VGA_Blit.color);
+      P_VGA_FillRow(dst+head+n,VGA_Blit.w-head-n,VGA_Blit.color);
+      src=(const uint8_t*)&VGA_BlitPattern;
     }
+    else {
+      // source and destination are other lines, the order of the parts is free
+      src=&VGA_RAM1[(P_VGA_Row(ys)*VGA.mode.pitch)+VGA_Blit.xs];
+      P_VGA_CopyRow(dst,src,head);
+      P_VGA_CopyRow(dst+head+n,src+head+n,VGA_Blit.w-head-n);
+      src+=head;
+    }
+    if(n==0) continue;
+    dst+=head;
+
+#if defined(__arm__)
+    // Stream0 is off after the TC, the registers can be written
+    DMA2->LIFCR=VGA_BLIT_IFCR;
+    DMA2_Stream0->PAR=(uint32_t)src;
+    DMA2_Stream0->M0AR=(uint32_t)dst;
+    // FIFO (must be used in memory-to-memory), no bursts
+    DMA2_Stream0->FCR=DMA_SxFCR_DMDIS | DMA_SxFCR_FTH_0;
+    if(VGA_Blit.op==VGA_BLIT_FILL) {
+      DMA2_Stream0->NDTR=n>>2;
+      DMA2_Stream0->CR=VGA_BLIT_CR_FILL | DMA_SxCR_EN;
+    }
+    else if(((uint32_t)src & 0x03)==0) {
+      DMA2_Stream0->NDTR=n>>2;
+      DMA2_Stream0->CR=VGA_BLIT_CR_COPY32 | DMA_SxCR_EN;
+    }
+    else {
+      // other alignment : byte reads, the FIFO packs them to words
+      DMA2_Stream0->NDTR=n;
+      DMA2_Stream0->CR=VGA_BLIT_CR_COPY8 | DMA_SxCR_EN;
+    }
+    return;
+#else
+    // no DMA (PC) : the words at once
+    if(VGA_Blit.op==VGA_BLIT_FILL) {
+      P_VGA_FillRow(dst,n,VGA_Blit.color);
+    }
+    else {
+      P_VGA_CopyRow(dst,src,n);
+    }
+#endif
   }
+
+  // all lines done
+  VGA.blit_busy=0;
+  if(VGA_BlitCallback!=0) VGA_BlitCallback();
 }
 
 
 //--------------------------------------------------------------
-// put one Pixel on the screen with one color
-// Important : the last Pixel+1 from every line must be black (don't know why??)
+// internal Function
+// init DMA2 Stream0 for the blitter (memory-to-memory)
+// the DMA2 clock is already on (P_VGA_InitDMA)
 //--------------------------------------------------------------
-void UB_VGA_SetPixel(uint16_t xp, uint16_t yp, uint8_t color)
+static void P_VGA_InitBlit(void)
 {
-  if(xp>=VGA_DISPLAY_X) xp=0;
-  if(yp>=VGA_DISPLAY_Y) yp=0;
+  VGA_BlitCallback=0;
 
-  // Write pixel to ram
-  VGA_RAM1[(yp*(VGA_DISPLAY_X+1))+xp]=color;
+  DMA2_Stream0->CR=0;
+  while((DMA2_Stream0->CR & DMA_SxCR_EN)!=0) {
+  }
+  DMA2->LIFCR=VGA_BLIT_IFCR;
+
+  // below the TIM2-Interrupt : the line start must not wait
+  NVIC_SetPriority(DMA2_Stream0_IRQn,1);
+  NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+}
+#endif
+
+
+#if VGA_USE_TEXT
+//--------------------------------------------------------------
+// internal Function
+// write one cell (no range check) and mark its 8 lines dirty
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_VGA_TextCell(uint16_t col, uint16_t row, uint8_t code, uint8_t attr)
+{
+  uint8_t *cell=&VGA_Text[((row*VGA_TEXT_COLS)+col)*2];
+  uint16_t yp;
+
+  cell[0]=code;
+  cell[1]=attr;
+  for(yp=row*VGA_TEXT_CELL;yp<(row+1)*VGA_TEXT_CELL;yp++) {
+    P_VGA_MarkDirty(yp,col*VGA_TEXT_CELL,(col*VGA_TEXT_CELL)+VGA_TEXT_CELL-1);
+  }
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// expand source line yp of the text cells into a line buffer
+// (called by the line interrupt)
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_VGA_TextLine(uint8_t *dst, uint16_t yp)
+{
+  UB_VGA_ExpandTextLine(dst,&VGA_Text[(yp/VGA_TEXT_CELL)*VGA_TEXT_COLS*2],
+                        &VGA_TextFont[yp%VGA_TEXT_CELL],
+                        VGA_NibMask,VGA_TextColor32,VGA_TEXT_COLS);
+}
+#endif
+
+
+#if VGA_USE_HIRES
+//--------------------------------------------------------------
+// internal Function
+// expand screen line yp of the packed buffer into a line buffer
+// (called by the line interrupt)
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_VGA_HiresLine(uint8_t *dst, uint16_t yp)
+{
+  yp=P_VGA_Row(yp);
+#if VGA_HIRES_BPP==1
+  UB_VGA_ExpandLine1bpp(dst,&VGA_FBHi[yp*VGA_HIRES_PITCH],VGA_HiresLut,VGA_DISPLAY_X);
+#else
+  UB_VGA_ExpandLine2bpp(dst,&VGA_FBHi[yp*VGA_HIRES_PITCH],VGA_HiresLut,VGA_DISPLAY_X);
+#endif
+}
+#endif
+
+
+#if VGA_SCANOUT_DBM
+//--------------------------------------------------------------
+// internal Function
+// DMA address of a visible line (VGA_VSYNC_BILD_START..STOP)
+// every source line is sent twice
+//--------------------------------------------------------------
+VGA_RAMFUNC static uint32_t P_VGA_LineAdr(uint16_t line)
+{
+  uint16_t row=(line-VGA_VSYNC_BILD_START)>>1;
+
+#if VGA_USE_4BPP
+  return (uint32_t)(&VGA_LineBuf[row & 0x01][0]);
+#else
+  return (uint32_t)(&VGA_RAM1[VGA_LineTab[VGA.tab_front][row]*VGA_PITCH]);
+#endif
+}
+
+
+//--------------------------------------------------------------
+// internal Function
+// double buffer scanout, called at the end of line "line"
+// (after the pixel window). The DMA has already switched to the
+// buffer of the next line, so the inactive address register gets
+// the line after the next one.
+//--------------------------------------------------------------
+VGA_RAMFUNC static void P_VGA_DbmLine(uint16_t line)
+{
+  if(line==(VGA_VSYNC_BILD_START-1)) {
+    // next line is the first visible one : start the DMA
+    DMA2->HIFCR=DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 |
+                DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5;
+    DMA2_Stream5->CR=VGA.dma2_cr_reg;
+    DMA2_Stream5->NDTR=VGA_DMA_LEN;
+    DMA2_Stream5->M0AR=P_VGA_LineAdr(VGA_VSYNC_BILD_START);
+    DMA2_Stream5->M1AR=P_VGA_LineAdr(VGA_VSYNC_BILD_START+1);
+    DMA2_Stream5->CR|=DMA_SxCR_EN;
+    // DMA-Timer1 enable
+    TIM1->DIER|=TIM_DMA_Update;
+    return;
+  }
+
+  if(line==VGA_VSYNC_BILD_STOP) {
+    // last visible line sent (the port is black) : stop
+    TIM1->DIER&=~TIM_DMA_Update;
+    DMA2_Stream5->CR=0;
+    return;
+  }
+
+  // no line after the next one
+  if((line<VGA_VSYNC_BILD_START) || (line>(VGA_VSYNC_BILD_STOP-2))) return;
+
+#if VGA_USE_4BPP
+  // first scan of a source line done, the second one is running :
+  // next source line goes to the other line buffer
+  if(((line-VGA_VSYNC_BILD_START) & 0x01)==0) {
+    VGA.src_row++;
+    UB_VGA_ExpandLine4bpp(VGA_LineBuf[VGA.src_row & 0x01],
+                          &VGA_FB4[VGA.front][VGA.src_row*VGA_4BPP_PITCH],
+                          VGA_PairLut,VGA_DISPLAY_X);
+  }
+#endif
+
+  // write only the register the DMA is not using
+  if((DMA2_Stream5->CR & DMA_SxCR_CT)!=0) {
+    DMA2_Stream5->M0AR=P_VGA_LineAdr(line+2);
+  }
+  else {
+    DMA2_Stream5->M1AR=P_VGA_LineAdr(line+2);
+  }
 }
+#endif
 
 
 //--------------------------------------------------------------
@@ -145,6 +1661,26 @@ void P_VGA_InitIO(void)
   GPIO_PinAFConfig(GPIOB, GPIO_PinSource11, GPIO_AF_TIM2);
 
 
+#if VGA_VSYNC_HW
+  //---------------------------------------------
+  // init of V-Sync Pin (PB0)
+  // using Timer3 and CH3
+  //---------------------------------------------
+
+  // Clock Enable
+  RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_GPIOB, ENABLE);
+
+  // Config Pins as Digital-out
+  GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0;
+  GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF;
+  GPIO_InitStructure.GPIO_Speed = GPIO_Speed_100MHz;
+  GPIO_InitStructure.GPIO_OType = GPIO_OType_PP;
+  GPIO_InitStructure.GPIO_PuPd = GPIO_PuPd_UP ;
+  GPIO_Init(GPIOB, &GPIO_InitStructure);
+
+  // alternative function connect with IO
+  GPIO_PinAFConfig(GPIOB, GPIO_PinSource0, GPIO_AF_TIM3);
+#else
   //---------------------------------------------
   // init of V-Sync Pin (PB12)
   // using GPIO
@@ -162,6 +1698,7 @@ void P_VGA_InitIO(void)
   GPIO_Init(GPIOB, &GPIO_InitStructure);
 
   GPIOB->BSRRL = GPIO_Pin_12;
+#endif
 }
 
 
@@ -190,6 +1727,12 @@ void P_VGA_InitTIM(void)
   TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
   TIM_TimeBaseInit(TIM1, &TIM_TimeBaseStructure);
 
+#if VGA_SCANOUT_DBM
+  // Timer1 only counts while the gate from Timer4 (ITR3) is high
+  TIM_SelectInputTrigger(TIM1, TIM_TS_ITR3);
+  TIM_SelectSlaveMode(TIM1, TIM_SlaveMode_Gated);
+#endif
+
 
   //---------------------------------------------
   // init Timer2
@@ -210,7 +1753,12 @@ void P_VGA_InitTIM(void)
   // Timer2 Channel 3 ( for DMA Trigger start)
   TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1;
   TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable;
+#if VGA_SCANOUT_DBM
+  // (after the pixel window, see VGA_TIM2_DBM_IRQ)
+  TIM_OCInitStructure.TIM_Pulse = VGA_TIM2_DBM_IRQ;
+#else
   TIM_OCInitStructure.TIM_Pulse = VGA_TIM2_HTRIGGER_START-VGA_TIM2_DMA_DELAY;
+#endif
   TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_Low;
   TIM_OC3Init(TIM2, &TIM_OCInitStructure);
   TIM_OC3PreloadConfig(TIM2, TIM_OCPreload_Enable);
@@ -223,6 +1771,73 @@ void P_VGA_InitTIM(void)
   TIM_OC4Init(TIM2, &TIM_OCInitStructure);
   TIM_OC4PreloadConfig(TIM2, TIM_OCPreload_Enable);
 
+#if VGA_VSYNC_HW || VGA_SCANOUT_DBM
+  // Timer2 Update -> TRGO (line clock for Timer3/Timer4)
+  TIM_SelectOutputTrigger(TIM2, TIM_TRGOSource_Update);
+#endif
+
+#if VGA_SCANOUT_DBM
+  //---------------------------------------------
+  // init Timer4
+  // one pulse per line, started by Timer2
+  // OC1REF = gate of Timer1
+  //---------------------------------------------
+
+  // Clock enable
+  RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM4, ENABLE);
+
+  // Timer4 init (stops itself after the window)
+  TIM_TimeBaseStructure.TIM_Period = VGA_TIM4_GATE_START+VGA_TIM4_GATE_LEN-1;
+  TIM_TimeBaseStructure.TIM_Prescaler = 0;
+  TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+  TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+  TIM_TimeBaseInit(TIM4, &TIM_TimeBaseStructure);
+  TIM_SelectOnePulseMode(TIM4, TIM_OPMode_Single);
+
+  // Timer4 Channel 1 (gate, no pin)
+  TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM2;
+  TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable;
+  TIM_OCInitStructure.TIM_Pulse = VGA_TIM4_GATE_START;
+  TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
+  TIM_OC1Init(TIM4, &TIM_OCInitStructure);
+
+  // start = TIM2 TRGO (ITR1), OC1REF -> TRGO (gate for Timer1)
+  TIM_SelectInputTrigger(TIM4, TIM_TS_ITR1);
+  TIM_SelectSlaveMode(TIM4, TIM_SlaveMode_Trigger);
+  TIM_SelectOutputTrigger(TIM4, TIM_TRGOSource_OC1Ref);
+#endif
+
+#if VGA_VSYNC_HW
+
+  //---------------------------------------------
+  // init Timer3
+  // slave of Timer2, counts lines
+  // CH3 for VSYNC-Signal
+  //---------------------------------------------
+
+  // Clock enable
+  RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE);
+
+  // Timer3 init
+  TIM_TimeBaseStructure.TIM_Period = VGA_VSYNC_PERIODE-1;
+  TIM_TimeBaseStructure.TIM_Prescaler = 0;
+  TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+  TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+  TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure);
+
+  // Timer3 Channel 3 (for VSYNC)
+  TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1;
+  TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable;
+  TIM_OCInitStructure.TIM_Pulse = VGA_VSYNC_IMP;
+  TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_Low;
+  TIM_OC3Init(TIM3, &TIM_OCInitStructure);
+  TIM_OC3PreloadConfig(TIM3, TIM_OCPreload_Enable);
+
+  // clock = TIM2 TRGO (ITR1), external clock mode 1
+  TIM_SelectInputTrigger(TIM3, TIM_TS_ITR1);
+  TIM_SelectSlaveMode(TIM3, TIM_SlaveMode_External1);
+#endif
+
 
   //---------------------------------------------
   // enable all Timers
@@ -230,6 +1845,16 @@ void P_VGA_InitTIM(void)
 
   // Timer1 enable
   TIM_ARRPreloadConfig(TIM1, ENABLE);
+#if VGA_SCANOUT_DBM
+  // runs all the time, gated by Timer4
+  TIM_Cmd(TIM1, ENABLE);
+#endif
+
+#if VGA_VSYNC_HW
+  // Timer3 enable (before Timer2, it gets no clock until then)
+  TIM_ARRPreloadConfig(TIM3, ENABLE);
+  TIM_Cmd(TIM3, ENABLE);
+#endif
 
   // Timer2 enable
   TIM_ARRPreloadConfig(TIM2, ENABLE);
@@ -245,6 +1870,7 @@ void P_VGA_InitINT(void)
 {
   NVIC_InitTypeDef NVIC_InitStructure;
 
+#if VGA_SCANOUT_DBM==0
   //---------------------------------------------
   // init from DMA Interrupt
   // for TransferComplete Interrupt
@@ -259,6 +1885,7 @@ void P_VGA_InitINT(void)
   NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
   NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
   NVIC_Init(&NVIC_InitStructure);
+#endif
 
 
   //---------------------------------------------
@@ -300,23 +1927,47 @@ void P_VGA_InitDMA(void)
   DMA_DeInit(DMA2_Stream5);
   DMA_InitStructure.DMA_Channel = DMA_Channel_6;
   DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)VGA_GPIOE_ODR_ADDRESS;
+#if VGA_USE_4BPP || VGA_USE_DLIST || VGA_USE_TEXT || VGA_USE_HIRES
+  DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)&VGA_LineBuf[0][0];
+#else
   DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)&VGA_RAM1;
+#endif
   DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
-  DMA_InitStructure.DMA_BufferSize = VGA_DISPLAY_X+1;
+  DMA_InitStructure.DMA_BufferSize = VGA_DMA_LEN;
   DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
   DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
   DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+#if VGA_DMA_FIFO
+  // read words from RAM, write bytes to the port (see VGA_DMA_FIFO)
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+#else
   DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+#endif
+#if VGA_SCANOUT_DBM
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+#else
   DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+#endif
   DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+#if VGA_DMA_FIFO
+  DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+#else
   DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+#endif
   DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_HalfFull;
   DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
   DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
   DMA_Init(DMA2_Stream5, &DMA_InitStructure);
 
+#if VGA_SCANOUT_DBM
+  // double buffer : M0AR/M1AR, start with M0AR
+  // (DMA-Timer1 is enabled by the TIM2-Interrupt for the visible lines)
+  DMA_DoubleBufferModeConfig(DMA2_Stream5, DMA_InitStructure.DMA_Memory0BaseAddr, DMA_Memory_0);
+  DMA_DoubleBufferModeCmd(DMA2_Stream5, ENABLE);
+#else
   // DMA-Timer1 enable
   TIM_DMACmd(TIM1,TIM_DMA_Update,ENABLE);
+#endif
 }
 
 
@@ -325,27 +1976,83 @@ void P_VGA_InitDMA(void)
 // Interrupt of Timer2
 //
 //   CC3-Interrupt    -> starts from DMA
+//   line counter     -> software, or Timer3 with VGA_VSYNC_HW
 // Watch it.. higher troughput when interrupt flag is left alone
+// (runs from RAM : no flash wait states before the DMA start)
 //--------------------------------------------------------------
-void TIM2_IRQHandler(void)
+VGA_RAMFUNC void TIM2_IRQHandler(void)
 {
+#if VGA_ISR_PROFILE
+  uint32_t isr_start=VGA_DWT_CYCCNT;
+  uint32_t isr_lat=TIM2->CNT;
+  uint32_t isr_cycles;
+#endif
 
   // Interrupt of Timer2 CH3 occurred (for Trigger start)
-  TIM_ClearITPendingBit(TIM2, TIM_IT_CC3);
+  // (same as TIM_ClearITPendingBit, without the function call)
+  TIM2->SR=(uint16_t)~TIM_IT_CC3;
 //  TIM2->SR |= ~TIM_SR_CC3IF; //Clear pending bit interrupt
 //  NVIC->ISPR[0] = 0x10000000;
 //  NVIC->ICPR[0] = 0x10000000;
 //  TIM2->SR = (uint16_t)~((uint16_t)0x0008);
 
-
+#if VGA_VSYNC_HW
+  // line number from Timer3, VSync is made by Timer3 CH3
+  VGA.hsync_cnt=(uint16_t)TIM3->CNT;
+  if(VGA.hsync_cnt==0) {
+#else
   VGA.hsync_cnt++;
   if(VGA.hsync_cnt>=VGA_VSYNC_PERIODE) {
     // -----------
     VGA.hsync_cnt=0;
-    // Adresspointer first dot
-    VGA.start_adr=(uint32_t)(&VGA_RAM1[0]);
+#endif
+#if VGA_USE_4BPP
+    // first source line in line buffer 0
+    VGA.src_row=0;
+    UB_VGA_ExpandLine4bpp(VGA_LineBuf[0],&VGA_FB4[VGA.front][0],VGA_PairLut,VGA_DISPLAY_X);
+    VGA.start_adr=(uint32_t)(&VGA_LineBuf[0][0]);
+#elif VGA_USE_DLIST
+    // new item order of the list, first source line in line buffer 0
+    UB_VGA_DListFrameStart(&VGA_DList);
+    VGA.src_row=0;
+    UB_VGA_DListRenderLine(&VGA_DList,VGA_LineBuf[0],0,0,VGA_DISPLAY_X);
+    VGA.start_adr=(uint32_t)(&VGA_LineBuf[0][0]);
+#elif VGA_USE_TEXT
+    // first source line in line buffer 0
+    VGA.src_row=0;
+    P_VGA_TextLine(VGA_LineBuf[0],0);
+    VGA.start_adr=(uint32_t)(&VGA_LineBuf[0][0]);
+#elif VGA_USE_HIRES
+    // first source line in line buffer 0
+    VGA.src_row=0;
+    P_VGA_HiresLine(VGA_LineBuf[0],0);
+    VGA.start_adr=(uint32_t)(&VGA_LineBuf[0][0]);
+#else
+    // swap the line tables if requested
+    if(VGA.tab_flip!=0) {
+      VGA.tab_front^=1;
+      VGA.tab_flip=0;
+    }
+    // Adresspointer first dot (buffer line of the first screen line)
+    VGA.src_row=0;
+    VGA.start_adr=(uint32_t)(&VGA_RAM1[VGA_LineTab[VGA.tab_front][0]*VGA.mode.pitch]);
+    VGA.line_cnt=0;
+#endif
   }
 
+  // first line after the visible window : frame done
+  if(VGA.hsync_cnt==(VGA_VSYNC_BILD_STOP+1)) {
+    VGA.frame_cnt++;
+#if VGA_USE_4BPP
+    // swap buffers if requested
+    if(VGA.flip!=0) {
+      VGA.front^=1;
+      VGA.flip=0;
+    }
+#endif
+  }
+
+#if VGA_VSYNC_HW==0
   // HSync-Pixel
   if(VGA.hsync_cnt<VGA_VSYNC_IMP) {
     // HSync low
@@ -355,11 +2062,18 @@ void TIM2_IRQHandler(void)
     // HSync High
     GPIOB->BSRRL = GPIO_Pin_12;
   }
+#endif
 
+#if VGA_SCANOUT_DBM
+  // next addresses for the double buffer DMA
+  P_VGA_DbmLine(VGA.hsync_cnt);
+#else
   // Test for DMA start
-  if((VGA.hsync_cnt>=VGA_VSYNC_BILD_START) && (VGA.hsync_cnt<=VGA_VSYNC_BILD_STOP)) {
+  if((VGA.hsync_cnt>=VGA.mode.bild_start) && (VGA.hsync_cnt<=VGA_VSYNC_BILD_STOP)) {
     // DMA2 init
 	DMA2_Stream5->CR=VGA.dma2_cr_reg;
+    // length of one line (NDTR is 0 after the last transfer)
+    DMA2_Stream5->NDTR=VGA.mode.dma_len;
     // set address
     DMA2_Stream5->M0AR=VGA.start_adr;
     // Timer1 start
@@ -367,13 +2081,81 @@ void TIM2_IRQHandler(void)
     // DMA2 enable
     DMA2_Stream5->CR|=DMA_SxCR_EN;
 
+#if VGA_USE_HIRES
+    // no line doubling : the next source line goes to the other
+    // line buffer while the DMA sends this one
+    VGA.src_row++;
+    if(VGA.src_row<VGA_DISPLAY_Y) {
+      P_VGA_HiresLine(VGA_LineBuf[VGA.src_row & 0x01],VGA.src_row);
+    }
+    VGA.start_adr=(uint32_t)(&VGA_LineBuf[VGA.src_row & 0x01][0]);
+#elif (VGA_USE_4BPP==0) && (VGA_USE_DLIST==0) && (VGA_USE_TEXT==0)
+    // every source line is sent line_repeat times,
+    // the next one comes from the line table
+    if(++VGA.line_cnt>=VGA.mode.line_repeat) {
+      VGA.line_cnt=0;
+      VGA.src_row++;
+      if(VGA.src_row<VGA.mode.height) {
+        VGA.start_adr=(uint32_t)(&VGA_RAM1[VGA_LineTab[VGA.tab_front][VGA.src_row]*VGA.mode.pitch]);
+      }
+    }
+#else
     // Test Adrespointer for high
     if((VGA.hsync_cnt & 0x01)!=0) {
-      // inc after Hsync
-      VGA.start_adr+=(VGA_DISPLAY_X+1);
+#if VGA_USE_4BPP
+      // the DMA sends this line buffer a second time, meanwhile
+      // the next source line goes to the other line buffer
+      VGA.src_row++;
+      if(VGA.src_row<VGA_DISPLAY_Y) {
+        UB_VGA_ExpandLine4bpp(VGA_LineBuf[VGA.src_row & 0x01],
+                              &VGA_FB4[VGA.front][VGA.src_row*VGA_4BPP_PITCH],
+                              VGA_PairLut,VGA_DISPLAY_X);
+      }
+      VGA.start_adr=(uint32_t)(&VGA_LineBuf[VGA.src_row & 0x01][0]);
+#elif VGA_USE_DLIST
+      // second scan of the source line : right half of the next
+      // source line, then the DMA switches to its line buffer
+      if((VGA.src_row+1)<VGA_DISPLAY_Y) {
+        UB_VGA_DListRenderLine(&VGA_DList,VGA_LineBuf[(VGA.src_row+1) & 0x01],VGA.src_row+1,
+                               VGA_DISPLAY_X/2,VGA_DISPLAY_X);
+      }
+      VGA.src_row++;
+      VGA.start_adr=(uint32_t)(&VGA_LineBuf[VGA.src_row & 0x01][0]);
+#elif VGA_USE_TEXT
+      // the DMA sends this line buffer a second time, meanwhile
+      // the next source line is expanded from the cells
+      VGA.src_row++;
+      if(VGA.src_row<VGA_DISPLAY_Y) {
+        P_VGA_TextLine(VGA_LineBuf[VGA.src_row & 0x01],VGA.src_row);
+      }
+      VGA.start_adr=(uint32_t)(&VGA_LineBuf[VGA.src_row & 0x01][0]);
+#endif
+    }
+#if VGA_USE_DLIST
+    else {
+      // first scan of the source line : left half of the next
+      // source line to the other line buffer
+      if((VGA.src_row+1)<VGA_DISPLAY_Y) {
+        UB_VGA_DListRenderLine(&VGA_DList,VGA_LineBuf[(VGA.src_row+1) & 0x01],VGA.src_row+1,
+                               0,VGA_DISPLAY_X/2);
+      }
     }
+#endif
+#endif
   }
-
+#endif
+
+#if VGA_ISR_PROFILE
+  isr_cycles=VGA_DWT_CYCCNT-isr_start;
+  VGA_IsrProfile.cnt++;
+  VGA_IsrProfile.sum+=isr_cycles;
+  if(isr_cycles>VGA_IsrProfile.max) VGA_IsrProfile.max=isr_cycles;
+  // TIM2 ticks since the CC3 event (the counter may have wrapped)
+  if(isr_lat<TIM2->CCR3) isr_lat+=TIM2->ARR+1;
+  isr_lat-=TIM2->CCR3;
+  if(isr_lat<VGA_IsrProfile.lat_min) VGA_IsrProfile.lat_min=isr_lat;
+  if(isr_lat>VGA_IsrProfile.lat_max) VGA_IsrProfile.lat_max=isr_lat;
+#endif
 }
 
 
@@ -382,21 +2164,38 @@ void TIM2_IRQHandler(void)
 //   after TransferCompleteInterrupt -> stop DMA
 //
 // still a bit buggy
+// (runs from RAM, registers direct instead of the StdPeriph calls)
 //--------------------------------------------------------------
-void DMA2_Stream5_IRQHandler(void)
+VGA_RAMFUNC void DMA2_Stream5_IRQHandler(void)
 {
-  if(DMA_GetITStatus(DMA2_Stream5, DMA_IT_TCIF5))
+  if((DMA2->HISR & DMA_HISR_TCIF5)!=0)
   {
+    // switch on black (the last DMA byte is already black,
+    // this keeps the port black for the rest of the blanking)
+    GPIOE->BSRRH = VGA_GPIO_HINIBBLE;
+
     // TransferInterruptComplete Interrupt from DMA2
-    DMA_ClearITPendingBit(DMA2_Stream5, DMA_IT_TCIF5);
+    DMA2->HIFCR=DMA_HIFCR_CTCIF5;
 
     // Timer1 stop
     TIM1->CR1&=~TIM_CR1_CEN;
     // DMA2 disable
     DMA2_Stream5->CR=0;
-    // switch on black
-    GPIOE->BSRRH = VGA_GPIO_HINIBBLE;
   }
 }
 
 
+#if VGA_HAS_BLIT
+//--------------------------------------------------------------
+// Interrupt of DMA2 Stream0 (blitter)
+// one line of the blitter job is done : start the next one
+//--------------------------------------------------------------
+VGA_RAMFUNC void DMA2_Stream0_IRQHandler(void)
+{
+  if((DMA2->LISR & DMA_LISR_TCIF0)!=0)
+  {
+    DMA2->LIFCR=DMA_LIFCR_CTCIF0;
+    P_VGA_BlitNext();
+  }
+}
+#endif
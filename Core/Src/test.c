@@ -2,6 +2,10 @@
 #include "APIerror.h"
 #include "logicLayer.h"
 #include "APIdraw.h"
+#include "APIraster.h"
+#include "APIstempel.h"
+#include "font_acorn_8x8.h"
+#include "font_pearl_8x8.h"
 #include <stdio.h>
 
 /* ===== HULPFUNCTIES ===== */
@@ -54,6 +58,58 @@ static void UART_Report(const char* naam, const ErrorList* e)
     }
 }
 
+static void UART_Check(const char* naam, int ok)
+{
+    char buf[128];
+
+    sprintf(buf, "%s %s\n", ok ? "[PASS]" : "[FAIL]", naam);
+    UART2_WriteString(buf);
+}
+
+/** @brief Tekent de vorm van een test in het huidige tekendoel */
+typedef void (*TestTeken)(const void *arg);
+
+/** @brief 1 = pixel (x, y) hoort bij de vorm */
+typedef int (*TestOrakel)(int x, int y, const void *arg);
+
+/** @brief Surface van UART_CheckVorm(), na de controle nog het tekendoel */
+static uint8_t vorm_buf[64 * 64];
+static Surface vorm_surface;
+
+/**
+ * @brief Tekent een vorm in een zwarte surface en vergelijkt elke pixel met een orakel.
+ *
+ * Een pixel met kleur moet precies bij de vorm horen volgens orakel().
+ * De surface blijft het tekendoel, zodat de test daarna losse pixels in
+ * vorm_buf kan bekijken.
+ *
+ * @param naam Naam van de controle
+ * @param breedte Breedte van de surface (<= 64)
+ * @param hoogte Hoogte van de surface (<= 64)
+ * @param kleur Kleur van de vorm
+ * @param teken Tekent de vorm
+ * @param teken_arg Argument voor teken()
+ * @param orakel Verwachte pixels
+ * @param orakel_arg Argument voor orakel()
+ */
+static void UART_CheckVorm(const char *naam, int breedte, int hoogte, uint8_t kleur,
+                           TestTeken teken, const void *teken_arg,
+                           TestOrakel orakel, const void *orakel_arg)
+{
+    int ok = 1;
+
+    surface_init(&vorm_surface, vorm_buf, breedte, hoogte, breedte);
+    raster_zet_doel(&vorm_surface);
+    raster_rechthoek(0, 0, breedte, hoogte, ZWART, 1);
+    teken(teken_arg);
+
+    for (int y = 0; y < hoogte; y++)
+        for (int x = 0; x < breedte; x++)
+            if ((vorm_buf[y * breedte + x] == kleur) != (orakel(x, y, orakel_arg) != 0)) ok = 0;
+
+    UART_Check(naam, ok);
+}
+
 /* ===== API IO TEST ===== */
 
 void test_APIio(void)
@@ -102,6 +158,24 @@ void test_APIio(void)
     err = wacht(0);
     UART_Report("wacht fout", &err);
 
+    // wachtframe
+    {
+        uint32_t start = frameteller();
+        uint32_t frames;
+        int in_vblank;
+
+        err = wachtframe(2);
+        in_vblank = UB_VGA_InVBlank();
+        frames = frameteller() - start;
+        UART_Report("wachtframe(2)", &err);
+        UART_Check("frameteller +2", frames == 2);
+        UART_Check("na wachtframe in vblank", in_vblank);
+    }
+    err = wachtframe(0);
+    UART_Report("wachtframe te klein fout", &err);
+    err = wachtframe(601);
+    UART_Report("wachtframe te groot fout", &err);
+
     // herhaal
     err = herhaal(2, 2);
     UART_Report("herhaal geldig", &err);
@@ -123,20 +197,24 @@ void test_APIdraw(void)
     ErrorList err;
 
     // lijn
-    err = lijn(1, 1, 100, 50, "rood", 1);
+    err = lijn(1, 1, 100, 50, "rood", 1, RASTER_KAP_VIERKANT);
     UART_Report("lijn geldig", &err);
-    err = lijn(-1, 1, 10, 10, "rood", 1);
+    err = lijn(-1, 1, 10, 10, "rood", 1, RASTER_KAP_VIERKANT);
     UART_Report("lijn x1 te klein", &err);
-    err = lijn(1, -1, 10, 10, "rood", 1);
+    err = lijn(1, -1, 10, 10, "rood", 1, RASTER_KAP_VIERKANT);
     UART_Report("lijn y1 te klein", &err);
-    err = lijn(1, 1, 500, 10, "rood", 1);
+    err = lijn(1, 1, 500, 10, "rood", 1, RASTER_KAP_VIERKANT);
     UART_Report("lijn x2 te groot", &err);
-    err = lijn(1, 1, 10, 300, "rood", 1);
+    err = lijn(1, 1, 10, 300, "rood", 1, RASTER_KAP_VIERKANT);
     UART_Report("lijn y2 te groot", &err);
-    err = lijn(1, 1, 10, 10, "foutkleur", 1);
+    err = lijn(1, 1, 10, 10, "foutkleur", 1, RASTER_KAP_VIERKANT);
     UART_Report("lijn kleur fout", &err);
-    err = lijn(1, 1, 10, 10, "rood", 0);
+    err = lijn(1, 1, 10, 10, "rood", 0, RASTER_KAP_VIERKANT);
     UART_Report("lijn dikte te klein", &err);
+    err = lijn(10, 10, 50, 30, "rood", 5, RASTER_KAP_ROND);
+    UART_Report("dikke lijn rond", &err);
+    err = lijn(10, 10, 50, 30, "rood", 5, 3);
+    UART_Report("lijn kap fout", &err);
 
     // rechthoek
     err = rechthoek(10, 10, 50, 30, "groen", 1);
@@ -155,16 +233,47 @@ void test_APIdraw(void)
     UART_Report("rechthoek kleur fout", &err);
 
     // cirkel
-    err = cirkel(50, 50, 20, "blauw");
+    err = cirkel(50, 50, 20, "blauw", 0, 1);
     UART_Report("cirkel geldig", &err);
-    err = cirkel(-10, 50, 20, "blauw");
+    err = cirkel(50, 50, 20, "blauw", 1, 1);
+    UART_Report("cirkel gevuld geldig", &err);
+    err = cirkel(50, 50, 20, "blauw", 0, 5);
+    UART_Report("cirkel ring geldig", &err);
+    err = cirkel(-10, 50, 20, "blauw", 0, 1);
     UART_Report("cirkel x fout", &err);
-    err = cirkel(50, -10, 20, "blauw");
+    err = cirkel(50, -10, 20, "blauw", 0, 1);
     UART_Report("cirkel y fout", &err);
-    err = cirkel(50, 50, -5, "blauw");
+    err = cirkel(50, 50, -5, "blauw", 0, 1);
     UART_Report("cirkel radius fout", &err);
-    err = cirkel(50, 50, 20, "foutkleur");
+    err = cirkel(50, 50, 20, "foutkleur", 0, 1);
     UART_Report("cirkel kleur fout", &err);
+    err = cirkel(50, 50, 20, "blauw", 2, 1);
+    UART_Report("cirkel gevuld fout", &err);
+    err = cirkel(50, 50, 20, "blauw", 0, 0);
+    UART_Report("cirkel dikte 0 fout", &err);
+    err = cirkel(50, 50, 20, "blauw", 0, 21);
+    UART_Report("cirkel dikte groter dan radius fout", &err);
+
+    // veelhoek
+    {
+        static const int pijl[] = {20, 40, 60, 40, 60, 20, 100, 60, 60, 100, 60, 80, 20, 80};
+        static const int buiten[] = {20, 40, 60, 40, 400, 60};
+
+        err = veelhoek(pijl, 7, "rood", RASTER_VUL_RAND);
+        UART_Report("veelhoek rand geldig", &err);
+        err = veelhoek(pijl, 7, "rood", RASTER_VUL_NIET_NUL);
+        UART_Report("veelhoek gevuld geldig", &err);
+        err = veelhoek(pijl, 2, "rood", RASTER_VUL_NIET_NUL);
+        UART_Report("veelhoek te weinig punten", &err);
+        err = veelhoek(pijl, RASTER_MAX_PUNTEN + 1, "rood", RASTER_VUL_NIET_NUL);
+        UART_Report("veelhoek te veel punten", &err);
+        err = veelhoek(pijl, 7, "foutkleur", RASTER_VUL_NIET_NUL);
+        UART_Report("veelhoek kleur fout", &err);
+        err = veelhoek(pijl, 7, "rood", 3);
+        UART_Report("veelhoek vulling fout", &err);
+        err = veelhoek(buiten, 3, "rood", RASTER_VUL_EVEN_ONEVEN);
+        UART_Report("veelhoek punt buiten scherm", &err);
+    }
 
     // toren
     err = toren(100, 100, 20, "geel", "rood");
@@ -202,3 +311,1374 @@ void test_APIdraw(void)
 
     UART2_WriteString("=== API DRAW LAYER TEST END ===\n");
 }
+
+/* ===== VGA DIRTY TEST ===== */
+
+void test_VGA_dirty(void)
+{
+    uint16_t x_min = 0;
+    uint16_t x_max = 0;
+
+    UART2_WriteString("\n=== VGA DIRTY TEST START ===\n");
+
+    UB_VGA_ClearDirty();
+    UART_Check("na clear geen dirty regels", UB_VGA_NextDirtyRow(0) == -1);
+
+    (void)setPixel(10, 5, ROOD);
+    (void)setPixel(3, 5, ROOD);
+    UART_Check("pixels op regel 5",
+               UB_VGA_GetDirtyRow(5, &x_min, &x_max) && x_min == 3 && x_max == 10);
+
+    (void)rechthoek(100, 40, 20, 3, "groen", 1);
+    UART_Check("rechthoek regel 40..42",
+               UB_VGA_NextDirtyRow(6) == 40 && UB_VGA_NextDirtyRow(43) == -1 &&
+               UB_VGA_GetDirtyRow(42, &x_min, &x_max) && x_min == 100 && x_max == 119);
+
+    UB_VGA_ClearDirtyRow(5);
+    UART_Check("regel 5 schoon", UB_VGA_NextDirtyRow(0) == 40);
+
+    (void)lijn(7, 200, 7, 239, "blauw", 1, RASTER_KAP_VIERKANT);
+    UART_Check("verticale lijn tot onderrand",
+               UB_VGA_NextDirtyRow(43) == 200 &&
+               UB_VGA_GetDirtyRow(239, &x_min, &x_max) && x_min == 7 && x_max == 7);
+
+    UB_VGA_ClearDirty();
+    UART2_WriteString("=== VGA DIRTY TEST END ===\n");
+}
+
+/* ===== UITGESTELD TEKENEN TEST ===== */
+
+void test_raster_wachtrij(void)
+{
+    ErrorList err;
+    int niets_getekend;
+
+    UART2_WriteString("\n=== UITGESTELD TEKENEN TEST START ===\n");
+
+    err = uitgesteld_tekenen(2);
+    UART_Report("uitgesteld fout", &err);
+    err = uitgesteld_tekenen(1);
+    UART_Report("uitgesteld aan", &err);
+
+    UB_VGA_ClearDirty();
+    (void)rechthoek(10, 10, 100, 100, "rood", 1);
+    (void)lijn(0, 200, 319, 200, "blauw", 1, RASTER_KAP_VIERKANT);
+    niets_getekend = (UB_VGA_NextDirtyRow(0) == -1);
+    UART_Check("opdrachten in wachtrij", raster_wachtrij_aantal() == 2);
+    UART_Check("nog niets getekend", niets_getekend);
+
+    raster_wachtrij_leeg();
+    UART_Check("wachtrij leeg", raster_wachtrij_aantal() == 0);
+    UART_Check("rechthoek en lijn getekend",
+               UB_VGA_NextDirtyRow(0) == 10 && UB_VGA_NextDirtyRow(110) == 200);
+
+    err = uitgesteld_tekenen(0);
+    UART_Report("uitgesteld uit", &err);
+    UB_VGA_ClearDirty();
+
+    UART2_WriteString("=== UITGESTELD TEKENEN TEST END ===\n");
+}
+
+/* ===== VGA EXPAND TEST ===== */
+
+void test_VGA_expand(void)
+{
+    static const uint8_t palet[VGA_EXPAND_PAL_SIZE] = {
+        0x00, 0x03, 0x07, 0x1C, 0x1E, 0x1F, 0xE0, 0xE1,
+        0xE3, 0xE2, 0xAC, 0xFC, 0x92, 0xFF, 0xEF, 0xA3
+    };
+    static uint16_t paren[VGA_EXPAND_PAIR_SIZE];
+    static const uint8_t bron[6] = { 0x01, 0x23, 0x45, 0x67, 0xD0, 0x0D };
+    uint32_t regel[4] = { 0 };
+    const uint8_t *pix = (const uint8_t *)regel;
+    int ok = 1;
+
+    UART2_WriteString("\n=== VGA EXPAND TEST START ===\n");
+
+    UB_VGA_BuildPairLut(paren, palet);
+    UART_Check("paar-tabel linker pixel in laag byte",
+               paren[0x6D] == (uint16_t)(0xE0 | (0xFF << 8)));
+
+    // 12 pixels: 8 in de hoofdlus, 4 in de staart
+    UB_VGA_ExpandLine4bpp((uint8_t *)regel, bron, paren, 12);
+    for (int i = 0; i < 8; i++)
+        if (pix[i] != palet[i])
+            ok = 0;
+    UART_Check("regel 0..7 volgens palet", ok);
+    UART_Check("staart 8..11",
+               pix[8] == 0xFF && pix[9] == 0x00 && pix[10] == 0x00 && pix[11] == 0xFF);
+    UART_Check("niets na de regel geschreven", regel[3] == 0);
+
+    UART_Check("exacte kleur geeft eigen index", UB_VGA_NearestIndex(palet, 0xAC) == 10);
+    UART_Check("donkerrood naar rood", UB_VGA_NearestIndex(palet, 0xC0) == 6);
+
+    // tekstcellen: 'A' rood op blauw, spatie wit op zwart
+    {
+        static uint32_t maskers[VGA_EXPAND_MASK_SIZE];
+        static uint32_t kleuren[VGA_EXPAND_PAL_SIZE];
+        const uint8_t cellen[4] = { 'A', VGA_TEXT_ATTR(6, 1), ' ', VGA_TEXT_ATTR(13, 0) };
+        const unsigned char *font = fontdata_acorn8x8 + 3;
+        uint32_t tekst[5] = { 0 };
+        const uint8_t *tp = (const uint8_t *)tekst;
+        uint8_t bits = font['A' * 8];
+
+        UB_VGA_BuildTextLuts(maskers, kleuren, palet);
+        UART_Check("nibble-masker linker pixel in laag byte", maskers[0x8] == 0x000000FFUL);
+
+        UB_VGA_ExpandTextLine((uint8_t *)tekst, cellen, font, maskers, kleuren, 2);
+        ok = 1;
+        for (int i = 0; i < 8; i++)
+            if (tp[i] != (((bits >> (7 - i)) & 1) ? 0xE0 : 0x03))
+                ok = 0;
+        UART_Check("tekstregel volgens font en attribuut", ok);
+        UART_Check("spatie is achtergrond", tekst[2] == 0 && tekst[3] == 0);
+        UART_Check("niets na de tekstregel geschreven", tekst[4] == 0);
+    }
+
+    // 1bpp en 2bpp: linker pixel in de hoogste bits
+    {
+        static uint32_t lut[VGA_EXPAND_LUT2_SIZE];
+        const uint8_t palet4[4] = { 0x00, 0xFF, 0x1C, 0xE0 };
+        const uint8_t bron1[2] = { 0x81, 0xF0 };
+        const uint8_t bron2[2] = { 0x1B, 0xE4 };
+        uint32_t uit[5] = { 0 };
+        const uint8_t *up = (const uint8_t *)uit;
+
+        UB_VGA_BuildPackedLut(lut, palet4, 1);
+        UB_VGA_ExpandLine1bpp((uint8_t *)uit, bron1, lut, 16);
+        UART_Check("1bpp regel",
+                   up[0] == 0xFF && up[1] == 0x00 && up[7] == 0xFF &&
+                   up[8] == 0xFF && up[11] == 0xFF && up[12] == 0x00 && uit[4] == 0);
+
+        uit[0] = uit[1] = uit[2] = 0;
+        UB_VGA_BuildPackedLut(lut, palet4, 2);
+        UB_VGA_ExpandLine2bpp((uint8_t *)uit, bron2, lut, 8);
+        UART_Check("2bpp regel",
+                   up[0] == 0x00 && up[1] == 0xFF && up[2] == 0x1C && up[3] == 0xE0 &&
+                   up[4] == 0xE0 && up[7] == 0x00 && uit[2] == 0);
+        UART_Check("dichtstbijzijnde van 4 kleuren", UB_VGA_NearestIndexN(palet4, 4, 0xC0) == 3);
+    }
+
+    UART2_WriteString("=== VGA EXPAND TEST END ===\n");
+}
+
+/* ===== DISPLAY-LIJST TEST ===== */
+
+void test_VGA_dlist(void)
+{
+    static VGA_DList_t lijst;
+    static uint8_t regel[VGA_PITCH];
+    const uint8_t achter = VGA_COL_BLUE;
+    int16_t rood, geel;
+    int aantal = 0;
+    uint32_t start, cycli;
+    char buf[96];
+
+    UART2_WriteString("\n=== DISPLAY-LIJST TEST START ===\n");
+
+    UB_VGA_DListInit(&lijst, achter);
+    UB_VGA_DListFrameStart(&lijst);
+    UB_VGA_DListRenderLine(&lijst, regel, 0, 0, VGA_DISPLAY_X);
+    UART_Check("lege lijst geeft achtergrond",
+               regel[0] == achter && regel[VGA_DISPLAY_X - 1] == achter);
+
+    // de renderer ziet een wijziging pas na de framestart
+    rood = UB_VGA_DListRect(&lijst, 10, 10, 20, 20, VGA_COL_RED, 1);
+    UB_VGA_DListRenderLine(&lijst, regel, 15, 0, VGA_DISPLAY_X);
+    UART_Check("nieuw item pas na framestart", regel[15] == achter);
+    UB_VGA_DListFrameStart(&lijst);
+    UB_VGA_DListRenderLine(&lijst, regel, 15, 0, VGA_DISPLAY_X);
+    UART_Check("rechthoek 10..29",
+               regel[9] == achter && regel[10] == VGA_COL_RED &&
+               regel[29] == VGA_COL_RED && regel[30] == achter);
+
+    // later toegevoegd ligt bovenop, ook na verplaatsen
+    geel = UB_VGA_DListRect(&lijst, 20, 5, 20, 20, VGA_COL_YELLOW, 1);
+    UB_VGA_DListMove(&lijst, rood, 1, 0);
+    UB_VGA_DListFrameStart(&lijst);
+    UB_VGA_DListRenderLine(&lijst, regel, 15, 0, VGA_DISPLAY_X);
+    UART_Check("later item bovenop",
+               regel[11] == VGA_COL_RED && regel[25] == VGA_COL_YELLOW && regel[10] == achter);
+
+    UB_VGA_DListDelete(&lijst, geel);
+    UB_VGA_DListMove(&lijst, rood, 0, 100);
+    UB_VGA_DListFrameStart(&lijst);
+    UB_VGA_DListRenderLine(&lijst, regel, 15, 0, VGA_DISPLAY_X);
+    UART_Check("verplaatst en gewist", regel[11] == achter && regel[25] == achter);
+    UB_VGA_DListRenderLine(&lijst, regel, 115, 0, VGA_DISPLAY_X);
+    UART_Check("verplaatst naar regel 110", regel[11] == VGA_COL_RED);
+
+    // verplaatsen en wissen halverwege een frame: de rest van het frame blijft het oude beeld
+    UB_VGA_DListRenderLine(&lijst, regel, 110, 0, VGA_DISPLAY_X);
+    UB_VGA_DListMove(&lijst, rood, 0, 50);
+    UB_VGA_DListRenderLine(&lijst, regel, 125, 0, VGA_DISPLAY_X);
+    UART_Check("verplaatsing halverwege frame nog oud", regel[11] == VGA_COL_RED);
+    UB_VGA_DListRenderLine(&lijst, regel, 165, 0, VGA_DISPLAY_X);
+    UART_Check("verplaatsing halverwege frame nog niet nieuw", regel[11] == achter);
+    UB_VGA_DListDelete(&lijst, rood);
+    geel = UB_VGA_DListRect(&lijst, 0, 110, 5, 20, VGA_COL_YELLOW, 1);
+    UB_VGA_DListRenderLine(&lijst, regel, 128, 0, VGA_DISPLAY_X);
+    UART_Check("gewist en hergebruikt halverwege frame nog oud",
+               regel[11] == VGA_COL_RED && regel[0] == achter);
+    UB_VGA_DListFrameStart(&lijst);
+    UB_VGA_DListRenderLine(&lijst, regel, 128, 0, VGA_DISPLAY_X);
+    UART_Check("na framestart nieuw", regel[11] == achter && regel[0] == VGA_COL_YELLOW);
+
+    // lijn en cirkel
+    UB_VGA_DListLine(&lijst, 0, 200, VGA_DISPLAY_X - 1, 200, VGA_COL_GREEN, 1);
+    UB_VGA_DListCircle(&lijst, 160, 120, 50, VGA_COL_WHITE);
+    UB_VGA_DListFrameStart(&lijst);
+    UB_VGA_DListRenderLine(&lijst, regel, 200, 0, VGA_DISPLAY_X);
+    UART_Check("horizontale lijn", regel[0] == VGA_COL_GREEN && regel[VGA_DISPLAY_X - 1] == VGA_COL_GREEN);
+    UB_VGA_DListRenderLine(&lijst, regel, 70, 0, VGA_DISPLAY_X);
+    UART_Check("cirkel bovenkant", regel[160] == VGA_COL_WHITE && regel[100] == achter);
+    UB_VGA_DListRenderLine(&lijst, regel, 120, 0, VGA_DISPLAY_X);
+    UART_Check("cirkel links en rechts", regel[110] == VGA_COL_WHITE && regel[210] == VGA_COL_WHITE &&
+                                         regel[160] == achter);
+
+    // een halve regel laat de andere helft staan
+    regel[200] = 0x55;
+    UB_VGA_DListRenderLine(&lijst, regel, 120, 0, VGA_DISPLAY_X / 2);
+    UART_Check("halve regel", regel[110] == VGA_COL_WHITE && regel[200] == 0x55);
+
+    // 8 karakters op één regel, één halve regel meten
+    for (int i = 0; i < 8; i++)
+        UB_VGA_DListChar(&lijst, 8 + 16 * i, 140, (uint8_t)('A' + i), fontdata_acorn8x8, 2,
+                         VGA_DL_BOLD, VGA_COL_MAGENTA);
+    UB_VGA_DListFrameStart(&lijst);
+    start = DWT_CYCCNT_REG;
+    UB_VGA_DListRenderLine(&lijst, regel, 146, 0, VGA_DISPLAY_X / 2);
+    cycli = DWT_CYCCNT_REG - start;
+    sprintf(buf, "[BENCH] halve regel met 8 karakters: %lu cycli\n", (unsigned long)cycli);
+    UART2_WriteString(buf);
+
+    // volle lijst
+    while (UB_VGA_DListRect(&lijst, 0, 0, 1, 1, VGA_COL_BLACK, 1) >= 0)
+        aantal++;
+    UART_Check("volle lijst geeft -1", aantal == VGA_DLIST_MAX - 11);
+
+    UART2_WriteString("=== DISPLAY-LIJST TEST END ===\n");
+}
+
+/* ===== VIDEOMODUS TEST ===== */
+
+void test_VGA_modus(void)
+{
+    ErrorList err;
+    const VGA_Mode_t *modus;
+    uint16_t x_min = 0, x_max = 0;
+    uint32_t start, cycli_groot, cycli_klein;
+    char buf[96];
+
+    UART2_WriteString("\n=== VIDEOMODUS TEST START ===\n");
+
+    UART_Check("onbekende modus geeft 1", UB_VGA_SetMode(VGA_MODE_CNT) == 1);
+    err = scherm_modus(100);
+    UART_Report("modus 100 fout", &err);
+
+    modus = UB_VGA_GetMode();
+    UART_Check("standaardmodus",
+               modus->width == VGA_DISPLAY_X && modus->height == VGA_DISPLAY_Y &&
+               modus->line_repeat * modus->height == VGA_VISIBLE_LINES &&
+               (modus->pitch & 0x03) == 0 && modus->pitch > modus->width);
+
+#if VGA_MODE_CNT > 1
+    // tot het scherm echt gewist is (ook met de DMA-blitter)
+    start = DWT_CYCCNT_REG;
+    (void)clearscherm("blauw");
+    UB_VGA_BlitWait();
+    cycli_groot = DWT_CYCCNT_REG - start;
+
+    err = scherm_modus(160);
+    UART_Report("modus 160x120", &err);
+    modus = UB_VGA_GetMode();
+    UART_Check("descriptor 160x120",
+               modus->width == 160 && modus->height == 120 && modus->line_repeat == 4 &&
+               modus->pitch == 164 && scherm_breedte() == 160 && scherm_hoogte() == 120);
+    UART_Check("hele scherm dirty",
+               UB_VGA_NextDirtyRow(0) == 0 && UB_VGA_NextDirtyRow(120) == -1 &&
+               UB_VGA_GetDirtyRow(119, &x_min, &x_max) && x_min == 0 && x_max == 159);
+
+    err = drawPixel(200, 10, "rood");
+    UART_Report("pixel buiten 160x120 fout", &err);
+
+    UB_VGA_ClearDirty();
+    (void)drawPixel(159, 119, "rood");
+    UART_Check("pixel rechtsonder",
+               VGA_RAM1[119 * 164 + 159] == ROOD && VGA_RAM1[119 * 164 + 160] == ZWART &&
+               UB_VGA_NextDirtyRow(0) == 119);
+
+    start = DWT_CYCCNT_REG;
+    (void)clearscherm("blauw");
+    UB_VGA_BlitWait();
+    cycli_klein = DWT_CYCCNT_REG - start;
+    sprintf(buf, "[BENCH] clearscherm 320x240: %lu cycli, 160x120: %lu cycli\n",
+            (unsigned long)cycli_groot, (unsigned long)cycli_klein);
+    UART2_WriteString(buf);
+    UART_Check("wissen 160x120 minstens 3x sneller", cycli_klein * 3 < cycli_groot);
+
+    err = scherm_modus(320);
+    UART_Report("terug naar 320x240", &err);
+    UART_Check("descriptor 320x240", scherm_breedte() == 320 && scherm_hoogte() == 240);
+#else
+    (void)x_min;
+    (void)x_max;
+    (void)start;
+    (void)cycli_groot;
+    (void)cycli_klein;
+    (void)buf;
+#endif
+
+    UB_VGA_ClearDirty();
+    UART2_WriteString("=== VIDEOMODUS TEST END ===\n");
+}
+
+/* ===== SCROLL TEST ===== */
+
+void test_VGA_scroll(void)
+{
+    ErrorList err;
+
+    UART2_WriteString("\n=== SCROLL TEST START ===\n");
+
+    err = scherm_scroll(0);
+    UART_Report("scroll 0 fout", &err);
+    err = scherm_scroll(scherm_hoogte());
+    UART_Report("scroll hele scherm fout", &err);
+
+#if VGA_HAS_SCROLL && (VGA_USE_HIRES == 0)
+    (void)clearscherm("wit");
+    UB_VGA_ClearDirty();
+
+    err = scherm_scroll(8);
+    UART_Report("scroll 8", &err);
+    UART_Check("ring-offset 8", VGA.scroll == 8);
+    // buffer-regels 0-7 zijn nu de onderste 8 regels van het scherm
+    UART_Check("binnenkomende regels zwart",
+               VGA_RAM1[7 * VGA.mode.pitch + 5] == ZWART && VGA_RAM1[8 * VGA.mode.pitch + 5] == WIT);
+    UART_Check("hele scherm dirty",
+               UB_VGA_NextDirtyRow(0) == 0 && UB_VGA_NextDirtyRow(scherm_hoogte() - 1) == scherm_hoogte() - 1);
+
+    (void)drawPixel(5, scherm_hoogte() - 1, "rood");
+    (void)drawPixel(5, 0, "groen");
+    UART_Check("schermcoördinaten in de ring",
+               VGA_RAM1[7 * VGA.mode.pitch + 5] == ROOD && VGA_RAM1[8 * VGA.mode.pitch + 5] == GROEN);
+
+    (void)lijn(6, scherm_hoogte() - 4, 6, scherm_hoogte() - 1, "blauw", 1, RASTER_KAP_VIERKANT);
+    UART_Check("verticale lijn blijft in de ring",
+               VGA_RAM1[4 * VGA.mode.pitch + 6] == BLAUW && VGA_RAM1[7 * VGA.mode.pitch + 6] == BLAUW);
+
+    err = scherm_scroll(-8);
+    UART_Report("scroll -8", &err);
+    UART_Check("ring-offset terug op 0", VGA.scroll == 0);
+    UART_Check("bovenste regels zwart", VGA_RAM1[7 * VGA.mode.pitch + 5] == ZWART);
+#endif
+
+    UB_VGA_ClearDirty();
+    UART2_WriteString("=== SCROLL TEST END ===\n");
+}
+
+/* ===== REGELTABEL TEST ===== */
+
+void test_VGA_regeltabel(void)
+{
+    UART2_WriteString("\n=== REGELTABEL TEST START ===\n");
+
+#if VGA_HAS_LINETAB
+    const int balk = 16;                      // vaste statusbalk bovenaan
+    const int deel = scherm_hoogte() - balk;  // scrollend deel eronder
+    int ok = 1;
+
+    UART_Check("standaard: regel y toont y",
+               UB_VGA_LineTabGet(0) == (int16_t)VGA.scroll && UB_VGA_LineTabGet(1) != -1);
+    UART_Check("regel buiten scherm geeft 1", UB_VGA_LineTabSet(scherm_hoogte(), 0) == 1);
+    UART_Check("bufferregel buiten VGA_RAM1 geeft 1",
+               UB_VGA_LineTabSet(0, sizeof(VGA_RAM1) / VGA.mode.pitch) == 1);
+    UART_Check("get buiten scherm geeft -1", UB_VGA_LineTabGet(scherm_hoogte()) == -1);
+
+    // gesplitst scherm : het deel onder de balk 8 regels gedraaid, zonder kopiëren
+    UB_VGA_LineTabReset();
+    for (int y = balk; y < scherm_hoogte(); y++)
+        (void)UB_VGA_LineTabSet(y, balk + ((y - balk + 8) % deel));
+    UB_VGA_LineTabApply();
+    UB_VGA_WaitVBlank();
+    UB_VGA_WaitVBlank();
+    UART_Check("tabellen gewisseld", VGA.tab_flip == 0);
+
+    for (int y = 0; y < balk; y++)
+        if (UB_VGA_LineTabGet(y) != y) ok = 0;
+    UART_Check("statusbalk blijft staan", ok);
+    UART_Check("deel eronder gedraaid",
+               UB_VGA_LineTabGet(balk) == balk + 8 &&
+               UB_VGA_LineTabGet(scherm_hoogte() - 1) == balk + 7);
+
+    // regelverdubbeling : elke bufferregel twee keer
+    for (int y = 0; y < scherm_hoogte(); y++)
+        (void)UB_VGA_LineTabSet(y, y / 2);
+    UART_Check("regelverdubbeling", UB_VGA_LineTabGet(101) == 50);
+
+    UB_VGA_LineTabReset();
+    UB_VGA_LineTabApply();
+    UART_Check("terug naar standaard", UB_VGA_LineTabGet(balk) == balk);
+#else
+    UART_Check("geen regeltabel in deze modus",
+               UB_VGA_LineTabSet(0, 0) == 1 && UB_VGA_LineTabGet(0) == -1);
+#endif
+
+    UART2_WriteString("=== REGELTABEL TEST END ===\n");
+}
+
+/* ===== KOPIEER TEST ===== */
+
+void test_VGA_kopieer(void)
+{
+    ErrorList err;
+
+    UART2_WriteString("\n=== KOPIEER TEST START ===\n");
+
+    err = kopieer(-1, 0, 10, 10, 0, 0);
+    UART_Report("kopieer x -1 fout", &err);
+    err = kopieer(0, 0, 10, 10, scherm_breedte() - 5, 0);
+    UART_Report("kopieer doel buiten scherm fout", &err);
+    err = kopieer(0, 0, 10, 0, 20, 20);
+    UART_Report("kopieer hoogte 0 fout", &err);
+
+#if VGA_HAS_COPY
+    const int p = VGA.mode.pitch;
+    int ok = 1;
+
+    // patroon : elke pixel een eigen waarde, zodat elke verschuiving opvalt
+    (void)clearscherm("zwart");
+    for (int y = 0; y < 20; y++)
+        for (int x = 0; x < 40; x++)
+            UB_VGA_SetPixel(x, y, (uint8_t)(x + y * 7));
+    UB_VGA_ClearDirty();
+
+    // zonder overlap, doel op een andere woordgrens (woorden via unaligned LDR)
+    err = kopieer(0, 0, 40, 20, 101, 50);
+    UART_Report("kopieer 40x20", &err);
+    for (int y = 0; y < 20; y++)
+        for (int x = 0; x < 40; x++)
+            if (VGA_RAM1[(50 + y) * p + 101 + x] != (uint8_t)(x + y * 7)) ok = 0;
+    UART_Check("kopie gelijk aan bron", ok);
+    UART_Check("rand naast kopie ongewijzigd",
+               VGA_RAM1[50 * p + 100] == ZWART && VGA_RAM1[50 * p + 141] == ZWART);
+    UART_Check("doel dirty", UB_VGA_NextDirtyRow(0) == 50);
+
+    // overlap naar rechtsonder : onderste regel eerst, elke regel van rechts
+    err = kopieer(101, 50, 40, 20, 104, 53);
+    UART_Report("kopieer overlap rechtsonder", &err);
+    ok = 1;
+    for (int y = 0; y < 20; y++)
+        for (int x = 0; x < 40; x++)
+            if (VGA_RAM1[(53 + y) * p + 104 + x] != (uint8_t)(x + y * 7)) ok = 0;
+    UART_Check("overlap rechtsonder", ok);
+
+    // overlap naar linksboven (en met herhaal opgenomen)
+    err = kopieer(104, 53, 40, 20, 97, 51);
+    UART_Report("kopieer overlap linksboven", &err);
+    ok = 1;
+    for (int y = 0; y < 20; y++)
+        for (int x = 0; x < 40; x++)
+            if (VGA_RAM1[(51 + y) * p + 97 + x] != (uint8_t)(x + y * 7)) ok = 0;
+    UART_Check("overlap linksboven", ok);
+
+    // zelfde regels, 1 pixel naar rechts (memmove binnen één regel)
+    err = kopieer(0, 0, 40, 1, 1, 0);
+    UART_Report("kopieer 1 pixel naar rechts", &err);
+    UART_Check("regel verschoven", VGA_RAM1[1] == 0 && VGA_RAM1[40] == 39);
+#else
+    err = kopieer(0, 0, 10, 10, 20, 20);
+    UART_Report("geen kopie in deze modus fout", &err);
+#endif
+
+    // in een surface gelden de maten van de surface, niet die van het scherm
+    {
+        static uint8_t breed[400 * 8];
+        Surface s;
+
+        surface_init(&s, breed, 400, 8, 400);
+        raster_zet_doel(&s);
+        raster_rechthoek(0, 0, 400, 8, ZWART, 1);
+        breed[2 * 400 + 330] = ROOD;
+        err = kopieer(320, 0, 20, 8, 370, 0);
+        UART_Report("kopieer in surface breder dan scherm", &err);
+        UART_Check("kopie in surface", breed[2 * 400 + 380] == ROOD);
+        err = kopieer(0, 0, 10, 10, 20, 0);
+        UART_Report("kopieer onder surface fout", &err);
+        UART_Check("hoogte volgt de surface", err.error_var4 == ERROR_HOOGTE);
+        raster_zet_doel(NULL);
+    }
+
+    UB_VGA_ClearDirty();
+    UART2_WriteString("=== KOPIEER TEST END ===\n");
+}
+
+/* ===== BLITTER TEST ===== */
+
+#if VGA_HAS_BLIT
+static volatile int blitter_klaar = 0;
+
+static void blitter_callback(void)
+{
+    blitter_klaar++;
+}
+#endif
+
+void test_VGA_blitter(void)
+{
+    UART2_WriteString("\n=== BLITTER TEST START ===\n");
+
+#if VGA_HAS_BLIT
+    const int p = VGA.mode.pitch;
+    uint32_t start, cycli_vrij, cycli_klaar;
+    char buf[96];
+    int ok = 1;
+
+    UB_VGA_BlitWait();
+    UB_VGA_BlitSetCallback(blitter_callback);
+    blitter_klaar = 0;
+
+    // clearscherm keert terug terwijl de DMA nog wist
+    start = DWT_CYCCNT_REG;
+    (void)clearscherm("geel");
+    cycli_vrij = DWT_CYCCNT_REG - start;
+    UART_Check("clearscherm loopt nog na terugkeer", UB_VGA_BlitBusy() == 1);
+    UB_VGA_BlitWait();
+    cycli_klaar = DWT_CYCCNT_REG - start;
+    sprintf(buf, "[BENCH] clearscherm via DMA: CPU vrij na %lu cycli, klaar na %lu cycli\n",
+            (unsigned long)cycli_vrij, (unsigned long)cycli_klaar);
+    UART2_WriteString(buf);
+    UART_Check("callback één keer", blitter_klaar == 1);
+    UART_Check("scherm geel, rand zwart",
+               VGA_RAM1[0] == GEEL && VGA_RAM1[VGA.mode.width - 1] == GEEL &&
+               VGA_RAM1[(scherm_hoogte() - 1) * p + 5] == GEEL && VGA_RAM1[VGA.mode.width] == ZWART);
+
+    // rechthoek op een oneven x : begin en eind door de CPU, midden door de DMA
+    (void)rechthoek(33, 10, 101, 60, "rood", 1);
+    (void)drawPixel(0, 0, "blauw");   // wacht op de blitter
+    UART_Check("gevulde rechthoek oneven x",
+               VGA_RAM1[10 * p + 32] == GEEL && VGA_RAM1[10 * p + 33] == ROOD &&
+               VGA_RAM1[69 * p + 133] == ROOD && VGA_RAM1[69 * p + 134] == GEEL &&
+               VGA_RAM1[70 * p + 33] == GEEL);
+
+    // kopie naar een andere uitlijning en 3 regels lager (van onder naar boven)
+    for (int x = 0; x < 101; x++)
+        UB_VGA_SetPixel(33 + x, 10, (uint8_t)x);
+    (void)kopieer(33, 10, 101, 60, 30, 13);
+    UB_VGA_BlitWait();
+    for (int x = 0; x < 101; x++)
+        if (VGA_RAM1[13 * p + 30 + x] != (uint8_t)x) ok = 0;
+    UART_Check("kopie via DMA, andere uitlijning", ok);
+    UART_Check("kopie via DMA, onderste regel", VGA_RAM1[72 * p + 130] == ROOD);
+    UART_Check("callbacks", blitter_klaar == 3);
+
+    UB_VGA_BlitSetCallback(0);
+#else
+    UART_Check("geen blitter in deze modus", UB_VGA_BlitBusy() == 0);
+#endif
+
+    UB_VGA_ClearDirty();
+    UART2_WriteString("=== BLITTER TEST END ===\n");
+}
+
+/* ===== SURFACE TEST ===== */
+
+#define SURFACE_TEST_B      40
+#define SURFACE_TEST_H      20
+#define SURFACE_TEST_PITCH  44
+
+static uint8_t surface_test_buf[SURFACE_TEST_PITCH * SURFACE_TEST_H];
+
+void test_VGA_surface(void)
+{
+    Surface s;
+    ErrorList err;
+    uint32_t start, cycli_direct, cycli_blit;
+    char buf[96];
+    int ok = 1;
+
+    UART2_WriteString("\n=== SURFACE TEST START ===\n");
+
+    // padding achter elke rij mag nooit beschreven worden
+    for (int i = 0; i < (int)sizeof(surface_test_buf); i++)
+        surface_test_buf[i] = 0x55;
+    surface_init(&s, surface_test_buf, SURFACE_TEST_B, SURFACE_TEST_H, SURFACE_TEST_PITCH);
+
+    raster_zet_doel(&s);
+    UART_Check("doel is surface", raster_doel() == &s);
+    UART_Check("maten van de surface",
+               raster_doel_breedte() == SURFACE_TEST_B && raster_doel_hoogte() == SURFACE_TEST_H);
+
+    // dezelfde API, gevalideerd tegen de surface
+    err = clearscherm("blauw");
+    UART_Report("clearscherm in surface", &err);
+    err = rechthoek(30, 0, 20, 5, "rood", 1);
+    UART_Report("rechthoek buiten surface fout", &err);
+    err = drawPixel(SURFACE_TEST_B, 0, "rood");
+    UART_Report("pixel buiten surface fout", &err);
+    err = rechthoek(2, 2, 10, 6, "rood", 0);
+    UART_Report("rand in surface", &err);
+    err = lijn(0, 19, 39, 0, "geel", 3, RASTER_KAP_VIERKANT);
+    UART_Report("dikke lijn over de rand fout", &err);
+    err = lijn(0, 19, 39, 0, "geel", 1, RASTER_KAP_VIERKANT);
+    UART_Report("lijn van hoek tot hoek", &err);
+    err = tekst(20, 10, "wit", "Hi", "pearl", 1, "cursief");
+    UART_Report("tekst in surface", &err);
+
+    for (int y = 0; y < SURFACE_TEST_H; y++)
+        for (int x = SURFACE_TEST_B; x < SURFACE_TEST_PITCH; x++)
+            if (surface_test_buf[y * SURFACE_TEST_PITCH + x] != 0x55) ok = 0;
+    UART_Check("padding ongewijzigd", ok);
+    UART_Check("rand rood, binnen blauw",
+               surface_test_buf[2 * SURFACE_TEST_PITCH + 2] == ROOD &&
+               surface_test_buf[7 * SURFACE_TEST_PITCH + 11] == ROOD &&
+               surface_test_buf[4 * SURFACE_TEST_PITCH + 4] == BLAUW);
+    UART_Check("lijn in de hoek", surface_test_buf[19 * SURFACE_TEST_PITCH] == GEEL);
+
+    raster_zet_doel(NULL);
+    UART_Check("doel weer het scherm",
+               raster_doel()->formaat == SURFACE_SCHERM && raster_doel_breedte() == VGA.mode.width);
+
+#if VGA_HAS_COPY
+    const int p = VGA.mode.pitch;
+
+    // surface naar het scherm, ook geclipt aan de linkerrand
+    (void)clearscherm("zwart");
+    raster_blit(&s, 100, 50, 0);
+    raster_blit(&s, -10, 0, 0);
+    UB_VGA_BlitWait();
+    ok = 1;
+    for (int y = 0; y < SURFACE_TEST_H; y++)
+        for (int x = 0; x < SURFACE_TEST_B; x++)
+            if (VGA_RAM1[(50 + y) * p + 100 + x] != surface_test_buf[y * SURFACE_TEST_PITCH + x]) ok = 0;
+    UART_Check("blit gelijk aan surface", ok);
+    UART_Check("blit geclipt links", VGA_RAM1[0] == surface_test_buf[10]);
+    UART_Check("naast blit ongewijzigd", VGA_RAM1[50 * p + 140] == ZWART);
+
+    // transparant : 0xFF laat het scherm staan
+    surface_test_buf[0] = 0xFF;
+    raster_blit(&s, 100, 50, 1);
+    UART_Check("transparante pixel overgeslagen", VGA_RAM1[50 * p + 100] == BLAUW);
+
+    // uitgesteld : in banden, pas zichtbaar na de wachtrij
+    (void)uitgesteld_tekenen(1);
+    raster_blit(&s, 200, 100, 0);
+    (void)uitgesteld_tekenen(0);
+    UART_Check("uitgestelde blit", VGA_RAM1[119 * p + 239] == surface_test_buf[19 * SURFACE_TEST_PITCH + 39]);
+#endif
+
+    // eenmaal tekenen en kopiëren tegen elke keer opnieuw tekenen
+    start = DWT_CYCCNT_REG;
+    (void)tekst(100, 50, "wit", "Hi", "pearl", 2, "vet");
+    cycli_direct = DWT_CYCCNT_REG - start;
+    start = DWT_CYCCNT_REG;
+    raster_blit(&s, 100, 50, 0);
+    cycli_blit = DWT_CYCCNT_REG - start;
+    sprintf(buf, "[BENCH] tekst direct: %lu cycli, surface 40x20 blit: %lu cycli\n",
+            (unsigned long)cycli_direct, (unsigned long)cycli_blit);
+    UART2_WriteString(buf);
+
+    UB_VGA_ClearDirty();
+    UART2_WriteString("=== SURFACE TEST END ===\n");
+}
+
+/* ===== CIRKEL TEST ===== */
+
+/** @brief Ring van een test */
+typedef struct
+{
+    int x0, y0, radius, dikte;
+    uint8_t kleur;
+} TestRing;
+
+static void teken_test_ring(const void *arg)
+{
+    const TestRing *r = (const TestRing *)arg;
+
+    raster_ring(r->x0, r->y0, r->radius, r->dikte, r->kleur);
+}
+
+/**
+ * @brief Hoort pixel (x, y) bij de ring?
+ *
+ * Schijf met straal radius (dx*dx + dy*dy <= r*r + r) zonder de schijf
+ * met straal radius - dikte; vanaf dikte = radius is er geen gat.
+ */
+static int in_ring(int x, int y, const void *arg)
+{
+    const TestRing *r = (const TestRing *)arg;
+    int d = (x - r->x0) * (x - r->x0) + (y - r->y0) * (y - r->y0);
+    int binnen = r->radius - r->dikte;
+
+    if (d > r->radius * r->radius + r->radius)
+        return 0;
+    return r->dikte >= r->radius || d > binnen * binnen + binnen;
+}
+
+void test_raster_ring(void)
+{
+    // in een surface van 41x41, middelpunt (20, 20), straal 20
+    static const TestRing schijf = {20, 20, 20, 21, ROOD};
+    static const TestRing ring = {20, 20, 20, 5, GEEL};
+    static const TestRing vol = {20, 20, 20, 20, BLAUW};
+
+    UART2_WriteString("\n=== CIRKEL TEST START ===\n");
+
+    UART_CheckVorm("schijf volgens midpoint-criterium", 41, 41, ROOD,
+                   teken_test_ring, &schijf, in_ring, &schijf);
+    UART_Check("schijf raakt de rand",
+               vorm_buf[20 * 41] == ROOD && vorm_buf[20] == ROOD && vorm_buf[0] == ZWART);
+
+    // ring van 5 : schijf r = 20 zonder schijf r = 15
+    UART_CheckVorm("ring zonder gaten, gat heel", 41, 41, GEEL,
+                   teken_test_ring, &ring, in_ring, &ring);
+
+    // dikte = radius : dezelfde schijf, ook het middelpunt
+    UART_CheckVorm("dikte = radius is een schijf", 41, 41, BLAUW,
+                   teken_test_ring, &vol, in_ring, &vol);
+    UART_Check("dikte = radius zonder gat in het middelpunt", vorm_buf[20 * 41 + 20] == BLAUW);
+
+    // uitgesteld : in banden, zelfde pixels
+    raster_zet_doel(NULL);
+    (void)clearscherm("zwart");
+    (void)uitgesteld_tekenen(1);
+    (void)cirkel(160, 120, 100, "rood", 1, 1);
+    UART_Check("uitgestelde schijf in de wachtrij", raster_wachtrij_aantal() == 1);
+    (void)uitgesteld_tekenen(0);
+#if VGA_HAS_COPY
+    UART_Check("uitgestelde schijf getekend",
+               VGA_RAM1[20 * VGA.mode.pitch + 160] == ROOD &&
+               VGA_RAM1[220 * VGA.mode.pitch + 160] == ROOD &&
+               VGA_RAM1[120 * VGA.mode.pitch + 60] == ROOD &&
+               VGA_RAM1[19 * VGA.mode.pitch + 160] == ZWART);
+#endif
+
+    (void)clearscherm("zwart");
+    UB_VGA_ClearDirty();
+    UART2_WriteString("=== CIRKEL TEST END ===\n");
+}
+
+/* ===== DIKKE LIJN TEST ===== */
+
+/** @brief Lijn van een test */
+typedef struct
+{
+    int x1, y1, x2, y2, dikte, kap;
+    uint8_t kleur;
+} TestLijn;
+
+static void teken_test_lijn(const void *arg)
+{
+    const TestLijn *l = (const TestLijn *)arg;
+
+    raster_lijn(l->x1, l->y1, l->x2, l->y2, l->kleur, l->dikte, l->kap);
+}
+
+/**
+ * @brief Hoort pixel (x, y) bij de balk van (x1, y1) naar (x2, y2)?
+ *
+ * Zelfde criterium als raster_lijn(), in kwadraten zodat er geen wortel nodig is.
+ */
+static int in_balk(int x, int y, const void *arg)
+{
+    const TestLijn *l = (const TestLijn *)arg;
+    int x1 = l->x1, y1 = l->y1, x2 = l->x2, y2 = l->y2;
+    int dikte = l->dikte, kap = l->kap;
+    int dx = x2 - x1;
+    int dy = y2 - y1;
+    int l2 = dx * dx + dy * dy;
+    int kruis = dx * (y - y1) - dy * (x - x1);
+    int punt = dx * (x - x1) + dy * (y - y1);
+    int d2l2 = dikte * dikte * l2;
+
+    if (kap == RASTER_KAP_ROND &&
+        (4 * ((x - x1) * (x - x1) + (y - y1) * (y - y1)) <= dikte * dikte ||
+         4 * ((x - x2) * (x - x2) + (y - y2) * (y - y2)) <= dikte * dikte))
+        return 1;
+
+    /* een punt met ronde uiteinden is alleen de schijf */
+    if (kap == RASTER_KAP_ROND && l2 == 0)
+        return 0;
+
+    if (4 * kruis * kruis > d2l2)
+        return 0;
+
+    if (kap == RASTER_KAP_VIERKANT)
+        return (punt >= 0 || 4 * punt * punt <= d2l2) &&
+               (punt <= l2 || 4 * (punt - l2) * (punt - l2) <= d2l2);
+
+    return punt >= 0 && punt <= l2;
+}
+
+void test_raster_lijn(void)
+{
+    static const char *namen[3] = {"vierkant", "rond", "plat"};
+    static const TestLijn horizontaal = {10, 20, 30, 20, 5, RASTER_KAP_VIERKANT, ROOD};
+    static const TestLijn punt = {20, 20, 20, 20, 6, RASTER_KAP_ROND, BLAUW};
+    static const TestLijn rand = {2, 2, 38, 38, 9, RASTER_KAP_VIERKANT, GROEN};
+    char tekst[48];
+
+    UART2_WriteString("\n=== DIKKE LIJN TEST START ===\n");
+
+    // horizontaal, dikte 5 : de rechthoek van voorheen (2 pixels rondom)
+    UART_CheckVorm("horizontale lijn volgens de balk", 41, 41, ROOD,
+                   teken_test_lijn, &horizontaal, in_balk, &horizontaal);
+    UART_Check("horizontale lijn is een rechthoek",
+               vorm_buf[18 * 41 + 8] == ROOD && vorm_buf[22 * 41 + 32] == ROOD &&
+               vorm_buf[17 * 41 + 8] == ZWART && vorm_buf[22 * 41 + 33] == ZWART);
+
+    // schuin, dikte 7, elk uiteinde
+    for (int kap = RASTER_KAP_VIERKANT; kap <= RASTER_KAP_PLAT; kap++)
+    {
+        TestLijn schuin = {8, 10, 32, 30, 7, kap, GEEL};
+
+        snprintf(tekst, sizeof(tekst), "schuine lijn, uiteinde %s", namen[kap]);
+        UART_CheckVorm(tekst, 41, 41, GEEL, teken_test_lijn, &schuin, in_balk, &schuin);
+    }
+
+    // alleen een punt met ronde uiteinden : een schijf
+    UART_CheckVorm("punt met ronde uiteinden", 41, 41, BLAUW,
+                   teken_test_lijn, &punt, in_balk, &punt);
+    UART_Check("punt met ronde uiteinden is een schijf",
+               vorm_buf[20 * 41 + 23] == BLAUW && vorm_buf[20 * 41 + 24] == ZWART &&
+               vorm_buf[17 * 41 + 17] == ZWART && vorm_buf[18 * 41 + 18] == BLAUW);
+
+    // vierkant uiteinde over de rand van de surface : geclipt
+    UART_CheckVorm("uiteinde over de rand geclipt", 41, 41, GROEN,
+                   teken_test_lijn, &rand, in_balk, &rand);
+    UART_Check("uiteinde tot in de hoeken", vorm_buf[0] == GROEN && vorm_buf[40 * 41 + 40] == GROEN);
+
+    raster_zet_doel(NULL);
+    UART2_WriteString("=== DIKKE LIJN TEST END ===\n");
+}
+
+/* ===== VEELHOEK TEST ===== */
+
+/** @brief Veelhoek van een test */
+typedef struct
+{
+    const int *punten;
+    int aantal, vulling;
+    uint8_t kleur;
+    const uint8_t *rand;  /**< alleen de rand, 64x64 (voor het orakel) */
+} TestVeelhoek;
+
+static void teken_test_veelhoek(const void *arg)
+{
+    const TestVeelhoek *v = (const TestVeelhoek *)arg;
+
+    raster_veelhoek(v->punten, v->aantal, v->kleur, v->vulling);
+}
+
+/**
+ * @brief Ligt pixel (x, y) binnen de veelhoek volgens de vulregel, of op de rand?
+ *
+ * Telt de randen die rij y bedekken (bovenste punt tot, zonder, het
+ * onderste punt) en links van of op x liggen, exact met gehele getallen.
+ * De Bresenham-rand die over de vulling komt, staat in v->rand.
+ */
+static int in_veelhoek(int x, int y, const void *arg)
+{
+    const TestVeelhoek *v = (const TestVeelhoek *)arg;
+    const int *punten = v->punten;
+    int aantal = v->aantal;
+    int vulling = v->vulling;
+    int omloop = 0;
+    int kruisingen = 0;
+
+    for (int i = 0; i < aantal; i++)
+    {
+        int j = (i + 1 < aantal) ? i + 1 : 0;
+        int x0 = punten[2 * i], y0 = punten[2 * i + 1];
+        int x1 = punten[2 * j], y1 = punten[2 * j + 1];
+        int richting = 1;
+
+        if (y0 == y1)
+            continue;
+        if (y0 > y1)
+        {
+            int t = x0; x0 = x1; x1 = t;
+            t = y0; y0 = y1; y1 = t;
+            richting = -1;
+        }
+        if (y < y0 || y >= y1)
+            continue;
+
+        // rand op rij y ligt op x0 + (y - y0) * (x1 - x0) / (y1 - y0) <= x
+        if ((x - x0) * (y1 - y0) >= (y - y0) * (x1 - x0))
+        {
+            omloop += richting;
+            kruisingen++;
+        }
+    }
+
+    if (v->rand[y * 64 + x] == v->kleur)
+        return 1;
+    return (vulling == RASTER_VUL_EVEN_ONEVEN) ? (kruisingen & 1) : (omloop != 0);
+}
+
+void test_raster_veelhoek(void)
+{
+    static uint8_t rand[64 * 64];
+    // pijl (hol), ster (snijdt zichzelf) en een driehoek met een steile rand
+    static const int pijl[] = {4, 20, 30, 20, 30, 6, 58, 32, 30, 58, 30, 44, 4, 44};
+    static const int ster[] = {32, 2, 50, 60, 3, 22, 61, 22, 14, 60};
+    static const int steil[] = {1, 1, 3, 62, 62, 40};
+    static const int *vormen[3] = {pijl, ster, steil};
+    static const int aantallen[3] = {7, 5, 3};
+    Surface r;
+    char tekst[56];
+
+    UART2_WriteString("\n=== VEELHOEK TEST START ===\n");
+
+    surface_init(&r, rand, 64, 64, 64);
+
+    // elke vorm met beide regels : binnen volgens de regel, plus de rand
+    for (int v = 0; v < 3; v++)
+    {
+        raster_zet_doel(&r);
+        raster_rechthoek(0, 0, 64, 64, ZWART, 1);
+        raster_veelhoek(vormen[v], aantallen[v], ROOD, RASTER_VUL_RAND);
+
+        for (int vulling = RASTER_VUL_EVEN_ONEVEN; vulling <= RASTER_VUL_NIET_NUL; vulling++)
+        {
+            TestVeelhoek vorm = {vormen[v], aantallen[v], vulling, ROOD, rand};
+
+            snprintf(tekst, sizeof(tekst), "veelhoek %d, %s", v,
+                     (vulling == RASTER_VUL_NIET_NUL) ? "niet-nul" : "even-oneven");
+            UART_CheckVorm(tekst, 64, 64, ROOD, teken_test_veelhoek, &vorm, in_veelhoek, &vorm);
+        }
+    }
+
+    // midden van de ster : gevuld bij niet-nul, gat bij even-oneven
+    raster_rechthoek(0, 0, 64, 64, ZWART, 1);
+    raster_veelhoek(ster, 5, GEEL, RASTER_VUL_NIET_NUL);
+    UART_Check("ster niet-nul gevuld", vorm_buf[32 * 64 + 32] == GEEL);
+    raster_rechthoek(0, 0, 64, 64, ZWART, 1);
+    raster_veelhoek(ster, 5, GEEL, RASTER_VUL_EVEN_ONEVEN);
+    UART_Check("ster even-oneven hol", vorm_buf[32 * 64 + 32] == ZWART && vorm_buf[10 * 64 + 32] == GEEL);
+
+#if VGA_HAS_COPY
+    // via de commandoregel met het getal uit de handleiding: 1 = even-oneven, 2 = niet-nul
+    raster_zet_doel(NULL);
+    (void)clearscherm("zwart");
+    verwerk_commando("veelhoek,geel,1,160,20,207,165,84,75,236,75,113,165");
+    UART_Check("veelhoek gevuld 1 is even-oneven",
+               VGA_RAM1[110 * VGA.mode.pitch + 160] == ZWART &&
+               VGA_RAM1[50 * VGA.mode.pitch + 160] == GEEL);
+    verwerk_commando("veelhoek,geel,2,160,20,207,165,84,75,236,75,113,165");
+    UART_Check("veelhoek gevuld 2 is niet-nul", VGA_RAM1[110 * VGA.mode.pitch + 160] == GEEL);
+
+    // een losse x zonder y: fout, er wordt niets getekend
+    (void)clearscherm("zwart");
+    verwerk_commando("veelhoek,geel,2,160,20,207,165,84,75,236,75,113,165,20");
+    UART_Check("veelhoek met losse x niet getekend", VGA_RAM1[110 * VGA.mode.pitch + 160] == ZWART);
+#endif
+
+    // uitgesteld : in banden, zelfde pixels
+    raster_zet_doel(NULL);
+    (void)clearscherm("zwart");
+    (void)uitgesteld_tekenen(1);
+    {
+        static const int groot[] = {10, 10, 300, 30, 160, 230};
+        (void)veelhoek(groot, 3, "blauw", RASTER_VUL_NIET_NUL);
+    }
+    UART_Check("uitgestelde veelhoek in de wachtrij", raster_wachtrij_aantal() == 4);
+    (void)uitgesteld_tekenen(0);
+#if VGA_HAS_COPY
+    UART_Check("uitgestelde veelhoek getekend",
+               VGA_RAM1[100 * VGA.mode.pitch + 160] == BLAUW &&
+               VGA_RAM1[200 * VGA.mode.pitch + 160] == BLAUW &&
+               VGA_RAM1[200 * VGA.mode.pitch + 60] == ZWART);
+#endif
+
+    (void)clearscherm("zwart");
+    UB_VGA_ClearDirty();
+    UART2_WriteString("=== VEELHOEK TEST END ===\n");
+}
+
+/* ===== STEMPELCACHE TEST ===== */
+
+void test_stempel_cache(void)
+{
+    StempelStatistiek st;
+    ErrorList err;
+    uint32_t start, cycli_direct, cycli_stempel;
+    char buf[96];
+
+    UART2_WriteString("\n=== STEMPELCACHE TEST START ===\n");
+
+    stempel_leeg();
+    (void)clearscherm("zwart");
+
+    // zelfde toren direct, als misser en als treffer
+    stempel_cache_aan(0);
+    start = DWT_CYCCNT_REG;
+    err = toren(50, 150, 20, "rood", "geel");
+    cycli_direct = DWT_CYCCNT_REG - start;
+    UART_Report("toren direct", &err);
+    stempel_cache_aan(1);
+
+    err = toren(120, 150, 20, "rood", "wit");
+    UART_Report("toren met witte vlag", &err);
+    stempel_statistiek(&st);
+    UART_Check("wit (transparant) niet in de cache", st.missers == 0 && st.treffers == 0);
+
+    (void)clearscherm("zwart");
+    (void)toren(50, 150, 20, "rood", "geel");
+    err = toren(120, 150, 20, "rood", "geel");
+    UART_Report("toren als misser", &err);
+    start = DWT_CYCCNT_REG;
+    err = toren(190, 150, 20, "rood", "geel");
+    cycli_stempel = DWT_CYCCNT_REG - start;
+    UART_Report("toren als treffer", &err);
+
+    stempel_statistiek(&st);
+    UART_Check("1 misser, 2 treffers", st.missers == 1 && st.treffers == 2 && st.aantal == 1);
+
+#if VGA_HAS_COPY
+    const int p = VGA.mode.pitch;
+    int ok = 1;
+
+    // nog een keer direct ernaast, zonder cache
+    stempel_cache_aan(0);
+    (void)rechthoek(250, 60, 50, 120, "zwart", 1);
+    (void)toren(270, 150, 20, "rood", "geel");
+    stempel_cache_aan(1);
+    for (int y = 150 - 68; y <= 150 + 20; y++)
+        for (int x = -20; x <= 20; x++)
+            if (VGA_RAM1[y * p + 120 + x] != VGA_RAM1[y * p + 270 + x] ||
+                VGA_RAM1[y * p + 190 + x] != VGA_RAM1[y * p + 270 + x]) ok = 0;
+    UART_Check("stempel gelijk aan directe toren", ok);
+#endif
+
+    // meer kleuren dan plaatsen : de oudste stempel gaat eruit
+    const char *kleuren[] = { "blauw", "groen", "cyaan", "rood", "magenta", "bruin",
+                              "grijs", "lichtblauw", "lichtgroen" };
+    for (int i = 0; i < 9; i++)
+        (void)toren(40 + i * 30, 100, 10, kleuren[i], "geel");
+    stempel_statistiek(&st);
+    UART_Check("maximaal STEMPEL_AANTAL stempels", st.aantal == STEMPEL_AANTAL && st.verwijderd >= 1);
+    UART_Check("arena niet overschreden", st.bytes <= STEMPEL_ARENA_GROOTTE);
+
+    sprintf(buf, "[BENCH] toren direct: %lu cycli, uit de stempelcache: %lu cycli\n",
+            (unsigned long)cycli_direct, (unsigned long)cycli_stempel);
+    UART2_WriteString(buf);
+
+    (void)clearscherm("zwart");
+    UB_VGA_ClearDirty();
+    UART2_WriteString("=== STEMPELCACHE TEST END ===\n");
+}
+
+/* ===== BENCHMARK ===== */
+
+static void UART_Report_Snelheid(const char* naam, uint32_t cycli, uint32_t pixels)
+{
+    char buf[128];
+    uint32_t pixels_per_s = 0;
+
+    if (cycli != 0)
+        pixels_per_s = (uint32_t)(((uint64_t)pixels * SystemCoreClock) / cycli);
+
+    sprintf(buf, "[BENCH] %s: %lu cycli, %lu pixels/s\n",
+            naam, (unsigned long)cycli, (unsigned long)pixels_per_s);
+    UART2_WriteString(buf);
+}
+
+#if VGA_HAS_COPY
+static void UART_Report_MBs(const char* naam, uint32_t cycli, uint32_t bytes)
+{
+    char buf[128];
+    uint32_t kb_per_s = 0;
+
+    if (cycli != 0)
+        kb_per_s = (uint32_t)(((uint64_t)bytes * SystemCoreClock) / ((uint64_t)cycli * 1000));
+
+    sprintf(buf, "[BENCH] %s: %lu cycli, %lu.%02lu MB/s\n",
+            naam, (unsigned long)cycli,
+            (unsigned long)(kb_per_s / 1000), (unsigned long)((kb_per_s % 1000) / 10));
+    UART2_WriteString(buf);
+}
+#endif
+
+void benchmark_APIdraw(void)
+{
+    const int herhalingen = 4;
+    uint32_t start;
+    uint32_t cycli;
+    uint32_t schijf_pixels = 0;
+    uint32_t ring_pixels = 0;
+
+    UART2_WriteString("\n=== API DRAW BENCHMARK START ===\n");
+    UART2_WriteString(VGA_DMA_FIFO ? "[BENCH] pixel-DMA: FIFO, woord lezen\n"
+                                   : "[BENCH] pixel-DMA: direct, byte lezen\n");
+    UART2_WriteString(VGA_USE_RAMFUNC ? "[BENCH] kernels: RAM (.ramfunc)\n"
+                                      : "[BENCH] kernels: flash\n");
+
+    // gevulde rechthoek, volledig scherm
+    start = DWT_CYCCNT_REG;
+    for (int i = 0; i < herhalingen; i++)
+        (void)rechthoek(0, 0, VGA_DISPLAY_X, VGA_DISPLAY_Y, (i & 1) ? "blauw" : "rood", 1);
+    UB_VGA_BlitWait();
+    cycli = DWT_CYCCNT_REG - start;
+    UART_Report_Snelheid("rechthoek gevuld 320x240", cycli,
+                         herhalingen * VGA_DISPLAY_X * VGA_DISPLAY_Y);
+
+    // dikke lijn, 200 pixels lang met dikte 9
+    start = DWT_CYCCNT_REG;
+    for (int i = 0; i < herhalingen; i++)
+        (void)lijn(20, 20 + i, 220, 120 + i, "groen", 9, RASTER_KAP_VIERKANT);
+    cycli = DWT_CYCCNT_REG - start;
+    UART_Report_Snelheid("lijn 200px dikte 9", cycli, herhalingen * 201 * 9);
+
+    // gevulde cirkel en dikke ring, straal 100 (één span per rij)
+    for (int dy = -100; dy <= 100; dy++)
+        for (int dx = -100; dx <= 100; dx++)
+        {
+            int d = dx * dx + dy * dy;
+            if (d <= 100 * 100 + 100) schijf_pixels++;
+            if (d <= 100 * 100 + 100 && d > 90 * 90 + 90) ring_pixels++;
+        }
+    start = DWT_CYCCNT_REG;
+    for (int i = 0; i < herhalingen; i++)
+        (void)cirkel(160, 120, 100, (i & 1) ? "geel" : "blauw", 1, 1);
+    cycli = DWT_CYCCNT_REG - start;
+    UART_Report_Snelheid("cirkel gevuld r=100", cycli, herhalingen * schijf_pixels);
+
+    start = DWT_CYCCNT_REG;
+    for (int i = 0; i < herhalingen; i++)
+        (void)cirkel(160, 120, 100, (i & 1) ? "geel" : "blauw", 0, 10);
+    cycli = DWT_CYCCNT_REG - start;
+    UART_Report_Snelheid("cirkel ring r=100 dikte 10", cycli, herhalingen * ring_pixels);
+
+    // gevulde holle veelhoek (pijl van 200x200, ongeveer 20000 pixels), span per rij plus de rand
+    {
+        static const int pijl[] = {60, 70, 160, 70, 160, 20, 260, 120, 160, 220, 160, 170, 60, 170};
+
+        start = DWT_CYCCNT_REG;
+        for (int i = 0; i < herhalingen; i++)
+            (void)veelhoek(pijl, 7, (i & 1) ? "geel" : "blauw", RASTER_VUL_NIET_NUL);
+        cycli = DWT_CYCCNT_REG - start;
+        UART_Report_Snelheid("veelhoek gevuld 7 punten 200x200", cycli,
+                             herhalingen * (100 * 100 + 100 * 100));
+    }
+
+    // clearscherm
+    start = DWT_CYCCNT_REG;
+    for (int i = 0; i < herhalingen; i++)
+        (void)clearscherm((i & 1) ? "zwart" : "wit");
+    UB_VGA_BlitWait();
+    cycli = DWT_CYCCNT_REG - start;
+    UART_Report_Snelheid("clearscherm", cycli,
+                         herhalingen * VGA_DISPLAY_X * VGA_DISPLAY_Y);
+
+    // gevulde rechthoek tijdens actief beeld (pixel-DMA loopt)
+    // 320x16 = 5120 bytes per keer, start direct na de blanking
+    UB_VGA_WaitVBlank();
+    while (UB_VGA_InVBlank())
+        ;
+    start = DWT_CYCCNT_REG;
+    for (int i = 0; i < herhalingen; i++)
+        UB_VGA_FillRect(0, (uint16_t)(i * 16), VGA_DISPLAY_X, 16, (i & 1) ? BLAUW : ROOD);
+    UB_VGA_BlitWait();
+    cycli = DWT_CYCCNT_REG - start;
+    UART_Report_Snelheid("rechthoek 320x16 actief beeld", cycli,
+                         herhalingen * VGA_DISPLAY_X * 16);
+
+    // dezelfde rechthoek tijdens de verticale blanking (geen pixel-DMA)
+    UB_VGA_WaitVBlank();
+    start = DWT_CYCCNT_REG;
+    for (int i = 0; i < herhalingen; i++)
+        UB_VGA_FillRect(0, (uint16_t)(i * 16), VGA_DISPLAY_X, 16, (i & 1) ? ROOD : BLAUW);
+    UB_VGA_BlitWait();
+    cycli = DWT_CYCCNT_REG - start;
+    UART_Report_Snelheid("rechthoek 320x16 blanking", cycli,
+                         herhalingen * VGA_DISPLAY_X * 16);
+
+    // 4bpp regel-expansie (moet ruim binnen één lijn van ~4000 cycli passen)
+    {
+        static uint16_t paren[VGA_EXPAND_PAIR_SIZE];
+        static uint8_t bron[VGA_DISPLAY_X / 2];
+        static uint32_t regel[VGA_DISPLAY_X / 4];
+        static const uint8_t palet[VGA_EXPAND_PAL_SIZE] = { 0 };
+
+        UB_VGA_BuildPairLut(paren, palet);
+        start = DWT_CYCCNT_REG;
+        for (int i = 0; i < herhalingen; i++)
+            UB_VGA_ExpandLine4bpp((uint8_t *)regel, bron, paren, VGA_DISPLAY_X);
+        cycli = DWT_CYCCNT_REG - start;
+        UART_Report_Snelheid("4bpp regel-expansie", cycli, herhalingen * VGA_DISPLAY_X);
+    }
+
+    // tekstregel uit 40 cellen (zelfde budget van één lijn)
+    {
+        static uint32_t maskers[VGA_EXPAND_MASK_SIZE];
+        static uint32_t kleuren[VGA_EXPAND_PAL_SIZE];
+        static uint8_t cellen[(VGA_DISPLAY_X / 8) * 2];
+        static uint32_t regel[VGA_DISPLAY_X / 4];
+        static const uint8_t palet[VGA_EXPAND_PAL_SIZE] = { 0 };
+
+        for (int i = 0; i < (VGA_DISPLAY_X / 8); i++)
+        {
+            cellen[2 * i] = (uint8_t)('A' + (i % 26));
+            cellen[2 * i + 1] = VGA_TEXT_ATTR(i & 0x0F, 0);
+        }
+        UB_VGA_BuildTextLuts(maskers, kleuren, palet);
+        start = DWT_CYCCNT_REG;
+        for (int i = 0; i < herhalingen; i++)
+            UB_VGA_ExpandTextLine((uint8_t *)regel, cellen, fontdata_pearl8x8 + (i & 7),
+                                  maskers, kleuren, VGA_DISPLAY_X / 8);
+        cycli = DWT_CYCCNT_REG - start;
+        UART_Report_Snelheid("tekstregel 40 cellen", cycli, herhalingen * VGA_DISPLAY_X);
+    }
+
+    // 640 pixels 1bpp en 2bpp (hires: elke lijn, niet elke tweede)
+    {
+        static uint32_t lut[VGA_EXPAND_LUT2_SIZE];
+        static uint8_t bron[640 / 4];
+        static uint32_t regel[640 / 4];
+        static const uint8_t palet4[4] = { 0 };
+
+        UB_VGA_BuildPackedLut(lut, palet4, 1);
+        start = DWT_CYCCNT_REG;
+        for (int i = 0; i < herhalingen; i++)
+            UB_VGA_ExpandLine1bpp((uint8_t *)regel, bron, lut, 640);
+        cycli = DWT_CYCCNT_REG - start;
+        UART_Report_Snelheid("1bpp regel-expansie 640", cycli, herhalingen * 640);
+
+        UB_VGA_BuildPackedLut(lut, palet4, 2);
+        start = DWT_CYCCNT_REG;
+        for (int i = 0; i < herhalingen; i++)
+            UB_VGA_ExpandLine2bpp((uint8_t *)regel, bron, lut, 640);
+        cycli = DWT_CYCCNT_REG - start;
+        UART_Report_Snelheid("2bpp regel-expansie 640", cycli, herhalingen * 640);
+    }
+
+#if VGA_HAS_COPY
+    // rechthoek kopiëren 256x128 (start in de blanking) : zelfde uitlijning,
+    // andere uitlijning (woorden via unaligned LDR) en overlap 1 regel omhoog
+    UB_VGA_WaitVBlank();
+    start = DWT_CYCCNT_REG;
+    for (int i = 0; i < herhalingen; i++)
+        (void)UB_VGA_CopyRect(0, 0, 256, 128, 64, 100);
+    UB_VGA_BlitWait();
+    cycli = DWT_CYCCNT_REG - start;
+    UART_Report_MBs("kopieer 256x128 uitgelijnd", cycli, herhalingen * 256 * 128);
+
+    UB_VGA_WaitVBlank();
+    start = DWT_CYCCNT_REG;
+    for (int i = 0; i < herhalingen; i++)
+        (void)UB_VGA_CopyRect(0, 0, 256, 128, 63, 100);
+    UB_VGA_BlitWait();
+    cycli = DWT_CYCCNT_REG - start;
+    UART_Report_MBs("kopieer 256x128 niet uitgelijnd", cycli, herhalingen * 256 * 128);
+
+    UB_VGA_WaitVBlank();
+    start = DWT_CYCCNT_REG;
+    for (int i = 0; i < herhalingen; i++)
+        (void)UB_VGA_CopyRect(0, 1, 256, 128, 0, 0);
+    UB_VGA_BlitWait();
+    cycli = DWT_CYCCNT_REG - start;
+    UART_Report_MBs("kopieer 256x128 overlap", cycli, herhalingen * 256 * 128);
+    UB_VGA_ClearDirty();
+#endif
+
+    UART2_WriteString("=== API DRAW BENCHMARK END ===\n");
+}
+
+void benchmark_VGA_isr(void)
+{
+    VGA_IsrProfile_t prof;
+    char buf[128];
+    uint32_t gem = 0;
+    uint32_t frame_cycli = SystemCoreClock / 60;
+
+    UART2_WriteString("\n=== VGA ISR BENCHMARK START ===\n");
+    UART2_WriteString(VGA_VSYNC_HW ? "[BENCH] VSync: Timer3 (hardware)\n"
+                                   : "[BENCH] VSync: software (PB12)\n");
+    UART2_WriteString(VGA_USE_RAMFUNC ? "[BENCH] ISR: RAM (.ramfunc)\n"
+                                      : "[BENCH] ISR: flash\n");
+
+    if (!VGA_ISR_PROFILE)
+    {
+        UART2_WriteString("[BENCH] bouw met VGA_ISR_PROFILE=1 voor metingen\n");
+        UART2_WriteString("=== VGA ISR BENCHMARK END ===\n");
+        return;
+    }
+
+    // precies één frame meten
+    UB_VGA_WaitVBlank();
+    UB_VGA_ResetIsrProfile();
+    UB_VGA_WaitVBlank();
+    UB_VGA_GetIsrProfile(&prof);
+
+    if (prof.cnt != 0)
+        gem = prof.sum / prof.cnt;
+
+    sprintf(buf, "[BENCH] TIM2 ISR: %lu keer, gem %lu cycli, max %lu cycli\n",
+            (unsigned long)prof.cnt, (unsigned long)gem, (unsigned long)prof.max);
+    UART2_WriteString(buf);
+    sprintf(buf, "[BENCH] TIM2 ISR: %lu%% van de CPU-tijd per frame\n",
+            (unsigned long)((100ULL * prof.sum) / frame_cycli));
+    UART2_WriteString(buf);
+    // één TIM2-tick = 2 CPU-cycli, het verschil is de jitter van de lijnstart
+    sprintf(buf, "[BENCH] TIM2 ISR start: %lu..%lu ticks na CC3, jitter %lu cycli\n",
+            (unsigned long)prof.lat_min, (unsigned long)prof.lat_max,
+            (unsigned long)(2 * (prof.lat_max - prof.lat_min)));
+    UART2_WriteString(buf);
+
+    UART2_WriteString("=== VGA ISR BENCHMARK END ===\n");
+}
+
+/* ===== GEHEUGEN ===== */
+
+// symbolen uit STM32F407VGTX_FLASH.ld
+extern uint8_t _sdata[], _edata[], _sbss[], _ebss[];
+extern uint8_t _sramfunc[], _eramfunc[], _eram_used[];
+extern uint8_t _sccmram[], _eccmram[], _sccmbss[], _eccmbss[];
+extern uint8_t _eccm_used[], _estack[];
+
+static void UART_Report_Sectie(const char* naam, const uint8_t* start, const uint8_t* eind)
+{
+    char buf[96];
+
+    sprintf(buf, "[MEM] %-10s 0x%08lX %6lu bytes\n", naam,
+            (unsigned long)(uint32_t)start, (unsigned long)(eind - start));
+    UART2_WriteString(buf);
+}
+
+void rapport_geheugen(void)
+{
+    char buf[96];
+    uint8_t op_stack;
+    uint32_t ram_vrij  = (0x20000000UL + 128UL * 1024UL) - (uint32_t)_eram_used;
+    uint32_t ccm_vrij  = (uint32_t)_estack - (uint32_t)_eccm_used;
+
+    UART2_WriteString("\n=== GEHEUGEN RAPPORT START ===\n");
+
+    UART2_WriteString("[MEM] RAM (DMA bereikbaar)\n");
+    UART_Report_Sectie(".data", _sdata, _edata);
+    UART_Report_Sectie(".ramfunc", _sramfunc, _eramfunc);
+    UART_Report_Sectie(".bss", _sbss, _ebss);
+    sprintf(buf, "[MEM] RAM vrij (na heap): %lu bytes\n", (unsigned long)ram_vrij);
+    UART2_WriteString(buf);
+
+    UART2_WriteString("[MEM] CCMRAM (alleen CPU)\n");
+    UART_Report_Sectie(".ccmram", _sccmram, _eccmram);
+    UART_Report_Sectie(".ccmbss", _sccmbss, _eccmbss);
+    sprintf(buf, "[MEM] CCMRAM vrij voor stack: %lu bytes\n", (unsigned long)ccm_vrij);
+    UART2_WriteString(buf);
+
+    // de stack hoort in de CCM RAM te staan (zie _estack)
+    UART_Check("stack in CCMRAM",
+               (uint32_t)&op_stack >= 0x10000000UL && (uint32_t)&op_stack < (uint32_t)_estack);
+    UART_Check("VGA RAM in RAM (DMA)",
+#if VGA_USE_4BPP || VGA_USE_DLIST || VGA_USE_TEXT || VGA_USE_HIRES
+               (uint32_t)VGA_LineBuf >= 0x20000000UL);
+#else
+               (uint32_t)VGA_RAM1 >= 0x20000000UL);
+#endif
+
+    UART2_WriteString("=== GEHEUGEN RAPPORT END ===\n");
+}
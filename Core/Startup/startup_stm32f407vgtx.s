@@ -44,6 +44,24 @@ defined in linker script */
 .word  _sbss
 /* end address for the .bss section. defined in linker script */
 .word  _ebss
+/* start address for the initialization values of the .ramfunc section.
+defined in linker script */
+.word  _siramfunc
+/* start address for the .ramfunc section. defined in linker script */
+.word  _sramfunc
+/* end address for the .ramfunc section. defined in linker script */
+.word  _eramfunc
+/* start address for the initialization values of the .ccmram section.
+defined in linker script */
+.word  _siccmram
+/* start address for the .ccmram section. defined in linker script */
+.word  _sccmram
+/* end address for the .ccmram section. defined in linker script */
+.word  _eccmram
+/* start address for the .ccmbss section. defined in linker script */
+.word  _sccmbss
+/* end address for the .ccmbss section. defined in linker script */
+.word  _eccmbss
 /* stack used for SystemInit_ExtMemCtl; always internal RAM used */
 
 /**
@@ -77,6 +95,54 @@ LoopCopyDataInit:
   adds  r2, r0, r1
   cmp  r2, r3
   bcc  CopyDataInit
+
+/* Copy the RAM functions from flash to SRAM */
+  movs  r1, #0
+  b  LoopCopyRamFunc
+
+CopyRamFunc:
+  ldr  r3, =_siramfunc
+  ldr  r3, [r3, r1]
+  str  r3, [r0, r1]
+  adds  r1, r1, #4
+
+LoopCopyRamFunc:
+  ldr  r0, =_sramfunc
+  ldr  r3, =_eramfunc
+  adds  r2, r0, r1
+  cmp  r2, r3
+  bcc  CopyRamFunc
+
+/* Copy the CCMRAM data initializers from flash to CCMRAM */
+  movs  r1, #0
+  b  LoopCopyCcmInit
+
+CopyCcmInit:
+  ldr  r3, =_siccmram
+  ldr  r3, [r3, r1]
+  str  r3, [r0, r1]
+  adds  r1, r1, #4
+
+LoopCopyCcmInit:
+  ldr  r0, =_sccmram
+  ldr  r3, =_eccmram
+  adds  r2, r0, r1
+  cmp  r2, r3
+  bcc  CopyCcmInit
+
+/* Zero fill the ccmbss segment (the stack above it is not touched) */
+  ldr  r2, =_sccmbss
+  b  LoopFillZeroCcm
+
+FillZeroCcm:
+  movs  r3, #0
+  str  r3, [r2], #4
+
+LoopFillZeroCcm:
+  ldr  r3, =_eccmbss
+  cmp  r2, r3
+  bcc  FillZeroCcm
+
   ldr  r2, =_sbss
   b  LoopFillZerobss
 /* Zero fill the bss segment. */  